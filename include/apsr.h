@@ -20,6 +20,11 @@ struct _arg_choices {
 	char *alf_filename;
 
 	int mnemonic;	/* Shows the mnemonic for supported operands */
+	int single_pass;	/* encode while parsing, without the instruction list */
+
+	int max_errors;	/* give up once this many errors are found */
+	unsigned long max_errors_count;
+	int fail_fast;	/* give up at the first error, same as a budget of 1 */
 	/* Other non-necessary arguments */
 	int verbose;	/* increase the verbosity of output  */	
 	int help;			/* show help or not  */	
@@ -40,6 +45,7 @@ typedef struct _arg_choices Args;
 #define _ARG_ATTR_ALF 0x25	/* alf file not provided */	
 #define _ARG_ATTR_HD	0x26	/* help has been displaed, suspend all activity */	
 #define _ARG_ATTR_MNE 0x27
+#define _ARG_ATTR_MXE 0x28	/* error budget not provided or not a positive number */
 
 #define _ARG_HELP 	0x10
 #define	_ARG_INPUT 	0x11
@@ -54,6 +60,9 @@ typedef struct _arg_choices Args;
 #define _ARG_FL_INPUT "--input"
 #define _ARG_FL_OUTPUT "--output"
 #define _ARG_FL_ALF "--alf"
+#define _ARG_FL_SINGLE "--single-pass"
+#define _ARG_FL_MAXERR "--max-errors"
+#define _ARG_FL_FAILFAST "--fail-fast"
 
 /* Definations for short argument flag  */
 #define _ARG_FS_HELP "-h"
@@ -62,6 +71,9 @@ typedef struct _arg_choices Args;
 #define _ARG_FS_INPUT "-i"
 #define _ARG_FS_OUTPUT "-o"
 #define _ARG_FS_ALF "-a"
+#define _ARG_FS_SINGLE "-s"
+#define _ARG_FS_MAXERR "-e"
+#define _ARG_FS_FAILFAST "-f"
 
 /* Definations for argument character  */
 #define _ARG_CHR_HELP 'h'
@@ -70,6 +82,9 @@ typedef struct _arg_choices Args;
 #define _ARG_CHR_INPUT 'i'
 #define _ARG_CHR_OUTPUT 'o'
 #define _ARG_CHR_ALF 'a'
+#define _ARG_CHR_SINGLE 's'
+#define _ARG_CHR_MAXERR 'e'
+#define _ARG_CHR_FAILFAST 'f'
 
 int parse_arguments(int argc, char **argv, Args *parsed_args);
 void show_help_text(char *exec_name);
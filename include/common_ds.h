@@ -19,11 +19,25 @@
  *	- `SymTable`: (Symbol Table) Stores the `label` with
  *		its values.
  *
- *	- `IList`: (Instrcution List) Stores the `IItem`.
+ *	- `IList`: (Instrcution List) Stores the instructions
+ *		column by column, one array per field.
  *
- *	- `IItem`: (Instruction Item) Stores the instructions.
+ *	- `IItem`: (Instruction Item) A single instruction, the
+ *		rows of `IList` are read back as `IItem` views.
  *
- *	- `DList`: (Data List) Stores the all `DItem` initialised.
+ *	- `ICursor`: (Instruction Cursor) Walks the rows of an
+ *		`IList` in order.
+ *
+ *	- `SymCursor`, `DCursor`, `EWCursor`, `MnCursor` and
+ *		`RegCursor`: Walk the other containers. Cursors live
+ *		on the stack of the caller and never allocate, so
+ *		walks may nest and run on several threads.
+ *
+ *	- `ISink`: (Instruction Sink) Takes the instructions in
+ *		address order instead of an `IList`.
+ *
+ *	- `DList`: (Data List) Stores the all data words in one
+ *		array, read back as `DItem` views.
  *
  *	- `DItem`: (Data Item) Stores the data with address and
  *		value.
@@ -33,6 +47,20 @@
  *
  *	- `EWItem`: (Error/Warning Item) Stores the Error and
  *		Warning Item.
+ *
+ *	- `Arena`: Bump allocator; everything carved from it is
+ *		released at once by `reset` or `destroy`.
+ *
+ *	- `Ring`: Bounded lock-free queue for exactly one producer
+ *		thread and one consumer thread.
+ *
+ *	- `Interner`: Thread safe map of strings to dense ids.
+ *
+ *	- `CSymTable`: (Concurrent Symbol Table) Symbols defined
+ *		from many threads, the earliest line wins a label.
+ *
+ *	- `Assembly`: The context of one assembly job, the arena
+ *		and the interner its containers are made from.
  * 
  *********************************************************/
 
@@ -49,6 +77,13 @@
 #define _END_MNMAP 0xFFFFFFFF	/* The end pointer of Mnemonic Map   */
 #define _END_RGMAP NULL	/* The end pointer of Register Map   */
 
+/* Packed form of a string literal of at most 8 characters, unused ones are 0  */
+#define DS_PACK(a, b, c, d, e, f, g, h) \
+	(((APacked)(unsigned char)(a)) | ((APacked)(unsigned char)(b) << 8) | \
+	((APacked)(unsigned char)(c) << 16) | ((APacked)(unsigned char)(d) << 24) | \
+	((APacked)(unsigned char)(e) << 32) | ((APacked)(unsigned char)(f) << 40) | \
+	((APacked)(unsigned char)(g) << 48) | ((APacked)(unsigned char)(h) << 56))
+
 /* --------------------------------------------------------
  * Structures for Global Data Structures
  * --------------------------------------------------------*/
@@ -59,8 +94,16 @@ struct ds_instruction_struct {
 	ASize lno;
 	ASize n_op;	/* The numbers of operand */
 	AString opcode;	/* The opcode in mnemonic form  */
-	AString operand_1;	/* The first operand (NULL if not exist)  */
-	AString operand_2;	/* The second operand (NULL if not exist)  */
+	ASize mnemonic;	/* The id of the opcode in the Mnemonic Map (UNSET_DS_MNEMONIC if not known)  */
+	AString operand_1;	/* The first operand, an interned string (NULL if not exist)  */
+	AString operand_2;	/* The second operand, an interned string (NULL if not exist)  */
+	AInt32 operand_1_id;	/* The interned id of the first operand (UNSET_DS_INTERN if not exist)  */
+	AInt32 operand_2_id;	/* The interned id of the second operand (UNSET_DS_INTERN if not exist)  */
+	AInt32 opcode_id;	/* The interned id of the opcode (UNSET_DS_INTERN if not known)  */
+	AType operand_kind;	/* TYPE_DS_OPERAND_* of the first operand (UNSET_DS_OPERAND if not classified)  */
+	AInt32 operand_value;	/* The value of a TYPE_DS_OPERAND_NUMBER or TYPE_DS_OPERAND_CONST operand  */
+	AAddr code;	/* The machine code, once the decoder has recorded it  */
+	AErr status;	/* The decoder status of `code` (UNSET_DS_STATUS if not decoded)  */
 	AString comment;	/* The comment in the instruction (NULL if not exist)  */
 
 	void (*destroy)(struct ds_instruction_struct*);
@@ -68,6 +111,23 @@ struct ds_instruction_struct {
 
 typedef struct ds_instruction_struct IItem;
 
+/* The cursor over the rows of an Instruction List  */
+struct ds_icursor_struct {
+	ASize row;	/* The row loaded by the next call of `next`  */
+	IItem item;	/* The current row, valid until the next call of `next`  */
+};
+
+typedef struct ds_icursor_struct ICursor;
+
+/* The receiver of the instructions, for passes that do not keep an `IList`  */
+struct ds_isink_struct {
+	void* target;	/* Handed back to both functions  */
+	AErr (*emit)(void*, IItem*);	/* The next instruction, in address order  */
+	AErr (*define)(void*, AInt32);	/* The symbol with this id just got its value  */
+};
+
+typedef struct ds_isink_struct ISink;
+
 /* The instruction for data item  */
 struct ds_data_struct {
 	AAddr address;	/*   */
@@ -76,6 +136,14 @@ struct ds_data_struct {
 
 typedef struct ds_data_struct DItem;
 
+/* The cursor over a Data List, in address order  */
+struct ds_dcursor_struct {
+	ASize index;	/* The word loaded by the next call of `next`  */
+	DItem item;	/* The current word, valid until the next call of `next`  */
+};
+
+typedef struct ds_dcursor_struct DCursor;
+
 /* The instructions for Error/Warning Item  */
 struct ds_ew_item {
 	ASize line;	/* Line of the Error/Warning   */
@@ -85,6 +153,14 @@ struct ds_ew_item {
 
 typedef struct ds_ew_item EWItem;
 
+/* The cursor over an Error/Warning List, in insert order  */
+struct ds_ewcursor_struct {
+	void* node;	/* The node loaded by the next call of `next` (NULL at the end)  */
+	EWItem* item;	/* The current item, owned by the list  */
+};
+
+typedef struct ds_ewcursor_struct EWCursor;
+
 /* The Symbol Item Data Structure */
 struct ds_sym_item {
 	AString key;
@@ -94,15 +170,35 @@ struct ds_sym_item {
 
 typedef struct ds_sym_item SymItem;
 
-/* The Symbol Table Data Structure  */
+/* The cursor over a Symbol Table, in the order of `get`  */
+struct ds_symcursor_struct {
+	ASize rank;	/* The rank loaded by the next call of `next`  */
+	SymItem item;	/* The current symbol, valid until the next call of `next`  */
+};
+
+typedef struct ds_symcursor_struct SymCursor;
+
+/* The Symbol Table Data Structure.
+ * Symbols are keyed by their interned id and stored densely by it, so
+ * `insertId` and `findId` are an array access; the string versions intern
+ * (or look up) the key first. The symbols are walked in the same order
+ * as the former string hashmap did: by `djb2` of the key, then by insert.
+ * The first `begin` after an insert ranks the table once; any number of
+ * `SymCursor`s may then walk it at the same time, from any thread.  */
 struct ds_symtable_struct {
-	void* hashmap;	/*   */
+	void* hashmap;	/* The symbols by id  */
 
 	AErr (*insert)(struct ds_symtable_struct*, AString, AAddr);	/*   */
 	AAddr (*find)(struct ds_symtable_struct*, AString);	/*   */
+	AErr (*insertId)(struct ds_symtable_struct*, AInt32, AAddr);	/* Insert by interned id  */
+	AAddr (*findId)(struct ds_symtable_struct*, AInt32);	/* ERR_MAP_FIND_ADDRESS if absent  */
+	AErr (*insertConst)(struct ds_symtable_struct*, AInt32, AAddr);	/* Insert a `SET` constant by interned id  */
+	ABool (*isConst)(struct ds_symtable_struct*, AInt32);	/*   */
 	ABool (*empty)(struct ds_symtable_struct*);		/*   */
 	ASize (*size)(struct ds_symtable_struct*);	/*   */
-	SymItem* (*get)(struct ds_symtable_struct*);	/*   */
+	void (*begin)(struct ds_symtable_struct*, SymCursor*);	/* Rewind the cursor to the first symbol  */
+	ABool (*next)(struct ds_symtable_struct*, SymCursor*);	/* Load the next symbol, FALSE at the end  */
+	SymItem* (*get)(struct ds_symtable_struct*);	/* One walk at a time, see `begin`/`next`  */
 	SymItem* (*end)(void);	/*    */
 	void (*destroy)(struct ds_symtable_struct*);	/*   */
 };
@@ -110,11 +206,26 @@ struct ds_symtable_struct {
 typedef struct ds_symtable_struct SymTable;
 
 
-/* The Instruction List Data Structure */
+/* The Instruction List Data Structure.
+ * The instructions are stored as parallel arrays (address, line, opcode,
+ * operand kind, operand value or id ...), so a row costs a few words and no
+ * allocation. `put` copies an item into a new row, `insert` does the same and
+ * frees the item. `begin`/`next` stream the rows through an `ICursor`, and
+ * `record` stores the decoded machine code with the row for later readers,
+ * and `retype` changes the kind of its first operand once it is known.
+ * `append` copies a range of rows of another list, which lets lists built
+ * with relative addresses be joined with one pass over each column.  */
 struct ds_ilist_struct {
-	void* queue;	/*   */
-
-	AErr (*insert)(struct ds_ilist_struct*, IItem*);	/*   */
+	void* table;	/* The instruction columns  */
+
+	AErr (*insert)(struct ds_ilist_struct*, IItem*);	/* Takes the ownership of the item  */
+	AErr (*put)(struct ds_ilist_struct*, const IItem*);	/* The item stays with the caller  */
+	void (*begin)(struct ds_ilist_struct*, ICursor*);	/* Rewind the cursor to the first row  */
+	ABool (*next)(struct ds_ilist_struct*, ICursor*);	/* Load the next row, FALSE at the end  */
+	AErr (*record)(struct ds_ilist_struct*, ICursor*, AAddr, AErr);	/* Keep the machine code and status of the current row  */
+	AErr (*retype)(struct ds_ilist_struct*, ICursor*, AType, AInt32);	/* Set the kind and value of the first operand of the current row  */
+	AErr (*append)(struct ds_ilist_struct*, struct ds_ilist_struct*, ASize, ASize, AAddr);	/* Copy `count` rows from `first` of another list, adding `base` to the addresses  */
+	void (*clear)(struct ds_ilist_struct*);	/* Drop every row  */
 	IItem* (*find)(struct ds_ilist_struct*, AAddr);	/*   */
 	ABool (*empty)(struct ds_ilist_struct*);	/*   */
 	ASize (*size)(struct ds_ilist_struct*);	/*   */
@@ -126,16 +237,23 @@ struct ds_ilist_struct {
 typedef struct ds_ilist_struct IList;
 
 
-/* The Data List Data Structure  */
+/* The Data List Data Structure.
+ * The data words are consecutive from `base`, so they are kept in one
+ * growable array: the word at `address` is `words[address - base]`, and
+ * the data section is written out from the array as it is.  */
 struct ds_dlist_struct {
-	void* map;	/*   */
-	ASize base;
-	ASize offset;
-	AErr (*insert)(struct ds_dlist_struct*, AInt32, AAddr*);	/*   */
-	DItem* (*find)(struct ds_dlist_struct*, AAddr);	/*   */
+	AInt32* words;	/* The words in address order  */
+	ASize cap;
+	ASize base;		/* The address of the first word  */
+	ASize offset;	/* The number of words  */
+	struct ds_arena_struct* arena;	/* The storage of the words, NULL for the heap  */
+	AErr (*insert)(struct ds_dlist_struct*, AInt32, AAddr*);	/* Append a word, its address is returned  */
+	AInt32* (*find)(struct ds_dlist_struct*, AAddr);	/* The word at the address, NULL if none  */
 	ABool (*empty)(struct ds_dlist_struct*);	/*   */
 	ASize (*size)(struct ds_dlist_struct*);	/*   */
-	DItem* (*get)(struct ds_dlist_struct*); 	/*   */
+	void (*begin)(struct ds_dlist_struct*, DCursor*);	/* Rewind the cursor to the lowest address  */
+	ABool (*next)(struct ds_dlist_struct*, DCursor*);	/* Load the next item, FALSE at the end  */
+	DItem* (*get)(struct ds_dlist_struct*); 	/* One walk at a time, see `begin`/`next`  */
 	DItem* (*end)(void); 	/*   */
 	void (*destroy)(struct ds_dlist_struct*);	/*   */
 };
@@ -146,18 +264,47 @@ typedef struct ds_dlist_struct DList;
 /* The Error/Warning List Data Structure  */
 struct ds_ewlist_struct {
 	void* queue;	/*   */
+	struct ds_arena_struct* arena;	/* The storage of the items, NULL for the heap  */
+	ASize errors;	/* Items with an error code, warnings are not counted  */
+	ASize budget;	/* Errors after which the assembler gives up, SZ_DS_EW_UNLIMITED for none  */
 
-	AErr (*insert)(struct ds_ewlist_struct*, EWItem*);	/*   */
+	AErr (*insert)(struct ds_ewlist_struct*, EWItem*);	/* Takes the ownership of the item  */
+	AErr (*put)(struct ds_ewlist_struct*, const EWItem*);	/* The item stays with the caller  */
 	EWItem* (*find)(struct ds_ewlist_struct*, AAddr);	/*   */
 	ABool (*empty)(struct ds_ewlist_struct*);	/*   */
 	ASize (*size)(struct ds_ewlist_struct*);	/*   */
-	EWItem* (*get)(struct ds_ewlist_struct*); 	/*   */
+	void (*begin)(struct ds_ewlist_struct*, EWCursor*);	/* Rewind the cursor to the first item  */
+	ABool (*next)(struct ds_ewlist_struct*, EWCursor*);	/* Load the next item, FALSE at the end  */
+	EWItem* (*get)(struct ds_ewlist_struct*); 	/* One walk at a time, see `begin`/`next`  */
 	EWItem* (*end)(void); 	/*   */
+	ABool (*exhausted)(struct ds_ewlist_struct*);	/* TRUE once `errors` reached a set budget  */
 	void (*destroy)(struct ds_ewlist_struct*);	/*   */
 };
 
 typedef struct ds_ewlist_struct EWList;
 
+/* The Concurrent Symbol Table Data Structure.
+ * Keyed by interned id like `SymTable`, but `define` may be called from
+ * many threads: the ids are split in stripes with a lock each, and the
+ * symbols live in pages that never move. When a symbol is defined twice
+ * the definition on the earliest line keeps it, whichever thread came
+ * first. Once every thread is done, `publish` reports the other
+ * definitions in line order, and from then on `findId` takes no lock.  */
+struct ds_csymtable_struct {
+	void* hashmap;	/* The stripes and the pages of symbols  */
+
+	AErr (*define)(struct ds_csymtable_struct*, AInt32, AAddr, ASize, ASize);	/* Id, address, line and column  */
+	AErr (*defineConst)(struct ds_csymtable_struct*, AInt32, AAddr, ASize, ASize);	/* A `SET` constant, same arguments  */
+	AAddr (*findId)(struct ds_csymtable_struct*, AInt32);	/* ERR_MAP_FIND_ADDRESS if absent  */
+	AAddr (*find)(struct ds_csymtable_struct*, AString);	/*   */
+	ASize (*size)(struct ds_csymtable_struct*);	/*   */
+	AErr (*publish)(struct ds_csymtable_struct*, EWList*, AErr);	/* Put every lost definition with the code, the list may be NULL  */
+	AErr (*copy)(struct ds_csymtable_struct*, SymTable*);	/* Insert the symbols by line, after `publish`  */
+	void (*destroy)(struct ds_csymtable_struct*);	/*   */
+};
+
+typedef struct ds_csymtable_struct CSymTable;
+
 /* The Register Item Data Structure  */
 struct ds_reg_item_struct {
 	AString key;
@@ -167,15 +314,35 @@ struct ds_reg_item_struct {
 
 typedef struct ds_reg_item_struct RegItem;
 
+/* The cursor over a Register Map, by `djb2` of the key then by insert  */
+struct ds_regcursor_struct {
+	ASize rank;	/* The rank loaded by the next call of `next`  */
+	RegItem item;	/* The current register, valid until the next call of `next`  */
+};
+
+typedef struct ds_regcursor_struct RegCursor;
+
+/* A row of a static register table, see `RegMap.load`  */
+struct ds_reg_row_struct {
+	AString key;
+	AAddr encoding;
+};
+
+typedef struct ds_reg_row_struct RegRow;
+
 /* The Register Map Data Structure  */
 struct ds_reg_map_struct {
 	void* hashmap;
+	struct ds_arena_struct* arena;	/* The storage of the encodings, NULL for the heap  */
 
 	AErr (*insert)(struct ds_reg_map_struct*, AString, AAddr);					/*   */
+	AErr (*load)(struct ds_reg_map_struct*, const RegRow*, ASize);			/* Insert every row of a table  */
 	AAddr (*find)(struct ds_reg_map_struct*, AString);									/*   */
 	ABool (*empty)(struct ds_reg_map_struct*);													/*   */
 	ASize (*size)(struct ds_reg_map_struct*);														/*   */
-	RegItem* (*get)(struct ds_reg_map_struct*);													/*   */
+	void (*begin)(struct ds_reg_map_struct*, RegCursor*);								/* Rewind the cursor to the first register  */
+	ABool (*next)(struct ds_reg_map_struct*, RegCursor*);								/* Load the next register, FALSE at the end  */
+	RegItem* (*get)(struct ds_reg_map_struct*);													/* One walk at a time, see `begin`/`next`  */
 	RegItem* (*end)(void);																							/*   */
 	void (*destroy)(struct ds_reg_map_struct*);													/*   */
 };
@@ -188,27 +355,136 @@ struct ds_mnemo_item_struct {
 	AAddr encoding;		/* The machine code value for the mnemonic   */
 	ASize n_operand;		/* The number of operands that mnemonic expects */
 	AType operand_type;	/* The type of operand that mnemonic expects offset or value */
+	ASize id;		/* The dense id of the mnemonic in its map, in insertion order  */
+	APacked packed;	/* The packed key (UNSET_DS_PACKED if longer than 8 bytes)  */
 
 	void (*destroy)(struct ds_mnemo_item_struct*);
 };
 
 typedef struct ds_mnemo_item_struct MnItem;
 
-/* The Mnemonic Map Data Structure  */
+/* The cursor over a Mnemonic Map, by `djb2` of the key then by insert  */
+struct ds_mncursor_struct {
+	ASize rank;	/* The rank loaded by the next call of `next`  */
+	MnItem* item;	/* The current mnemonic, owned by the map  */
+};
+
+typedef struct ds_mncursor_struct MnCursor;
+
+/* A row of a static mnemonic table, see `MnMap.load`  */
+struct ds_mnemo_row_struct {
+	AString key;
+	AAddr encoding;
+	ASize n_operand;
+	AType operand_type;
+};
+
+typedef struct ds_mnemo_row_struct MnRow;
+
+/* The Mnemonic Map Data Structure.
+ * Besides the string hashmap, the mnemonics that fit 8 bytes are kept in a
+ * perfect hash over their packed keys: `match` is one multiply, one probe and
+ * one integer compare. The table is rebuilt on every insert, which is cheap
+ * for an instruction set and keeps every lookup collision free; `load` puts
+ * a whole table in and builds it once.  */
 struct ds_mnemo_map_struct {
 	void* hashmap;	/*   */
+	void* index;		/* The perfect hash and the items by id  */
+	struct ds_arena_struct* arena;	/* The storage of the items, NULL for the heap  */
 
 	AErr (*insert)(struct ds_mnemo_map_struct*, AString, AAddr, ASize, AType);	/*   */
-	AAddr (*find)(struct ds_mnemo_map_struct*, AString);								/*   */
+	AErr (*load)(struct ds_mnemo_map_struct*, const MnRow*, ASize);					/* Insert every row of a table  */
+	MnItem* (*find)(struct ds_mnemo_map_struct*, AString);							/*   */
+	MnItem* (*match)(struct ds_mnemo_map_struct*, APacked);							/* Find by packed key, NULL if absent  */
+	MnItem* (*at)(struct ds_mnemo_map_struct*, ASize);									/* Find by id, NULL if out of range  */
 	ABool (*empty)(struct ds_mnemo_map_struct*);												/*   */
 	ASize (*size)(struct ds_mnemo_map_struct*);													/*   */
-	MnItem* (*get)(struct ds_mnemo_map_struct*);												/*   */
+	void (*begin)(struct ds_mnemo_map_struct*, MnCursor*);							/* Rewind the cursor to the first mnemonic  */
+	ABool (*next)(struct ds_mnemo_map_struct*, MnCursor*);							/* Load the next mnemonic, FALSE at the end  */
+	MnItem* (*get)(struct ds_mnemo_map_struct*);												/* One walk at a time, see `begin`/`next`  */
 	MnItem* (*end)(void);																								/*   */
 	void (*destroy)(struct ds_mnemo_map_struct*);												/*   */
 };
 
 typedef struct ds_mnemo_map_struct MnMap;
 
+/* The Arena Data Structure  */
+struct ds_arena_struct {
+	void* head;				/* The first memory chunk  */
+	void* tail;				/* The last memory chunk  */
+	void* current;		/* The chunk allocations are carved from  */
+	ASize chunk_size;	/* The default size of a new chunk  */
+
+	void* (*alloc)(struct ds_arena_struct*, ASize);												/* Aligned block, NULL on failure  */
+	AString (*strndup)(struct ds_arena_struct*, const char*, ASize);						/* NUL terminated copy of a span  */
+	void (*reset)(struct ds_arena_struct*);																/* Release every block, keep the chunks  */
+	void (*destroy)(struct ds_arena_struct*);															/*   */
+};
+
+typedef struct ds_arena_struct Arena;
+
+/* The Ring Data Structure.
+ * `tail` is only written by the producer and `head` only by the consumer;
+ * each sits on its own cache line so the two threads do not share one.  */
+struct ds_ring_struct {
+	void** slots;			/* The slots, a power of two of them  */
+	ASize mask;				/* The number of slots minus one  */
+	char _pad_head[SZ_DS_CACHE_LINE];
+	ASize head;				/* The next slot to pop  */
+	char _pad_tail[SZ_DS_CACHE_LINE];
+	ASize tail;				/* The next slot to push  */
+	char _pad_end[SZ_DS_CACHE_LINE];
+
+	ABool (*push)(struct ds_ring_struct*, void*);												/* FALSE when the ring is full  */
+	ABool (*pop)(struct ds_ring_struct*, void**);												/* FALSE when the ring is empty  */
+	ASize (*size)(struct ds_ring_struct*);															/*   */
+	void (*destroy)(struct ds_ring_struct*);														/*   */
+};
+
+typedef struct ds_ring_struct Ring;
+
+/* The Intern Cache Data Structure.
+ * Owned by one thread; remembers the ids of strings of at most 8 bytes so
+ * that repeated identifiers are interned without taking a lock.  */
+struct ds_intern_cache_struct {
+	APacked keys[SZ_DS_INTERN_CACHE];	/* The packed strings (UNSET_DS_PACKED if empty)  */
+	AInt32 ids[SZ_DS_INTERN_CACHE];
+};
+
+typedef struct ds_intern_cache_struct InternCache;
+
+/* The Interner Data Structure.
+ * Maps every distinct string to a dense id, once; the string kept by the
+ * interner lives as long as the interner, so ids and interned strings may
+ * be shared freely. Safe to use from many threads: the table is split in
+ * stripes with a lock each, and the id directory never moves.  */
+struct ds_interner_struct {
+	void* stripes;	/* The locked parts of the table  */
+	void* directory;	/* The strings by id  */
+
+	AInt32 (*intern)(struct ds_interner_struct*, InternCache*, const char*, ASize);	/* The cache may be NULL  */
+	AInt32 (*lookup)(struct ds_interner_struct*, const char*, ASize);						/* UNSET_DS_INTERN if not interned  */
+	AString (*string)(struct ds_interner_struct*, AInt32);											/* NULL for an unknown id  */
+	ASize (*size)(struct ds_interner_struct*);																/*   */
+	void (*destroy)(struct ds_interner_struct*);															/*   */
+};
+
+typedef struct ds_interner_struct Interner;
+
+/* The Assembly Data Structure.
+ * What one job allocates: the containers made with an `Assembly` carve
+ * their items from its arena and keep their strings as ids of its
+ * interner, so `destroy` releases the whole job at once. The containers
+ * are destroyed before it, their own arrays are not in the arena.  */
+struct ds_assembly_struct {
+	Arena* arena;	/* The storage of the items of the containers  */
+	Interner* interner;	/* The strings of the job  */
+
+	void (*destroy)(struct ds_assembly_struct*);	/* Release the arena and the interner  */
+};
+
+typedef struct ds_assembly_struct Assembly;
+
 /* -----------------------------------------------
  * The Functions for Global Data Structures
  * -----------------------------------------------*/
@@ -217,6 +493,8 @@ typedef struct ds_mnemo_map_struct MnMap;
  * the functions for instruction item
  * -----------------------------------------*/
 IItem *ds_new_IItem(AAddr);	/* allocate new Instruction Item  */
+void ds_init_IItem(IItem*, AAddr);	/* Reset an Instruction Item in place  */
+AType ds_operand_kind(AString, AInt32*);	/* Classify an operand, the value is set for numbers  */
 
 /**
  * the functions for Data Item 
@@ -233,6 +511,11 @@ EWItem *ds_new_EWItem(ASize, ASize, AErr);	/*   */
  * -----------------------------------------*/
 MnItem *ds_new_MnItem(AString, AAddr, ASize, AType);
 
+/**
+ * The Function for Packed Keys
+ * ----------------------------------------*/
+APacked ds_pack_key(const char*, ASize);	/* UNSET_DS_PACKED if the length is 0 or above 8  */
+
 /**
  * The Function for Register Item */
 RegItem* ds_new_RegItem(AString, AAddr);
@@ -240,32 +523,58 @@ RegItem* ds_new_RegItem(AString, AAddr);
 /**
  * The Functions for Symbol Table
  * -----------------------------------------*/
-SymTable *ds_new_SymTable();	/*   */
+SymTable *ds_new_SymTable(Assembly*);	/* Keyed by the ids of the interner of the assembly  */
+
+/**
+ * The Functions for Concurrent Symbol Table
+ * -----------------------------------------*/
+CSymTable *ds_new_CSymTable(Assembly*);	/* Keyed by the ids of the interner of the assembly  */
 
 /**
  * The Functions for Instruction List
  * -----------------------------------------*/
-IList *ds_new_IList();	/*   */
+IList *ds_new_IList(Assembly*);	/* The strings of the rows are ids of the interner of the assembly  */
 
 /**
  * The Functions for Data List
  * -----------------------------------------*/
-DList *ds_new_DList();	/*   */
+DList *ds_new_DList(Assembly*);	/* The words are carved from the arena of the assembly, or from the heap if NULL  */
 
 /**
  * The Functions for Error/Warning List
  * -----------------------------------------*/
-EWList *ds_new_EWList();	/*   */
+EWList *ds_new_EWList(Assembly*);	/* The items are carved from the arena of the assembly, or from the heap if NULL  */
 
 /**
  * The Function for MnemonicHashMap
  * ----------------------------------------*/
-MnMap *ds_new_MnMap();	/*   */
+MnMap *ds_new_MnMap(Assembly*);	/* The items are carved from the arena of the assembly, or from the heap if NULL  */
 
 /**
  * The Function for Register Map
  * ---------------------------------------*/
-RegMap *ds_new_RegMap();	/*   */
+RegMap *ds_new_RegMap(Assembly*);	/* The encodings are carved from the arena of the assembly, or from the heap if NULL  */
+
+/**
+ * The Function for Arena
+ * ---------------------------------------*/
+Arena *ds_new_Arena(ASize);	/* Arena growing in chunks of at least the given size  */
+
+/**
+ * The Function for Ring
+ * ---------------------------------------*/
+Ring *ds_new_Ring(ASize);	/* Ring of at least the given number of slots  */
+
+/**
+ * The Functions for Interner
+ * ---------------------------------------*/
+Interner *ds_new_Interner();	/*   */
+void ds_init_InternCache(InternCache*);	/*   */
+
+/**
+ * The Function for Assembly
+ * ---------------------------------------*/
+Assembly *ds_new_Assembly(ASize);	/* The arena grows in chunks of at least the given size  */
 
 
 
@@ -19,6 +19,7 @@ typedef signed long AErr;
 typedef unsigned char AType;
 typedef char* AString;
 typedef uint32_t AInt32;
+typedef uint64_t APacked;	/* Up to 8 bytes of a string, the first byte lowest  */
 
 /* Color Data Type for Red-Black Tree Node*/
 typedef enum {
@@ -31,12 +32,17 @@ typedef enum {
 
 /* Types and Size Definations for Tokenizer */
 #define  SZ_TOK_CARGO_PKT_WIN 	1000	/* Packet Window Size for Loading the File Content into Cargo  */	
-#define  SZ_TOK_LINE_BUFF		1024	/* Buffer Size for Line Reading   */
+#define  SZ_TOK_CARGO_CRATE_SHIFT	10	/* Each Cargo Crate holds 1 << SHIFT packets  */
+#define  SZ_TOK_ARENA_CHUNK	65536	/* Chunk Size of the Token arenas of a Cargo  */
+#define  SZ_TOK_JAR_INLINE	4			/* Tokens stored inline in a Jar, SIMPLE lines rarely have more  */
+#define  SZ_TOK_WINDOW_BUFF		65536	/* Initial Size of the window buffer when streaming   */
 #define  SZ_TOK_IF_MAX_THREAD	50		/* The maximum number of threads for Jarification  */
-#define  SZ_TOK_TOKEN_COMMENT 	256 	/* Size of Comment Token  */
-#define  SZ_TOK_TOKEN_LABEL 		32		/* Size of Label Token  */
-#define  SZ_TOK_TOKEN_MNEMONIC 	32		/* Size of Mnemonic Token  */
-#define  SZ_TOK_TOKEN_OPERAND 	32		/* Size of Operand Token  */
+#define  SZ_TOK_IF_AUTO_THREAD	0			/* Let the tokenizer use one worker per online processor  */
+#define  SZ_TOK_JAR_MIN_BATCH	128		/* The minimum number of packets handed to a Jarification worker  */
+#define  SZ_TOK_MACRO_PARAMS	8			/* The maximum number of parameters of a macro  */
+#define  SZ_TOK_MACRO_TABLE	16		/* Initial number of slots of the macro table, a power of two  */
+#define  SZ_TOK_COND_DEPTH	64		/* The maximum nesting of assembled `.if` blocks  */
+#define  SZ_TOK_COND_OPERAND	32		/* Buffer Size for a number in a condition  */
 
 #define TYPE_TOK_COMMENT 	0xF1	/* Token type Comment  */
 #define TYPE_TOK_LABEL 		0xF2	/* Token type Label  */
@@ -44,12 +50,48 @@ typedef enum {
 #define TYPE_TOK_OPERATOR	0xF4	/* Token type Operator  */
 #define TYPE_TOK_DIRECTIVE	0xF5	/* Token type Directive  */
 #define TYPE_TOK_BLANK		0xF6	/* Token type Black  */
+#define TYPE_TOK_NUMBER		0xF7	/* Token type Number  */
+#define TYPE_TOK_MACRO		0xF8	/* Token type of a malformed macro line  */
+#define TYPE_TOK_COND		0xF9	/* Token type of a malformed conditional line  */
+
+#define MODE_TOK_SRC_STREAM	0x00	/* Source is read line by line into heap buffers  */
+#define MODE_TOK_SRC_MMAP		0x01	/* Source is memory mapped, lines are (offset, length) spans  */
 
 #define UNSET_TOK_LINE		0		/* Unset value of line number of token or packet */
 #define UNSET_TOK_COL		0		/* Unset value of column number of token  */
 
 
+/* Types and Size Definations for Common Data Structures */
+#define  SZ_DS_CACHE_LINE		64		/* Ring indices written by different threads live this far apart  */
+#define  SZ_DS_PACKED_KEY		8			/* The longest string that fits an `APacked`  */
+#define  UNSET_DS_PACKED		0			/* `APacked` of a string too long (or empty) to pack  */
+#define  UNSET_DS_MNEMONIC	((ASize)-1)	/* Mnemonic id of an instruction without a known mnemonic  */
+#define  SZ_DS_INTERN_STRIPES	64		/* Independently locked parts of the string interner  */
+#define  SZ_DS_INTERN_PAGE_SHIFT	12	/* Each page of the interned string directory holds 1 << SHIFT strings  */
+#define  SZ_DS_INTERN_PAGES	4096	/* Pages of the directory, the interner holds at most PAGES << SHIFT strings  */
+#define  SZ_DS_INTERN_CACHE	256		/* Entries of a per-thread cache of short interned strings  */
+#define  SZ_DS_INTERN_CHUNK	16384	/* Arena chunk of the strings of an interner stripe  */
+#define  UNSET_DS_INTERN		((AInt32)0xFFFFFFFF)	/* Id of a string that is not interned  */
+#define  SZ_DS_SYM_STRIPES		64		/* Independently locked parts of a concurrent symbol table  */
+#define  SZ_DS_ILIST_ROWS		1024	/* Initial rows of the instruction columns  */
+#define  SZ_DS_DLIST_WORDS	1024	/* Initial words of the data list  */
+#define  SZ_DS_ASM_ARENA		65536	/* Arena chunk of the containers of one assembly  */
+#define  TYPE_DS_OPERAND_NONE		0x00	/* Instruction without operand  */
+#define  TYPE_DS_OPERAND_SYMBOL	0x01	/* Label operand, looked up by its interned id  */
+#define  TYPE_DS_OPERAND_NUMBER	0x02	/* Numeric operand, its value is stored  */
+#define  TYPE_DS_OPERAND_BAD		0x03	/* Operand that is neither a label nor a number  */
+#define  TYPE_DS_OPERAND_CONST	0x04	/* Symbol of a `SET` defined before use, its value is stored  */
+#define  UNSET_DS_STATUS		0xFF	/* Decoder status of an instruction not decoded yet  */
+#define  UNSET_DS_OPERAND		0xFF	/* Operand of a hand made item, classified on use  */
+#define  SZ_DS_EW_UNLIMITED	0			/* Error budget of an Error/Warning List that never runs out  */
+
 /* Types and Size Definations for Parser */
+#define  SZ_PSR_PIPE_DEPTH		12		/* Cargo windows in flight between the reader, tokenizer and parser, more than a parse batch  */
+#define  SZ_PSR_PARSE_BATCH		8			/* The maximum number of Cargo windows split over the parse pool in one round  */
+#define  SZ_PSR_PIPE_SPIN		64		/* Tries on a Ring before a stage sleeps until a Cargo moves  */
+#define  SZ_PSR_MAX_THREAD		50		/* The maximum number of threads parsing the chunks of a batch  */
+#define  SZ_PSR_AUTO_THREAD		0			/* Let the parser use one worker per online processor  */
+#define  SZ_PSR_CHUNK_MIN_JARS	128		/* The minimum number of Jars in a chunk parsed by one worker  */
 #define  SZ_PSR_BUFF_OPRND		64		/* Buffer Size for Operand  */	
 #define  SZ_PSR_BUFF_LABEL		32		/* Buffer Size for Label  */
 #define  SZ_PSR_BUFF_MNEMO		32		/* Buffer Size for Mnemonic  */
@@ -65,6 +107,8 @@ typedef enum {
 #define TYPE_PSR_JAR_DATA_DECL		0xC6
 #define TYPE_PSR_JAR_ERR			0xC7
 #define TYPE_PSR_JAR_LABL_INSTR		0xC8
+#define TYPE_PSR_JAR_MACRO			0xC9
+#define TYPE_PSR_JAR_COND			0xCA
 
 /*  Define operand types for Mnemonic Map */
 #define TYPE_MNE_OPERAND_NONE		0x00
@@ -75,4 +119,5 @@ typedef enum {
 #define DECODER_MODE_ALF	0x01
 #define DECODER_MODE_BIN	0x02
 #define DECODER_IBUF_SIZ	64
+#define DECODER_DATA_BLOCK	1024	/* Data words converted per write of the data section  */
 #endif
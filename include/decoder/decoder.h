@@ -5,6 +5,7 @@
 #include <common_ds.h>
 #include <err_codes.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 
 /**
@@ -53,7 +54,69 @@ struct _dc_decoder_interface {
 typedef struct _dc_decoder_interface DecoderInterface;
 
 
+/* A label operand used before its definition, patched once the label is known  */
+struct _dc_fixup_struct {
+    ASize row;          /* The instruction word to patch  */
+    ASize lno;          /* Line number of the instruction  */
+    AAddr address;      /* Address of the instruction, for the offset  */
+    AAddr encoding;     /* Opcode of the mnemonic, resolved once by `emit`  */
+    AType operand_type; /* Operand type of the mnemonic, an offset is relative  */
+    ASize next;         /* The fixup before on the same symbol  */
+    ABool pending;      /* Not patched yet  */
+};
+
+typedef struct _dc_fixup_struct DcFixup;
+
+/* An error or warning of the single pass, reported in row order at the end  */
+struct _dc_issue_struct {
+    ASize row;
+    ASize lno;
+    AErr code;          /* Put in the error list, SUCCESS for none  */
+    AErr status;        /* The outcome of the instruction  */
+};
+
+typedef struct _dc_issue_struct DcIssue;
+
+/* The Single Pass Encoder.
+ * Takes the instructions straight from the parser through `sink` and keeps
+ * only the output buffer. A label operand not defined yet is left as a fixup
+ * chained on its symbol id, and the chain is patched in the buffer when the
+ * parser defines the symbol. Whatever is still pending at `finish` is an
+ * undefined label. */
+struct _dc_single_pass {
+    SymTable* stable;
+    EWList* elist;
+    DList* dlist;
+    MnMap* mnmap;
+    ISink sink;             /* Hand `&sink` to the parser  */
+
+    AByte* buffer;          /* The text section being built  */
+    ASize bytepos;
+    ASize cursize;
+
+    DcFixup* fixups;
+    ASize n_fixups;
+    ASize cap_fixups;
+    ASize* heads;           /* The last fixup of each symbol id  */
+    ASize n_heads;
+
+    DcIssue* issues;
+    ASize n_issues;
+    ASize cap_issues;
+
+    AErr (*emit)(struct _dc_single_pass*, IItem*);      /* Encode the next instruction  */
+    AErr (*define)(struct _dc_single_pass*, AInt32);    /* Patch the fixups waiting on a symbol  */
+    AErr (*finish)(struct _dc_single_pass*, FILE*);     /* Report the issues and write the binary  */
+    void (*destroy)(struct _dc_single_pass*);
+};
+
+typedef struct _dc_single_pass SinglePass;
+
+
 /* Functions for Decoder Interface */
 DecoderInterface* dc_new_DecoderInterface(IList*, SymTable*, DList*, MnMap*, RegMap*, EWList*);
 
+/* Functions for Single Pass Encoder */
+SinglePass* dc_new_SinglePass(SymTable*, DList*, MnMap*, EWList*);
+
 #endif
\ No newline at end of file
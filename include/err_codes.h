@@ -17,6 +17,7 @@
 #define THRESHOLD_WARN 0x40
 #define THRESHOLD_INFO 0x80
 #define THRESHOLD_DEBUG 0xC0
+#define THRESHOLD_EW_ERROR 0xE0	/* Codes from here on are errors, the rest warnings, in the Error/Warning List */
 
 /* Error Codes for Memory Management */
 #define ERR_MEM_ALLOC_FAIL 0x01
@@ -82,6 +83,7 @@
 
 /* Warnings for Parser*/
 #define WARN_PSR_INVALID_JAR_TYPE 0x40
+#define WARN_PSR_ERROR_BUDGET 0x62	/* The error budget ran out, the rest of the input is skipped */
 
 /* Assembler Erros */
 #define ERR_ASM_INVALID_MNEMONIC 0x41
@@ -115,6 +117,12 @@
 #define DEC_ERR_INV_OFFST				0xED
 #define DEC_ERR_ERR_CAPTD               0xEE
 
+/* Error Codes for Macros */
+#define PSR_ERR_INV_MACRO				0xEF
+
+/* Error Codes for Conditional Assembly */
+#define PSR_ERR_INV_COND				0xF0
+
 /* Assembler Warnings */
 #define WARN_ASM_DUPLICATE_LABEL 0x60
 #define WARN_ASM_INFINITE_LOOP 0x61
@@ -0,0 +1,34 @@
+/******************************************************
+ *	Instruction Set
+ *	--------------------------------------------------
+ *	This section contains the declaration of the
+ *	instruction set description.
+ *
+ *	The mnemonics and registers are listed once, in the
+ *	data file named by `ISA_DEFINITION` (the build sets
+ *	it from ASM_ISA, `isa/cs2102.def` otherwise). The
+ *	rows are expanded at compile time into static const
+ *	tables, so filling the maps at startup is a single
+ *	pass with no parsing.
+ ******************************************************/
+
+#ifndef _ISA_H
+#define _ISA_H
+
+#include <common_ds.h>
+#include <common_types.h>
+
+#ifndef ISA_DEFINITION
+#define ISA_DEFINITION <isa/cs2102.def>
+#endif
+
+/*----------------------------------------
+ *	Functions for Instruction Set
+ *----------------------------------------*/
+
+AErr isa_load_MnMap(MnMap*);		/* Put every mnemonic of the instruction set into the map  */
+AErr isa_load_RegMap(RegMap*);	/* Put every register of the instruction set into the map  */
+ASize isa_mnemonics(void);			/* Number of mnemonics of the instruction set  */
+ASize isa_registers(void);			/* Number of registers of the instruction set  */
+
+#endif
@@ -2,6 +2,7 @@
 #define _LOGGER_H
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <common_ds.h>
 #include <common_types.h>
 #include <err_codes.h>
@@ -20,8 +20,10 @@
 #include <common_types.h>
 #include <common_ds.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <tokenizer/tokenizer.h>
 #include <err_codes.h>
+#include <pthread.h>
 
 /* -------------------------------------------------------
  * Defining Syntax Rules for Parser
@@ -32,6 +34,79 @@
  * Structures for Parser
  * -------------------------------------------------------*/
 	
+/* Kinds of the events a chunk leaves for the merge  */
+#define TYPE_PSR_EVENT_ERROR		0x00	/* An error of the line  */
+#define TYPE_PSR_EVENT_LABEL		0x01	/* A label defined at an instruction address  */
+#define TYPE_PSR_EVENT_DATA		0x02	/* A `data` declaration  */
+#define TYPE_PSR_EVENT_SET			0x03	/* A `SET` directive  */
+#define TYPE_PSR_EVENT_STATUS		0x04	/* A Jar that failed to parse, only reported unless out of memory  */
+
+#define UNSET_PSR_ROW	((ASize)-1)		/* No instruction row attached to a label  */
+#define UNSET_PSR_LINE	((ASize)-1)		/* No line bound, every row left is typed  */
+
+/* Structure for a Chunk Event.
+ * Whatever depends on the lines before the chunk (the symbol table, the
+ * data addresses and the errors of duplicate labels) is recorded in line
+ * order and replayed when the chunk is merged.  */
+struct psr_chunk_event_struct {
+	AType kind;					/* TYPE_PSR_EVENT_*  */
+	ABool dependent;		/* Dropped if the label just before it is a duplicate  */
+	ASize lno;
+	ASize cno;					/* Column of the label, or of the error  */
+	ASize col;					/* Column of `code` for DATA and SET  */
+	AErr code;					/* The error of the line (SUCCESS if none)  */
+	AInt32 id;					/* The interned label  */
+	AInt32 value;				/* Chunk relative address of a label, the value of DATA and SET  */
+	ASize row;					/* Chunk row of the instruction after a label (UNSET_PSR_ROW if none)  */
+};
+
+typedef struct psr_chunk_event_struct ChunkEvent;
+
+/* Structure for a Chunk: the result of parsing a contiguous range of Jars.
+ * Addresses are relative to the first instruction of the chunk; the merge
+ * adds the number of instructions of everything before it.  */
+struct psr_chunk_struct {
+	IList* ilist;				/* The instructions of the chunk  */
+	Interner* interner;	/* The interner of the assembly, for tokens that come without an id  */
+	ChunkEvent* events;	/* The events in line order  */
+	ASize size;					/* Number of events  */
+	ASize cap;
+	AAddr address_counter;	/* Number of instruction slots of the chunk  */
+	ABool guard;				/* Set while the instruction after a label is checked  */
+	AErr status;				/* Set when an event could not be kept, the merge gives up  */
+	ASize lo;						/* The Jars [lo, hi) of the window  */
+	ASize hi;
+};
+
+typedef struct psr_chunk_struct Chunk;
+
+/* The structure for a parse worker  */
+struct psr_worker {
+	struct psr_worker_pool* pool;	/* The Pool the worker belongs to.  */
+	ASize index;							/* The Index of the worker; worker 0 is the calling thread.  */
+	pthread_t thread;					/* The Thread of the worker (unused for worker 0).  */
+	Chunk chunk;							/* The Chunk parsed by the worker in the current job.  */
+};
+
+/* The structure for the pool of parse workers  */
+struct psr_worker_pool {
+	ASize size;								/* The Number of workers, the calling thread included.  */
+	ASize active;							/* The Number of workers with a chunk in the current job.  */
+	struct psr_worker workers[SZ_PSR_MAX_THREAD];
+	pthread_mutex_t lock;			/* Guards every field below.  */
+	pthread_cond_t start;			/* Signalled when a new job is published.  */
+	pthread_cond_t done;			/* Signalled when the last worker finishes the job.  */
+	ASize generation;					/* The Job counter; workers wait for it to change.  */
+	ASize pending;						/* The Number of pool threads still busy with the job.  */
+	ABool shutdown;						/* Set when the pool is being destroyed.  */
+	struct psr_parser_interface_struct* pi;	/* The Interface running the job.  */
+	Cargo* windows[SZ_PSR_PARSE_BATCH];	/* The Cargo windows of the current job, in source order.  */
+	ASize ends[SZ_PSR_PARSE_BATCH];	/* The Number of Jars in the windows up to and including each one.  */
+	ASize count;							/* The Number of windows in the current job.  */
+};
+
+typedef struct psr_worker_pool ParsePool;
+
 /* Structure for Parser Interface  */
 struct psr_parser_interface_struct {
 	Cargo* cargo;				/* The Cargo data structure for unprocessed tokens  */
@@ -41,8 +116,13 @@ struct psr_parser_interface_struct {
 	DList* dlist;				/* Data List Pointer  */
 	MnMap* mnemonic_map;
 	RegMap* reg_map;
+	Assembly* assembly;	/* The job, its interner holds the identifiers  */
 	FILE* file;					/* Input File Pointer  */
-	AType status;				/* Interface Status  */
+	AErr status;				/* Interface Status, the result of the last `parse`  */
+	AAddr address_counter;	/* Address of the next instruction, carried across Cargo windows  */
+	ParsePool* pool;		/* The workers parsing the chunks of a batch, alive during `parse`  */
+	ASize workers;			/* Parse and Jarification workers, SZ_PSR_AUTO_THREAD for one per online processor  */
+	ISink* sink;				/* Takes the instructions instead of `ilist` when set (single pass)  */
 
 	void (*destroy)(struct psr_parser_interface_struct*);				/* Deallocate the parser interface from the memory  */
 	AErr (*parse)(struct psr_parser_interface_struct*, FILE*);	/* Parser the input file */
@@ -50,6 +130,23 @@ struct psr_parser_interface_struct {
 
 typedef struct psr_parser_interface_struct ParserInterface;
 
+/* Structure for the read -> tokenize -> parse Pipeline.
+ * Cargo windows travel reader -> tokenizer -> parser -> reader through the
+ * three Rings; a NULL Cargo marks the end of the source. A stage that finds
+ * its Ring empty (or full) spins a little, then sleeps until a Cargo moves.  */
+struct psr_pipeline_struct {
+	TokInterface* ti;		/* The Tokenizer shared by the reader and tokenizer stages  */
+	Cargo* cargos[SZ_PSR_PIPE_DEPTH];	/* The Cargo windows in flight  */
+	Ring* to_tok;				/* Loaded windows, reader -> tokenizer  */
+	Ring* to_psr;				/* Jarified windows, tokenizer -> parser  */
+	Ring* empty;				/* Parsed windows, parser -> reader  */
+	AErr status;				/* The First error of a stage; the other stages stop working  */
+	pthread_mutex_t lock;		/* Taken only by a stage that is about to sleep, or that wakes one  */
+	pthread_cond_t moved;		/* A Cargo went through one of the Rings  */
+};
+
+typedef struct psr_pipeline_struct Pipeline;
+
 /* Structure for Jar Tag */
 struct psr_jartag_struct {
 	AErr exec_code;	/* Execution Code   */
@@ -60,7 +157,7 @@ typedef struct psr_jartag_struct JarTag;
 
 
 /* Functions for Parser Interface  */
-ParserInterface* psr_new_ParserInterface(IList*, EWList*, SymTable*, DList*, MnMap*, RegMap*, FILE*);
+ParserInterface* psr_new_ParserInterface(IList*, EWList*, SymTable*, DList*, MnMap*, RegMap*, FILE*, Assembly*);
 
 #endif
 
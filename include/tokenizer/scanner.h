@@ -0,0 +1,46 @@
+/******************************************************
+ *	Line Scanner
+ *	--------------------------------------------------
+ *	This section contains the declaration of the line
+ *	scanner used by the tokenizer.
+ *
+ *	The scanner walks the raw source once and builds a
+ *	compact index of its lines. For each line it finds:
+ *	- `start`: the first byte of the line.
+ *	- `end`: one past the terminating newline (or the
+ *		end of the source for the last line).
+ *	- `comment`: the first `SEPARATOR_COMMENT`.
+ *	- `text`: the first non-whitespace byte.
+ *
+ *	`comment` and `text` are `end` when absent, so a
+ *	line is blank or comment-only exactly when `text`
+ *	equals `comment`.
+ *
+ *	The bulk of the work is done 32 (AVX2) or 16 (SSE2)
+ *	bytes at a time; other targets use a scalar loop.
+ ******************************************************/
+
+#ifndef _SCANNER_H
+#define _SCANNER_H
+
+#include <common_types.h>
+
+/* The structure for the index entry of a line  */
+struct tk_line_span {
+	ASize start;							/* Offset of the first byte of the line  */
+	ASize end;								/* Offset one past the newline  */
+	ASize comment;						/* Offset of the comment separator (`end` if none)  */
+	ASize text;								/* Offset of the first non-blank byte (`end` if none)  */
+};
+
+typedef struct tk_line_span LineSpan;
+
+#define TK_LINE_IGNORABLE(span) ((span)->text == (span)->comment)	/* Blank or comment-only line  */
+
+/*----------------------------------------
+ *	Functions for Line Scanner
+ *----------------------------------------*/
+
+ASize tk_scan_lines(const char*, ASize, ASize, LineSpan*, ASize);	/* Index at most `max` lines of buffer[pos, size)  */
+
+#endif
@@ -14,8 +14,20 @@
  *	
  *	- `directive`: word starting with a `.` character
  *
+ *	- `number`: word starting with a digit or a sign.
+ *
  * 	- `begin words`: The words that are neither labels
  * 		nor comments.
+ *
+ *	Lines between `.macro name p1, p2` and `.endm` are
+ *	kept as Jar templates and every later `name a, b`
+ *	line is replaced by a copy of them with the
+ *	arguments in place of the parameters.
+ *
+ *	`.if`, `.ifdef`, `.else` and `.endif` are decided
+ *	by the reader against the `SET` constants read so
+ *	far; the lines of a branch not taken never become
+ *	Packets.
  ******************************************************/
 
 
@@ -24,8 +36,10 @@
 
 #include <common_ds.h>
 #include <common_types.h>
+#include <tokenizer/scanner.h>
 #include <err_codes.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <pthread.h>
 #include <string.h>
 
@@ -39,17 +53,24 @@ struct tk_token {
 	ASize lno;								/* The line number of token  */
 	ASize cno;								/* The column number of token  */
 	AString token;						/* Token Content  */
-	struct tk_token*  next;		/* Next Item in Linked List of Token  */
+	ASize length;							/* Length of the Token Content  */
+	APacked packed;						/* The Content packed for integer compares (UNSET_DS_PACKED if too long)  */
+	AInt32 id;								/* The interned id of a word, the Content is then the interned string (UNSET_DS_INTERN otherwise)  */
 
 	void (*destroy)(struct tk_token*);
 };
 
 typedef struct tk_token Token;
 
-/* The Structure for Jar/List of Tokens for a line.  */
+/* The Structure for Jar/List of Tokens for a line.
+ * The first SZ_TOK_JAR_INLINE tokens are kept inline, the rest spill over
+ * into `spill`, so `get` is O(1) either way.  */
 struct tk_jar {
 	ASize size;								/* Size of Jar [Number of Tokens in Jar]  */
-	Token* tokens;						/* Tokens Linked List  */
+	Token* tokens[SZ_TOK_JAR_INLINE];	/* The first Tokens of the line  */
+	Token** spill;						/* The Tokens past the inline ones  */
+	ASize spill_cap;					/* The Capacity of the spill array  */
+	Arena* arena;							/* The Arena the spill is carved from (NULL for heap Jars)  */
 	ASize lno;
 
 	void (*destroy)(struct tk_jar*);
@@ -64,8 +85,12 @@ typedef struct tk_jar Jar;
 struct tk_packet {
 	void* content;						/* The Content of the Packet.  */
 	ASize lno;									/* The line number of the packet  */
-	struct tk_packet* prev;		/* The Previous Item in the Packet Queue. */
-	struct tk_packet* next;		/* The Next item in the Packet Queue. */
+	ASize offset;							/* Offset of the line in the mapped source (span packets)  */
+	ASize length;							/* Length of the line, newline included  */
+	ASize text;								/* First non-blank byte, relative to the line  */
+	ASize comment;						/* Comment separator relative to the line (`length` if none)  */
+	ABool owned;							/* The Content is heap owned, not carved from the Cargo arenas  */
+	AType mark;								/* Token type forced on the first token of the line (0 if none)  */
 	
 	void (*destroy)(struct tk_packet*, ABool);
 	AString (*get)(struct tk_packet*);
@@ -74,36 +99,134 @@ struct tk_packet {
 typedef struct tk_packet Packet;
 
 
-/* The structure for Cargo/List of Jar/List of for complete file */
+/* The structure for Cargo/List of Jar/List of for complete file.
+ * Packets are stored in fixed size Crates, so a packet is found in O(1)
+ * and never moves once loaded; only the Crate directory is reallocated.  */
 struct tk_cargo {
 	ASize size;								/* Reflects the number of packet in the Cargo   */
 	ASize crate_num;					/* The Number of Crates in the Cargo  */
 	ASize crate_size;					/* The Crate Size: Number of Packets in each Crate.  */
-	Packet* front;						/* The Front of the Packet Queue.  */
-	Packet* back;							/* The Back of the Packet Queue.   */
-	AType status;							/* The Status of the Cargo.  */
+	ASize crate_cap;					/* The Capacity of the Crate directory.  */
+	Packet** crates;					/* The Crate directory.  */
+	Arena* arenas[SZ_TOK_IF_MAX_THREAD];	/* The Jars of each worker; reset together with the Cargo.  */
+	ASize jarified;						/* The Packets below this index hold Jars.  */
+	ASize mark;								/* The Source offset just past the last loaded window.  */
+	AString text;							/* The Text of the loaded window when streaming; packets index into it.  */
+	ASize text_len;						/* The Bytes used in the text buffer.  */
+	ASize text_cap;						/* The Capacity of the text buffer.  */
+	AType status;							/* The Status of the Interface when the Cargo was loaded (1 at the end of source).  */
 
 	void (*destroy)(struct tk_cargo*, ABool);
+	void (*clear)(struct tk_cargo*, ABool);
 	void* (*get)(struct tk_cargo*, ASize);
 	AErr (*load)(struct tk_cargo*, ASize, void*);
+	AErr (*loadSpan)(struct tk_cargo*, ASize, const LineSpan*);
 };
 
 typedef struct tk_cargo Cargo;
 
+/* The structure for a Jarification worker  */
+struct tk_worker {
+	struct tk_worker_pool* pool;	/* The Pool the worker belongs to.  */
+	ASize index;							/* The Index of the worker; worker 0 is the calling thread.  */
+	pthread_t thread;					/* The Thread of the worker (unused for worker 0).  */
+	InternCache cache;				/* The ids of the words this worker interned recently.  */
+};
+
+/* The structure for the pool of Jarification workers  */
+struct tk_worker_pool {
+	ASize size;								/* The Number of workers, the calling thread included.  */
+	ASize active;							/* The Number of workers with a packet range in the current job.  */
+	struct tk_worker workers[SZ_TOK_IF_MAX_THREAD];
+	pthread_mutex_t lock;			/* Guards every field below.  */
+	pthread_cond_t start;			/* Signalled when a new job is published.  */
+	pthread_cond_t done;			/* Signalled when the last worker finishes the job.  */
+	ASize generation;					/* The Job counter; workers wait for it to change.  */
+	ASize pending;						/* The Number of pool threads still busy with the job.  */
+	ABool shutdown;						/* Set when the pool is being destroyed.  */
+	struct tk_tokenizer_interface* ti;	/* The Interface owning the source of the job.  */
+	struct tk_cargo* cargo;		/* The Cargo of the current job.  */
+	ASize first;							/* The First packet of the current job.  */
+	ASize count;							/* The Number of packets in the current job.  */
+	AErr status;							/* The Status of the current job.  */
+};
+
+typedef struct tk_worker_pool WorkerPool;
+
+/* The structure for a macro: its body is kept as Jars already tokenized,
+ * with the macros it calls expanded in place.  */
+struct tk_macro {
+	AInt32 id;								/* The interned id of the name  */
+	ASize n_params;						/* The Number of parameters  */
+	AInt32 params[SZ_TOK_MACRO_PARAMS];	/* The interned ids of the parameters  */
+	Jar** body;								/* The Jar templates of the body  */
+	ASize size;								/* The Number of Jars in the body  */
+	ASize cap;								/* The Capacity of the body  */
+};
+
+typedef struct tk_macro Macro;
+
+/* The structure for the macros of a source.
+ * Owned by the tokenizer stage; the templates live in `arena` until the
+ * Interface is destroyed, so expanded Jars may point into them.  */
+struct tk_macro_table {
+	Arena* arena;							/* The Macros, their templates and tokens  */
+	Macro** slots;						/* Open addressing on the name id  */
+	ASize cap;								/* The Number of slots, a power of two  */
+	ASize count;							/* The Number of macros defined  */
+	Macro* recording;					/* The Macro whose body is being read (NULL outside a body)  */
+	ABool broken;							/* The Macro being read had a malformed header and is dropped  */
+	Token* opening;						/* The `.macro` token of the body being read  */
+	ASize opening_lno;				/* The line of the `.macro` token  */
+	Jar** out;								/* The Jars of the window being expanded  */
+	ASize out_size;						/* The Number of Jars in `out`  */
+	ASize out_cap;						/* The Capacity of `out`  */
+};
+
+typedef struct tk_macro_table MacroTable;
+
+/* The structure for an `.if` block whose lines are being read  */
+struct tk_cond {
+	ASize lno;								/* The line of the `.if`  */
+	ABool active;							/* The lines of the current branch are assembled  */
+	ABool taken;							/* A branch of the block was assembled  */
+	ABool in_else;						/* The `.else` was read  */
+	LineSpan span;						/* The `.if` line, to report it if the block is left open  */
+	AString text;							/* A copy of the `.if` line when streaming (NULL otherwise)  */
+};
+
+typedef struct tk_cond Cond;
+
 /**
  * The Main Structure of Tokenizer 
  * ------------------------------*/
 
 struct tk_tokenizer_interface {
 	FILE* file;						/* The File Descriptor of the Tokenizer Interface. */
-	Cargo* cargo;					/* The Cargo Pointer. */
+	Cargo* cargo;					/* The Cargo last loaded. */
+	AString source;				/* The memory mapped source (NULL when streaming).  */
+	AString line;					/* The Line buffer reused by `getline` when streaming.  */
+	size_t line_cap;			/* The Capacity of the line buffer.  */
+	AType mode;						/* The Source Ingestion Mode.  */
 	ASize file_size;			/* The Total File Size.  */
 	ASize current_pos;		/* The Current Position of the Tokenizer Interface.  */
+	ASize released_pos;		/* The mapped source below this offset has been handed back to the kernel.  */
+	ASize lno;						/* The Number of Lines consumed so far, carried across Cargo windows.  */
+	LineSpan* index;			/* The Line index of the current window (mmap mode).  */
 	ASize num_workers;		/* The Number of Workers in the Tokenizer Interface  */
+	WorkerPool* pool;			/* The Worker pool used for Jarification.  */
+	MacroTable* macros;		/* The Macros defined so far.  */
+	Assembly* assembly;		/* The job being read, the words of the Jars are strings of its interner.  */
+	SymTable* constants;	/* The `SET` constants read so far, for the conditions.  */
+	Cond conds[SZ_TOK_COND_DEPTH];	/* The open `.if` blocks, innermost last.  */
+	ASize cond_depth;			/* The Number of open `.if` blocks.  */
+	ASize skip_depth;			/* The `.if` blocks opened inside a branch not taken.  */
 	AType status;					/* The Status of the Tokenizer Interface.  */
 	
 	void (*destroy)(struct tk_tokenizer_interface*);
 	AErr (*fillCargo)(struct tk_tokenizer_interface*, Cargo*);
+	AErr (*loadCargo)(struct tk_tokenizer_interface*, Cargo*);		/* Reader stage of `fillCargo`  */
+	AErr (*jarifyCargo)(struct tk_tokenizer_interface*, Cargo*);	/* Tokenizer stage of `fillCargo`  */
 	AInt (*percentageWorkDone)(struct tk_tokenizer_interface*);
 };
 
@@ -116,7 +239,7 @@ int test_tokenizer();
  *	Main Functions for Tokenizer
  *----------------------------------------*/
 
-TokInterface* tk_new_TokInterface(FILE*, ASize);
+TokInterface* tk_new_TokInterface(FILE*, ASize, Assembly*);
 
 /*----------------------------------------
  *	Other Functions for Tokenizer
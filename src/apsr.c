@@ -3,12 +3,15 @@
 #include <stdlib.h>
 #include <apsr.h>
 
-static ArgOpt options[7] = {
+static ArgOpt options[10] = {
     {'o', "output", 1, 1, "filename", "Specify the output file"},
     {'i', "input", 1, 1, "filename", "Specify the input file"},
     {'a', "alf", 0, 1, "filename", "Specify the advanced linking file"},
     {'m', "mnemonic", 0, 0, NULL, "Shows the mnemonic lists of supported opcode"},
     {'v', "verbose", 0, 0, NULL, "Increase verbosity"},
+    {'s', "single-pass", 0, 0, NULL, "Encode while parsing (ignored with alf)"},
+    {'e', "max-errors", 0, 1, "count", "Stop after this many errors"},
+    {'f', "fail-fast", 0, 0, NULL, "Stop at the first error"},
     {'h', "help", 0, 0, NULL, "Show help text"},
     {0, NULL, 0, 0, NULL, NULL}  
 };
@@ -31,6 +34,14 @@ int parse_arguments(int argc, char **argv, Args *parsed_args) {
                         return _ARG_ATTR_HD;
                     } else if (strcmp(flag, _ARG_FL_VERBOSE) == 0) {
                         parsed_args->verbose = 1;
+                    } else if (strcmp(flag, _ARG_FL_SINGLE) == 0) {
+                        parsed_args->single_pass = 1;
+                    } else if (strcmp(flag, _ARG_FL_FAILFAST) == 0) {
+                        parsed_args->fail_fast = 1;
+                    } else if (strcmp(flag, _ARG_FL_MAXERR) == 0) {
+                        last_arg = _ARG_CHR_MAXERR;
+                        stack_on = 1;
+                        parsed_args->max_errors = 1;
                     } else if (strcmp(flag, _ARG_FL_MNEMONIC) == 0) {
                         parsed_args->mnemonic = 1;
                         return _ARG_ATTR_MNE;
@@ -56,6 +67,14 @@ int parse_arguments(int argc, char **argv, Args *parsed_args) {
                         return _ARG_ATTR_HD;
                     } else if (strcmp(flag, _ARG_FS_VERBOSE) == 0) {
                         parsed_args->verbose = 1;
+                    } else if (strcmp(flag, _ARG_FS_SINGLE) == 0) {
+                        parsed_args->single_pass = 1;
+                    } else if (strcmp(flag, _ARG_FS_FAILFAST) == 0) {
+                        parsed_args->fail_fast = 1;
+                    } else if (strcmp(flag, _ARG_FS_MAXERR) == 0) {
+                        last_arg = _ARG_CHR_MAXERR;
+                        stack_on = 1;
+                        parsed_args->max_errors = 1;
                     } else if (strcmp(flag, _ARG_FS_MNEMONIC) == 0) {
                         parsed_args->mnemonic = 1;
                         return _ARG_ATTR_MNE;
@@ -92,6 +111,14 @@ int parse_arguments(int argc, char **argv, Args *parsed_args) {
                     stack_on = 0;
                     parsed_args->alf_filename = value;
                     break;
+                case _ARG_CHR_MAXERR: {
+                    char *end = NULL;
+                    stack_on = 0;
+                    parsed_args->max_errors_count = strtoul(value, &end, 10);
+                    if ((*value == '-') || (end == value) || (*end != '\0'))
+                        parsed_args->max_errors_count = 0;
+                    break;
+                }
                 default:
                     break;
             }
@@ -111,6 +138,10 @@ int parse_arguments(int argc, char **argv, Args *parsed_args) {
         /* alf file chosen but not specified  */
         return _ARG_ATTR_ALF;
     }
+    if ((parsed_args->max_errors == 1) && (parsed_args->max_errors_count == 0)) {
+        /* error budget chosen but not specified  */
+        return _ARG_ATTR_MXE;
+    }
 
     return _ARG_SP;
 }
@@ -126,7 +157,7 @@ void show_help_text(char *exec_name) {
     printf("-------------------------------------------------------------------------\n");
 
     int i;
-    for (i = 0; i<5; i++) {
+    for (i = 0; i<8; i++) {
         char arg_short = options[i].arg_short;
         char *arg_long = options[i].arg_long;
         char *required = (options[i].required == 1)? "Yes": "No";
@@ -31,61 +31,61 @@
  *
  *	- `EWItem`: (Error/Warning Item) Stores the Error and
  *		Warning Item.
+ *
+ *	- `Arena`: Bump allocator released in one go.
+ *
+ *	- `Ring`: Lock-free single producer/single consumer queue.
+ *
+ *	- `Interner`: Striped-lock map of strings to dense ids.
+ *
+ *	- `Assembly`: The arena and the interner of one job.
  * 
  *	Data Structures List (Locally Available):
  * --------------------------------------------------------
  *	- `_ds_queue`: The usual Queue data structure.
  *
- *	- `_ds_smap`: The String hashmap; a map with String hash
- *		function.
- *
- *	- `_ds_map`: The usual ordered map.
+ *	- `_ds_smap`: The String hashmap; Robin Hood open
+ *		addressing with the hash, key and value inline.
  *
  *	Nodes for Data Local Data Structures.
  * --------------------------------------------------------
  *	- `_ds_queue_node`: The nodes for queue data structure.
- *	- `_ds_smap_bucket`: The bucker node for string hashmap.
- *	- `_ds_smap_node`: The node for string hash map.
- *	- `_ds_map_node`: The node for map.
+ *	- `_ds_smap_entry`: The slot of the string hashmap.
  *
  *	Local Functions for Local Data Structures
- *	- `_ds_get_queue_node`: Allocate queue node in heap.
- *	- `_ds_get_queue`: Allocate queue in heap.
+ *	- `_ds_get_queue_node`: Allocate queue node in heap or
+ *		in an arena.
+ *	- `_ds_get_queue`: Allocate queue in heap, its nodes
+ *		may come from an arena.
  *	- `_ds_free_queue_node`: Free the queue node from heap.
  *	- `_ds_free_queue`: Free the queue from heap.
  *	- `_ds_queue_insert`: Insert into queue.
  *	- `_ds_queue_empty`: Checks if queue is empty or not.
  *	- `_ds_queue_size`: Returns the size of queue.
  *	- `djb2`: String to integer hash function.
- *	- `_ds_get_smap_node`: Allocate the smap node in heap.
- *	- `_ds_get_smap_bucket`: Allocate the smap bucket in
- *		heap.
+ *	- `_ds_smap_home`: The home slot of a hash.
  *	- `_ds_get_smap`: Allocate the smap in heap.
- *	- `_ds_free_smap_node`: Deallocate the smap node in heap.
- *	- `_ds_free_smap_bucket`: Deallocate the smap bucket in
- *		heap.
- *	- `_ds_free_smap`: Deallocate the smap in heap.
- *	- `_ds_smap_bucket_insert`: Insert into the bucket with
- *		matched hash.
- *	- `_ds_smap_node_rot_right`: Right rotate the node.
- *	- `_ds_smap_node_rot_left`: Left rotate the node.
- *	- `_ds_smap_fixup`: Fix the violation in the red-black
- *		tree.
- *	- `_ds_smap_insert_handler`: Recursive insertion handler
- *		for insert `_ds_smap_insert_handler`
+ *	- `_ds_free_smap`: Deallocate the smap in heap, the data
+ *		is kept when an arena owns it.
+ *	- `_ds_smap_place`: Put an entry in its Robin Hood slot.
+ *	- `_ds_smap_grow`: Double the table of the smap.
  *	- `_ds_smap_insert`: Function to insert into Hasp map.
- *	- `_ds_smap_find_handler`: Recursive find handler for
- *		`_ds_smap_find`.
  *	- `_ds_smap_find`: Function to find for a key in Hashmap.
  *	- `_ds_smap_empty`: Function to check if the Hashmap is
  *		empty.
  *	- `_ds_smap_size`: Function to get the number of elements
  *		present in the Hash map.
+ *	- `_ds_smap_rank`: Sort the entries in `djb2` order, for
+ *		the cursors of the maps.
+ *	- `_ds_smap_at_rank`: The entry at a rank of the walk.
  *
  *********************************************************/
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
 #include <common_types.h>
 #include "common_ds.h"
 #include <err_codes.h>
@@ -108,70 +108,43 @@ struct _ds_queue_struct {
 	_ds_queue_node *front;
 	_ds_queue_node *back;
 	ASize size;
+	Arena *arena;	/* Where the nodes come from, NULL for the heap  */
 };
 
 typedef struct _ds_queue_struct _ds_queue;
 
 /*  */
-struct _ds_smap_node_struct {
+struct _ds_smap_entry_struct {
+	AAddr hash;		/* `djb2` of the key, computed once per operation  */
+	AAddr dist;		/* Distance from the home slot plus one, 0 for an empty slot  */
+	ASize seq;		/* Insert order, ties of `hash` are walked by it  */
 	AString key;
 	void *data;
-	struct _ds_smap_node_struct *next;
-	struct _ds_smap_node_struct *prev;
-};
-
-typedef struct _ds_smap_node_struct _ds_smap_node;
-
-/*  */
-struct _ds_smap_bucket_struct {
-	AAddr key;
-	_ds_smap_node *head;
-	ASize size;
-
-	struct _ds_smap_bucket_struct *parent;
-	struct _ds_smap_bucket_struct *left;
-	struct _ds_smap_bucket_struct *right;
-	Color color;
 };
 
-typedef struct _ds_smap_bucket_struct _ds_smap_bucket;
+typedef struct _ds_smap_entry_struct _ds_smap_entry;
 
 /*  */
 struct _ds_smap_struct {
-	_ds_smap_bucket *root;
+	_ds_smap_entry *slots;	/* Robin Hood open addressing, a power of two of slots  */
+	ASize cap;
 	ASize size;
+	AAddr shift;		/* 32 minus the bits of `cap`, for the home slot  */
+	struct _ds_smap_entry_struct **ranks;	/* The entries in walk order  */
+	ASize ranked;		/* The entries covered by `ranks`  */
+	pthread_mutex_t lock;	/* Guards the ranking  */
 };
 
 typedef struct _ds_smap_struct _ds_smap;
 
-
-/*  */
-struct _ds_map_node_struct {
-	AAddr key;
-	void *data;
-
-	struct _ds_map_node_struct *parent;
-	struct _ds_map_node_struct *left;
-	struct _ds_map_node_struct *right;
-	Color color;
-};
-
-typedef struct _ds_map_node_struct _ds_map_node;
-
-/*  */
-struct _ds_map_struct {
-	_ds_map_node *root;
-	ASize size;
-};
-
-typedef struct _ds_map_struct _ds_map;
-
 /**
  * The Functions for Queue Data Structure  
  * -----------------------------------------*/
 
-_ds_queue_node* _ds_get_queue_node(void* data) {	/* Function to allocate queue node */
-	_ds_queue_node *node = (_ds_queue_node*)malloc(sizeof(_ds_queue_node));
+_ds_queue_node* _ds_get_queue_node(Arena* arena, void* data) {	/* Function to allocate queue node */
+	_ds_queue_node *node = (arena != NULL)?
+		(_ds_queue_node*)arena->alloc(arena, sizeof(_ds_queue_node)):
+		(_ds_queue_node*)malloc(sizeof(_ds_queue_node));
 
 	if (node == NULL)
 		return NULL;
@@ -183,7 +156,7 @@ _ds_queue_node* _ds_get_queue_node(void* data) {	/* Function to allocate queue n
 	return node;
 }
 
-_ds_queue* _ds_get_queue() {	/* Function to allocate queue   */
+_ds_queue* _ds_get_queue(Arena* arena) {	/* Function to allocate queue, the nodes come from the arena if any   */
 	_ds_queue *queue = (_ds_queue*)malloc(sizeof(_ds_queue));
 
 	if (queue == NULL)
@@ -192,6 +165,7 @@ _ds_queue* _ds_get_queue() {	/* Function to allocate queue   */
 	queue->front = NULL;
 	queue->back  = NULL;
 	queue->size  = 0;
+	queue->arena = arena;
 
 	return queue;
 }
@@ -207,11 +181,11 @@ static void _ds_free_queue_node(_ds_queue_node* node, ABool wipedata) {	/* Funct
 	node = NULL;
 }
 
-static void _ds_free_queue(_ds_queue* queue, ABool wipedata) {
+static void _ds_free_queue(_ds_queue* queue, ABool wipedata) {	/* Nodes of an arena go with the arena  */
 	if (queue == NULL)
 		return;
 
-	if (queue->front != NULL) {
+	if ((queue->front != NULL) && (queue->arena == NULL)) {
 		_ds_queue_node *prev = NULL;
 		_ds_queue_node *cur  = queue->front;
 		
@@ -230,7 +204,7 @@ AErr _ds_queue_insert(_ds_queue* queue, void* data) {	/* Function to insert into
 	if (queue == NULL)
 		return ERR_DS_INVALID_STRUCT;
 
-	_ds_queue_node* node = _ds_get_queue_node(data);
+	_ds_queue_node* node = _ds_get_queue_node(queue->arena, data);
 	if (node == NULL)
 		return ERR_DS_STRUCT_GEN_FAIL;
 
@@ -293,34 +267,10 @@ AAddr djb2(const AString str) {
   return _hash;
 }
 
-_ds_smap_node* _ds_get_smap_node(AString key, void* data) {	/* Function to allocate SMap node into heap */
-	_ds_smap_node* node = (_ds_smap_node*)malloc(sizeof(_ds_smap_node));
-
-	if (node == NULL)
-		return NULL;
-	
-	node->key = key;
-	node->data = data;
-	node->next = NULL;	
-	node->prev = NULL;
-	return node;
-}
-
-_ds_smap_bucket* _ds_get_smap_bucket(AAddr key) {	/* Function to allocate SMap Bucket structure in heap   */
-	_ds_smap_bucket* bucket = (_ds_smap_bucket*)malloc(sizeof(_ds_smap_bucket));
+#define _DS_SMAP_MIN_CAP 16		/* The first table, grown by doubling past 3/4 full  */
 
-	if (bucket == NULL)
-		return NULL;
-
-	bucket->key = key;
-	bucket->head = NULL;
-	bucket->size = 0;
-	bucket->parent = NULL;
-	bucket->left = NULL;
-	bucket->right = NULL;
-	bucket->color = RED;
-
-	return bucket;
+static ASize _ds_smap_home(AAddr hash, AAddr shift) {	/* Fibonacci hashing spreads the weak low bits of `djb2`  */
+	return (ASize)((AAddr)(hash*0x9E3779B9u) >> shift);
 }
 
 _ds_smap* _ds_get_smap() {	/* Function to allocate SMap structure in heap  */
@@ -329,280 +279,128 @@ _ds_smap* _ds_get_smap() {	/* Function to allocate SMap structure in heap  */
 	if (smap == NULL)
 		return NULL;
 
-	smap->root = NULL;
+	smap->slots = NULL;
+	smap->cap = 0;
 	smap->size = 0;
+	smap->shift = 32;
+	smap->ranks = NULL;
+	smap->ranked = 0;
+	pthread_mutex_init(&smap->lock, NULL);
 
 	return smap;
 }
 
-static void _ds_free_smap_node(_ds_smap_node* node) {		/* Function to deallocate the smap node   */
-	if (node == NULL) 
-		return;
-
-	if (node->data != NULL)
-		free(node->data);
-
-	free(node);
-	node = NULL;
-}
-
-static void _ds_free_smap_bucket(_ds_smap_bucket* bucket) {	/* Function to deallocate the smap bucket   */
-	if (bucket == NULL)
-		return;
-
-	if (bucket->head != NULL) {
-		_ds_smap_node* prev = NULL;
-		_ds_smap_node* cur = bucket->head;
-
-		int i;
-		for (i = 0; i<bucket->size; i++) {
-			prev = cur;
-			cur = cur->next;
-			_ds_free_smap_node(prev);
-		}
-	}
-
-	free(bucket);
-	bucket = NULL;
-}
-
-static void _ds_free_smap_handler(_ds_smap_bucket* bucket) {	/* Function to deallocate the smap recursively  */
-	if (bucket == NULL)
-		return;
-
-	_ds_free_smap_handler(bucket->left);
-	_ds_free_smap_handler(bucket->right);
-	_ds_free_smap_bucket(bucket);
-	bucket = NULL;
-}
-
-static void _ds_free_smap(_ds_smap* smap) {		/* Function to deallocate the smap   */
+static void _ds_free_smap(_ds_smap* smap, ABool wipedata) {		/* Function to deallocate the smap, and the data of its entries if not in an arena  */
 	if (smap == NULL)
 		return;
 
-	_ds_free_smap_handler(smap->root);
-}
-
-static void _ds_smap_bucket_insert(_ds_smap_bucket* bucket, _ds_smap_node* node) {
-	if (bucket->head == NULL)
-		bucket->head = node;
-
-	node->next = bucket->head;
-	bucket->head->prev = node;
-	bucket->head = node;
-	bucket->size += 1;
-}
-
-static void _ds_smap_node_rot_right(_ds_smap* smap, _ds_smap_bucket* y) {
-	_ds_smap_bucket* x = y->left;
-	y->left = x->right;
-
-	if (x->right != NULL)
-		x->right->parent = y;
-
-	x->parent = y->parent;
-
-	if (y->parent == NULL)
-		smap->root = x;
-	else if (y == y->parent->right)
-		y->parent->right = x;
-	else
-		y->parent->left = x;
+	ASize i;
+	for (i = 0; (wipedata == TRUE) && (i<smap->cap); i++) {
+		if ((smap->slots[i].dist != 0) && (smap->slots[i].data != NULL))
+			free(smap->slots[i].data);
+	}
 
-	x->right = y;
-	y->parent = x;
+	free(smap->slots);
+	free(smap->ranks);
+	pthread_mutex_destroy(&smap->lock);
+	free(smap);
+	smap = NULL;
 }
 
-static void _ds_smap_node_rot_left(_ds_smap* smap, _ds_smap_bucket *x) {
-
-	_ds_smap_bucket* y = x->right;
-	x->right = y->left;
-
-	if (y->left != NULL)
-		y->left->parent = x;
+static void _ds_smap_place(_ds_smap* smap, _ds_smap_entry entry) {	/* Robin Hood insert, the table has room  */
+	ASize mask = smap->cap - 1;
+	ASize i = _ds_smap_home(entry.hash, smap->shift);
 
-	y->parent = x->parent;
+	entry.dist = 1;
+	while (1) {
+		_ds_smap_entry* slot = &smap->slots[i];
+		if (slot->dist == 0) {
+			*slot = entry;
+			return;
+		}
 
-	if (x->parent == NULL)
-		smap->root  = y;
-	else if (x == x->parent->left)
-		x->parent->left = y;
-	else
-		x->parent->right = y;
+		/* Take the slot of a richer entry; entries of one home stay in insert order  */
+		if ((slot->dist < entry.dist) || ((slot->dist == entry.dist) && (slot->seq > entry.seq))) {
+			_ds_smap_entry rich = *slot;
+			*slot = entry;
+			entry = rich;
+		}
 
-	y->left = x;
-	x->parent = y;
+		i = (i + 1) & mask;
+		entry.dist += 1;
+	}
 }
 
-static void _ds_smap_fixup(_ds_smap* smap, _ds_smap_bucket* bucket) {
-
-	if (bucket == NULL)
-		return;
-
-	_ds_smap_bucket* z = bucket;
+static AErr _ds_smap_grow(_ds_smap* smap) {	/* Double the table and place the entries again  */
+	ASize cap = (smap->cap == 0)? _DS_SMAP_MIN_CAP: 2*smap->cap;
+	_ds_smap_entry* slots = (_ds_smap_entry*)calloc(cap, sizeof(_ds_smap_entry));
+	if (slots == NULL)
+		return ERR_MEM_ALLOC_FAIL;
 
-	while (z != smap->root) {
+	_ds_smap_entry* old = smap->slots;
+	ASize old_cap = smap->cap;
+	smap->slots = slots;
+	smap->cap = cap;
+	smap->shift -= (old_cap == 0)? 4: 1;
 
-		if (z->parent->color != RED)
-			break;
-		
-		if (z->parent == z->parent->parent->left) {	/* Parent is left child   */
-			_ds_smap_bucket* y = z->parent->parent->right; 		/* The uncle   */
-
-			if ((y != NULL) && (y->color == RED)) {	/* Case I: Uncle is RED */
-				z->parent->color = BLACK;
-				y->color = BLACK;
-				z->parent->parent->color = RED;
-				z = z->parent->parent;
-			} else {
-				if (z == z->parent->right) {
-						/* Case II: z is right child  */
-						z = z->parent;
-						_ds_smap_node_rot_left(smap, z);
-				}
-				/* Case III: z is left child  */
-				z->parent->color = BLACK;
-				z->parent->parent->color = RED;
-				_ds_smap_node_rot_right(smap, z->parent->parent);
-			}
-		} else {
-		/* Mirror Case  */
-			_ds_smap_bucket* y = z->parent->parent->left;
-
-			if ((y != NULL) && (y->color == RED)) {
-				z->parent->color = BLACK;
-				y->color = BLACK;
-				z->parent->parent->color = RED;
-				z = z->parent->parent;
-			} else {
-				if (z == z->parent->left) {
-					z = z->parent;
-					_ds_smap_node_rot_right(smap, z);
-				}
-				z->parent->color = BLACK;
-				z->parent->parent->color = RED;
-				_ds_smap_node_rot_left(smap, z->parent->parent);
-			}
-		}
+	ASize i;
+	for (i = 0; i<old_cap; i++) {
+		if (old[i].dist != 0)
+			_ds_smap_place(smap, old[i]);
 	}
-	smap->root->color = BLACK;
-}
 
-static void _ds_smap_print(_ds_smap_bucket* bucket) {
-	if (bucket->left != NULL)
-		_ds_smap_print(bucket->left);
-	printf("DEBUG: key->%d, string->%s\n", bucket->key, bucket->head->key);
-	if (bucket->right != NULL)
-		_ds_smap_print(bucket->right);
+	free(old);
+	return SUCCESS;
 }
 
-static _ds_smap_bucket* _ds_smap_insert_handler(const _ds_smap* map, _ds_smap_bucket* bucket, AAddr key, _ds_smap_node* node) {
-	if (bucket == NULL)	/* Hack Fix, neex to revisit the issue of NULL bucket when the bucket reaches root after fixup.   */
-		bucket = map->root;
-
-	if (bucket->key == key) {
-
-		 _ds_smap_bucket_insert(bucket, node);		/* Insert the node into the bucket */
-		 return bucket;
-
-	} else if (bucket->key < key) {	/* Key bucket lies in right */
-		if (bucket->right == NULL) {		/* If bucket non-existent, create new bucket */
-			_ds_smap_bucket *rbucket = _ds_get_smap_bucket(key);
-
-			if (rbucket == NULL)
-				return NULL;
-			
-			rbucket->parent = bucket;
-			bucket->right = rbucket;
-			_ds_smap_fixup(map, rbucket);
-		}
-
-		return _ds_smap_insert_handler(map, bucket->right, key, node);		/* Recursively insert on right subtree */
-	} else {
-		if (bucket->left == NULL) {
-			_ds_smap_bucket *lbucket = _ds_get_smap_bucket(key);
+static _ds_smap_entry* _ds_smap_find(_ds_smap* smap, AString key) {	/* Function to find the entry of a key in SMap   */
+	if ((smap == NULL) || (smap->size == 0))
+		return NULL;
 
-			if (lbucket == NULL)
-				return NULL;
+	AAddr hash = djb2(key);
+	ASize mask = smap->cap - 1;
+	ASize i = _ds_smap_home(hash, smap->shift);
+	AAddr dist = 1;
 
-			lbucket->parent = bucket;
-			bucket->left = lbucket;
-			_ds_smap_fixup(map, lbucket);
-		}
+	while (1) {
+		_ds_smap_entry* slot = &smap->slots[i];
+		if (slot->dist < dist)	/* Empty, or the key would have displaced it  */
+			return NULL;
+		if ((slot->hash == hash) && (strcmp(key, slot->key) == 0))
+			return slot;
 
-		return _ds_smap_insert_handler(map, bucket->left, key, node);	/* Recursively insert on left subtree */
+		i = (i + 1) & mask;
+		dist += 1;
 	}
-
-	return NULL;
 }
 
-static AErr _ds_smap_insert(_ds_smap* smap, const AString key, void* data) {	/* Funcion to insert into smap  */
-	if (smap == NULL) 
+static AErr _ds_smap_insert(_ds_smap* smap, const AString key, void* data, void** replaced) {	/* Funcion to insert into smap, a repeated key takes the new value and hands the old one back in `replaced`  */
+	if (smap == NULL)
 		return ERR_DS_INVALID_STRUCT;
 
-	AAddr hash = djb2(key);
-	
-	_ds_smap_node *node = _ds_get_smap_node(key, data);
-	if (node == NULL)
-		return ERR_DS_STRUCT_GEN_FAIL;
-
-	if (smap->size == 0) {
-	/* if hashmap is empty */
-		_ds_smap_bucket *bucket = _ds_get_smap_bucket(hash);
-		if (bucket == NULL)
-			return ERR_DS_STRUCT_GEN_FAIL;
-		
-		bucket->color = BLACK;
-		smap->root = bucket;
-		_ds_smap_bucket_insert(smap->root, node);
-		smap->size += 1;
-		
+	*replaced = NULL;
+	_ds_smap_entry* slot = _ds_smap_find(smap, key);
+	if (slot != NULL) {		/* The last insert wins, as in the list the hashmap used to prepend to  */
+		*replaced = slot->data;
+		slot->data = data;
 		return SUCCESS;
 	}
 
-	_ds_smap_bucket* bucket = _ds_smap_insert_handler(smap, smap->root, hash, node);
-	if (bucket == NULL)
+	if ((4*(smap->size + 1) > 3*smap->cap) && (_ds_smap_grow(smap) != SUCCESS))
 		return ERR_DS_INSERT_FAIL;
 
+	_ds_smap_entry entry;
+	entry.hash = djb2(key);
+	entry.dist = 0;
+	entry.seq = smap->size;
+	entry.key = key;
+	entry.data = data;
+
+	_ds_smap_place(smap, entry);
 	smap->size += 1;
 	return SUCCESS;
 }
 
-static _ds_smap_node* _ds_smap_find_handler(_ds_smap_bucket* bucket, AString key) {
-	AAddr hash = djb2(key);
-	if (hash == bucket->key) {
-	/* Correct bucket found */
-		_ds_smap_node *cur = bucket->head;
-
-		while (cur != NULL) {
-			if (strcmp(key, cur->key) == 0)
-				return cur;
-			cur = cur->next;
-		}
-		return NULL;
-
-	} else if (hash < bucket->key) {
-	/* Value potentially lies in left subtree */
-		if (bucket->left == NULL)
-			return NULL;
-		return _ds_smap_find_handler(bucket->left, key);
-
-	} else {
-	/* Value potentially lies in right subtree */
-		if (bucket->right == NULL)
-			return NULL;
-		return _ds_smap_find_handler(bucket->right, key);
-	}
-}
-
-static _ds_smap_node* _ds_smap_find(_ds_smap* smap, AString key) {	/* Function to find the location of value in SMap   */	
-	if (smap == NULL)
-		return NULL;
-	if (smap->root == NULL)
-		return NULL;
-
-	return _ds_smap_find_handler(smap->root, key);
-}
 ABool _ds_smap_empty(_ds_smap* smap) {	/* Function to check if the SMap is empty   */
 	if (smap == NULL)
 		return TRUE;
@@ -616,345 +414,343 @@ ASize _ds_smap_size(_ds_smap* smap) {
 	return smap->size;
 }
 
-static _ds_smap_bucket* _ds_smap_get_bucket_iterator(_ds_smap* smap) {
-	if (smap == NULL)
-		return NULL;
-
-	if (smap->root == NULL)
-		return NULL;
-
-	_ds_smap_bucket* cur = smap->root;
+static int _ds_smap_entry_cmp(const void* a, const void* b) {
+	const _ds_smap_entry* x = *(const _ds_smap_entry* const*)a;
+	const _ds_smap_entry* y = *(const _ds_smap_entry* const*)b;
+	if (x->hash != y->hash)
+		return (x->hash < y->hash)? -1: 1;
+	return (x->seq < y->seq)? -1: (x->seq > y->seq);
+}
 
-	if (cur->size == 0)
-		return NULL;
+static void _ds_smap_rank(_ds_smap* smap) {	/* Sort the entries by `djb2`, then by insert, once per change of the smap  */
+	if ((smap == NULL) || (__atomic_load_n(&smap->ranked, __ATOMIC_ACQUIRE) == smap->size))
+		return;
 
-	while (cur->left != NULL)
-		cur = cur->left;
+	pthread_mutex_lock(&smap->lock);
+	if (smap->ranked != smap->size) {
+		_ds_smap_entry** ranks = (_ds_smap_entry**)realloc(smap->ranks, smap->size*sizeof(_ds_smap_entry*));
+		if (ranks != NULL) {
+			ASize count = 0;
+			ASize i;
+			for (i = 0; i<smap->cap; i++) {
+				if (smap->slots[i].dist != 0)
+					ranks[count++] = &smap->slots[i];
+			}
+			qsort(ranks, count, sizeof(_ds_smap_entry*), _ds_smap_entry_cmp);
 
-	return cur;
+			smap->ranks = ranks;
+			__atomic_store_n(&smap->ranked, count, __ATOMIC_RELEASE);
+		}
+	}
+	pthread_mutex_unlock(&smap->lock);
 }
 
-static void _ds_smap_next_iterator(_ds_smap_bucket* bucket, _ds_queue* queue) {
-	if ((bucket == NULL) || (queue == NULL))
-		return;
+static _ds_smap_entry* _ds_smap_at_rank(_ds_smap* smap, ASize rank) {	/* NULL past the ranked entries  */
+	if ((smap == NULL) || (rank >= __atomic_load_n(&smap->ranked, __ATOMIC_ACQUIRE)))
+		return NULL;
 
-	if (bucket->left)
-		_ds_smap_next_iterator(bucket->left, queue);
+	return smap->ranks[rank];
+}
 
-	_ds_queue_insert(queue, (void*)bucket);
+/* --------------------------------------------------------
+ * Function for Global Data Structures
+ * --------------------------------------------------------*/
 
-	if (bucket->right)
-		_ds_smap_next_iterator(bucket->right, queue);
-}
 
 /**
- * The Functions for HashMap Data Structure
+ * The Functions for Instruction Item
  * -----------------------------------------*/
+void ds_destroy_IItem(IItem* item) {	/* Free the Instruction structure from memory   */
+	if (item == NULL)
+		return;
 
-_ds_map_node* _ds_get_map_node(AAddr key, void* data) {	/* Function to allocate the map node in memory   */
-	_ds_map_node* node = (_ds_map_node*)malloc(sizeof(_ds_map_node));
-	if (node == NULL)
-		return NULL;
+	/* The operands are interned strings, they live with the interner  */
+	free(item);
+	item = NULL;
+}
 
-	node->key = key;
-	node->data = data;
-	node->left = NULL;
-	node->right = NULL;
+static void _ds_release_IItem(IItem* item) {	/* `destroy` of a row view, the row stays in its list  */
+	return;
+}
 
-	return node;
+void ds_init_IItem(IItem* item, AAddr address) {	/* Reset the Instruction structure to an instruction without operands   */
+	if (item == NULL)
+		return;
+
+	item->address = address;
+	item->lno = 0;
+	item->n_op = 0;	/* Set default num operators to 0  */
+	item->opcode = NULL;
+	item->mnemonic = UNSET_DS_MNEMONIC;
+	item->operand_1 = NULL;
+	item->operand_2 = NULL;
+	item->operand_1_id = UNSET_DS_INTERN;
+	item->operand_2_id = UNSET_DS_INTERN;
+	item->opcode_id = UNSET_DS_INTERN;
+	item->operand_kind = UNSET_DS_OPERAND;
+	item->operand_value = 0;
+	item->code = 0;
+	item->status = UNSET_DS_STATUS;
+	item->comment = NULL;
+	item->destroy = ds_destroy_IItem;
 }
 
-_ds_map* _ds_get_map() { 	/* Function to allocate the map into memory  */
-	_ds_map* map = (_ds_map*)malloc(sizeof(_ds_map));
-	if (map == NULL)
+IItem *ds_new_IItem(AAddr address) {	/* Allocate new Instruction structure in memory   */
+	IItem* item = (IItem*)malloc(sizeof(IItem));
+	if (item == NULL)
 		return NULL;
 
-	map->root = NULL;
-	map->size = 0;
-
-	return map;
+	ds_init_IItem(item, address);
+	return item;
 }
 
-static void _ds_free_map_node(_ds_map_node* node) {	/* Function to deallocate the map node memory   */
-	if (node == NULL)
-		return;
+AType ds_operand_kind(AString operand, AInt32* value) {	/* Labels start with a letter, anything else must be a number   */
+	if (operand == NULL)
+		return TYPE_DS_OPERAND_NONE;
 
-	if (node->data != NULL)
-		free(node->data);
+	if (isalpha((unsigned char)*operand))
+		return TYPE_DS_OPERAND_SYMBOL;
 
-	free(node);
-	node = NULL;
+	AInt32 number = strtol(operand, NULL, 0);
+	if ((number == 0) && (strcmp(operand, "0") != 0))
+		return TYPE_DS_OPERAND_BAD;
+
+	if (value != NULL)
+		*value = number;
+	return TYPE_DS_OPERAND_NUMBER;
 }
 
-static void _ds_free_map_handler(_ds_map_node* node) {	/* Function the deallocate the whole map recursively */
-	if (node == NULL)
-		return;
+/**
+ * The Functions for Instruction List
+ * -----------------------------------------*/
 
-	_ds_free_map_handler(node->left);
-	_ds_free_map_handler(node->right);
-	_ds_free_map_node(node);
-}
+struct _ds_itable_struct {	/* One array per field of an instruction, indexed by row  */
+	AAddr* address;
+	AInt32* lno;
+	AInt32* mnemonic;		/* Mnemonic Map id, UNSET_DS_INTERN if not known  */
+	AInt32* opcode;			/* Interned ids  */
+	AInt32* operand_1;
+	AInt32* operand_2;
+	AInt32* value;			/* Value of a numeric first operand  */
+	AByte* n_op;
+	AType* kind;				/* TYPE_DS_OPERAND_* of the first operand  */
+	AAddr* code;				/* Machine code recorded by the decoder  */
+	AByte* status;			/* Its decoder status, UNSET_DS_STATUS until recorded  */
+	ASize size;
+	ASize cap;
+	Interner* interner;	/* The strings of the ids  */
+};
 
-static void _ds_free_map(_ds_map* map) {	/* Function to deallocate the map memory */
-	if (map == NULL)
-		return;
+typedef struct _ds_itable_struct _ds_itable;
 
-	_ds_free_map_handler(map->root);
-}
+static AErr _ds_itable_grow(_ds_itable* table) {	/* Double the capacity of every column  */
+	ASize cap = (table->cap == 0)? SZ_DS_ILIST_ROWS: 2*table->cap;
+	void* column;
 
-static void _ds_map_node_rot_right(_ds_map* map, _ds_map_node* y) {
-	_ds_map_node* x = y->left;
-	y->left = x->right;
+	if ((column = realloc(table->address, cap*sizeof(AAddr))) == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	table->address = (AAddr*)column;
+	if ((column = realloc(table->lno, cap*sizeof(AInt32))) == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	table->lno = (AInt32*)column;
+	if ((column = realloc(table->mnemonic, cap*sizeof(AInt32))) == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	table->mnemonic = (AInt32*)column;
+	if ((column = realloc(table->opcode, cap*sizeof(AInt32))) == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	table->opcode = (AInt32*)column;
+	if ((column = realloc(table->operand_1, cap*sizeof(AInt32))) == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	table->operand_1 = (AInt32*)column;
+	if ((column = realloc(table->operand_2, cap*sizeof(AInt32))) == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	table->operand_2 = (AInt32*)column;
+	if ((column = realloc(table->value, cap*sizeof(AInt32))) == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	table->value = (AInt32*)column;
+	if ((column = realloc(table->n_op, cap*sizeof(AByte))) == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	table->n_op = (AByte*)column;
+	if ((column = realloc(table->kind, cap*sizeof(AType))) == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	table->kind = (AType*)column;
+	if ((column = realloc(table->code, cap*sizeof(AAddr))) == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	table->code = (AAddr*)column;
+	if ((column = realloc(table->status, cap*sizeof(AByte))) == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	table->status = (AByte*)column;
 
-	if (x->right != NULL)
-		x->right->parent = y;
+	table->cap = cap;
+	return SUCCESS;
+}
 
-	x->parent = y->parent;
+static AInt32 _ds_itable_intern(_ds_itable* table, AInt32 id, AString string) {	/* The id of a field, interning the string if the id is not known  */
+	if ((id != UNSET_DS_INTERN) || (string == NULL))
+		return id;
 
-	if (y->parent == NULL)
-		map->root = x;
-	else if (y == y->parent->right)
-		y->parent->right = x;
-	else
-		y->parent->left = x;
+	return table->interner->intern(table->interner, NULL, string, strlen(string));
+}
 
-	x->right = y;
-	y->parent = x;
+static void _ds_itable_load(_ds_itable* table, ASize row, IItem* item) {	/* Fill `item` with a view of the row  */
+	Interner* interner = table->interner;
 
+	item->address = table->address[row];
+	item->lno = table->lno[row];
+	item->n_op = table->n_op[row];
+	item->mnemonic = (table->mnemonic[row] == UNSET_DS_INTERN)? UNSET_DS_MNEMONIC: (ASize)table->mnemonic[row];
+	item->opcode_id = table->opcode[row];
+	item->opcode = (item->opcode_id == UNSET_DS_INTERN)? NULL: interner->string(interner, item->opcode_id);
+	item->operand_1_id = table->operand_1[row];
+	item->operand_1 = (item->operand_1_id == UNSET_DS_INTERN)? NULL: interner->string(interner, item->operand_1_id);
+	item->operand_2_id = table->operand_2[row];
+	item->operand_2 = (item->operand_2_id == UNSET_DS_INTERN)? NULL: interner->string(interner, item->operand_2_id);
+	item->operand_kind = table->kind[row];
+	item->operand_value = table->value[row];
+	item->code = table->code[row];
+	item->status = (table->status[row] == UNSET_DS_STATUS)? UNSET_DS_STATUS: (AErr)table->status[row];
+	item->comment = NULL;
+	item->destroy = _ds_release_IItem;
 }
 
-static void _ds_map_node_rot_left(_ds_map* map, _ds_map_node* x) {
+AErr ds_IList_put(IList* ilist, const IItem* item) {	/* Copy the item into a new row   */
+	if ((ilist == NULL) || (ilist->table == NULL) || (item == NULL))
+		return ERR_DS_INVALID_STRUCT;
+
+	_ds_itable* table = (_ds_itable*)(ilist->table);
+	if ((table->size == table->cap) && (_ds_itable_grow(table) != SUCCESS))
+		return ERR_DS_STRUCT_GEN_FAIL;
 
-	_ds_map_node* y = x->right;
-	x->right = y->left;
+	AInt32 opcode = _ds_itable_intern(table, item->opcode_id, item->opcode);
+	AInt32 operand_1 = _ds_itable_intern(table, item->operand_1_id, item->operand_1);
+	AInt32 operand_2 = _ds_itable_intern(table, item->operand_2_id, item->operand_2);
+	if (((opcode == UNSET_DS_INTERN) && (item->opcode != NULL)) ||
+		((operand_1 == UNSET_DS_INTERN) && (item->operand_1 != NULL)) ||
+		((operand_2 == UNSET_DS_INTERN) && (item->operand_2 != NULL)))
+		return ERR_DS_STRUCT_GEN_FAIL;
 
-	if (y->left != NULL)
-		y->left->parent = x;
+	AInt32 value = item->operand_value;
+	AType kind = item->operand_kind;
+	if (operand_1 == UNSET_DS_INTERN) {
+		kind = TYPE_DS_OPERAND_NONE;
+	} else if (kind == UNSET_DS_OPERAND) {
+		/* The parser types its operands, only hand made items get here  */
+		kind = ds_operand_kind(table->interner->string(table->interner, operand_1), &value);
+	}
 
-	y->parent = x->parent;
+	ASize row = table->size;
+	table->address[row] = item->address;
+	table->lno[row] = (AInt32)item->lno;
+	table->mnemonic[row] = (item->mnemonic == UNSET_DS_MNEMONIC)? UNSET_DS_INTERN: (AInt32)item->mnemonic;
+	table->opcode[row] = opcode;
+	table->operand_1[row] = operand_1;
+	table->operand_2[row] = operand_2;
+	table->value[row] = value;
+	table->n_op[row] = (AByte)item->n_op;
+	table->kind[row] = kind;
+	table->code[row] = 0;
+	table->status[row] = UNSET_DS_STATUS;
+	table->size++;
 
-	if (x->parent == NULL)
-		map->root  = y;
-	else if (x == x->parent->left)
-		x->parent->left = y;
-	else
-		x->parent->right = y;
+	return SUCCESS;
+}
 
-	y->left = x;
-	x->parent = y;
+AErr ds_IList_insert(IList* ilist, IItem* item) {	/* Function to insert item to Instruction List   */
+	AErr eno = ds_IList_put(ilist, item);
+	if (eno != SUCCESS)
+		return eno;
 
+	item->destroy(item);	/* The row holds a copy of everything  */
+	return SUCCESS;
 }
 
-static void _ds_map_fixup(_ds_map* map, _ds_map_node* node) {	/* Function to fix the map to adhere to Red-Black Tree rules  */
-	if (node == NULL)
+void ds_IList_begin(IList* ilist, ICursor* cursor) {
+	if (cursor == NULL)
 		return;
 
-	_ds_map_node* z = node;
+	cursor->row = 0;
+}
 
-	while (z != map->root) {
+ABool ds_IList_next(IList* ilist, ICursor* cursor) {
+	if ((ilist == NULL) || (ilist->table == NULL) || (cursor == NULL))
+		return FALSE;
 
-		if (z->parent->color != RED)
-			break;
-		
-		if (z->parent == z->parent->parent->left) {	/* Parent is left child   */
-			_ds_map_node* y = z->parent->parent->right; 		/* The uncle   */
-
-			if ((y != NULL) && (y->color == RED)) {	/* Case I: Uncle is RED */
-				z->parent->color = BLACK;
-				y->color = BLACK;
-				z->parent->parent->color = RED;
-				z = z->parent->parent;
-			} else {
-				if (z == z->parent->right) {
-						/* Case II: z is right child  */
-						z = z->parent;
-						_ds_map_node_rot_left(map, z);
-				}
-				/* Case III: z is left child  */
-				z->parent->color = BLACK;
-				z->parent->parent->color = RED;
-				_ds_map_node_rot_right(map, z->parent->parent);
-			}
-		} else {
-		/* Mirror Case  */
-			_ds_map_node* y = z->parent->parent->left;
-
-			if ((y != NULL) && (y->color == RED)) {
-				z->parent->color = BLACK;
-				y->color = BLACK;
-				z->parent->parent->color = RED;
-				z = z->parent->parent;
-			} else {
-				if (z == z->parent->left) {
-					z = z->parent;
-					_ds_map_node_rot_right(map, z);
-				}
-				z->parent->color = BLACK;
-				z->parent->parent->color = RED;
-				_ds_map_node_rot_left(map, z->parent->parent);
-			}
-		}
-	}
-	map->root->color = BLACK;
+	_ds_itable* table = (_ds_itable*)(ilist->table);
+	if (cursor->row >= table->size)
+		return FALSE;
 
+	_ds_itable_load(table, cursor->row++, &cursor->item);
+	return TRUE;
 }
 
-static void _ds_map_print(_ds_map_node* node) {
-	if (node == NULL)
-		return;
-	_ds_map_print(node->left);
-	printf("DEBUG: address-> %d, data->%d\n", node->key, node->data);
-	_ds_map_print(node->right);
-}
+AErr ds_IList_record(IList* ilist, ICursor* cursor, AAddr code, AErr status) {	/* Keep the encoding of the row last loaded by `cursor`   */
+	if ((ilist == NULL) || (ilist->table == NULL) || (cursor == NULL))
+		return ERR_DS_INVALID_STRUCT;
 
-AErr _ds_map_insert_handler(_ds_map_node* node, AAddr key, void* data) {
-	if (node->key == key) {
-		return ERR_MAP_DUP_KEY;
-	}
-	if (node->key > key) {
-		if (node->left == NULL) {
-			_ds_map_node* new_node = _ds_get_map_node(key, data);
-			if (new_node == NULL)
-				return ERR_DS_STRUCT_GEN_FAIL;
-			node->left = new_node;
-			return SUCCESS;
-		}
-		return _ds_map_insert_handler(node->left, key, data);
-	} else {
-		if (node->right == NULL) {
-			_ds_map_node* new_node = _ds_get_map_node(key, data);
-			if (new_node == NULL)
-				return ERR_DS_STRUCT_GEN_FAIL;
-			node->right = new_node;
-			return SUCCESS;
-		}
-		return _ds_map_insert_handler(node->right, key, data);
-	}
+	_ds_itable* table = (_ds_itable*)(ilist->table);
+	if ((cursor->row == 0) || (cursor->row > table->size))
+		return ERR_DS_INVALID_STRUCT;
+
+	table->code[cursor->row - 1] = code;
+	table->status[cursor->row - 1] = (AByte)status;
+	cursor->item.code = code;
+	cursor->item.status = status;
+	return SUCCESS;
 }
 
-AErr _ds_map_insert(_ds_map* map, AAddr key, void* data) {
-	if (map == NULL)
+AErr ds_IList_retype(IList* ilist, ICursor* cursor, AType kind, AInt32 value) {	/* Type the first operand of the row last loaded by `cursor`   */
+	if ((ilist == NULL) || (ilist->table == NULL) || (cursor == NULL))
 		return ERR_DS_INVALID_STRUCT;
-	
-	if (map->size == 0) {
-		/* If size map is empty   */
-		_ds_map_node* node = _ds_get_map_node(key, data);
-		if (node == NULL)
-			return ERR_DS_STRUCT_GEN_FAIL;
-		map->root = node;
-		map->size = 1;
-		
-		return SUCCESS;
-	}
 
-	AErr err = _ds_map_insert_handler(map->root, key, data);
+	_ds_itable* table = (_ds_itable*)(ilist->table);
+	if ((cursor->row == 0) || (cursor->row > table->size))
+		return ERR_DS_INVALID_STRUCT;
 
-	if (err == SUCCESS) {
-		map->size += 1;
-	}
-	
-	return err;
+	table->kind[cursor->row - 1] = kind;
+	table->value[cursor->row - 1] = value;
+	cursor->item.operand_kind = kind;
+	cursor->item.operand_value = value;
+	return SUCCESS;
 }
 
-_ds_map_node* _ds_map_find_handler(_ds_map_node* node, AAddr key) {	/* The function to find key in HMap recursively */
-	if (node == NULL)	/* Return NULL if the key is not found   */
-		return NULL;
+AErr ds_IList_append(IList* ilist, IList* other, ASize first, ASize count, AAddr base) {	/* Copy rows [first, first + count) of `other`, moving them by `base`   */
+	if ((ilist == NULL) || (ilist->table == NULL) || (other == NULL) || (other->table == NULL) || (ilist == other))
+		return ERR_DS_INVALID_STRUCT;
 
-	if (node->key == key)		/* Return node is correct key is matched   */
-		return node;
+	_ds_itable* table = (_ds_itable*)(ilist->table);
+	_ds_itable* from = (_ds_itable*)(other->table);
+	if ((first > from->size) || (count > from->size - first) || (from->interner != table->interner))
+		return ERR_DS_INVALID_STRUCT;	/* The ids only mean the same in one interner  */
+
+	while (table->size + count > table->cap) {
+		if (_ds_itable_grow(table) != SUCCESS)
+			return ERR_DS_STRUCT_GEN_FAIL;
+	}
 
-	else if (node->key > key)
-		return _ds_map_find_handler(node->left, key);
+	ASize row = table->size;
+	ASize i;
+	for (i = 0; i<count; i++)
+		table->address[row + i] = from->address[first + i] + base;
+	memcpy(table->lno + row, from->lno + first, count*sizeof(AInt32));
+	memcpy(table->mnemonic + row, from->mnemonic + first, count*sizeof(AInt32));
+	memcpy(table->opcode + row, from->opcode + first, count*sizeof(AInt32));
+	memcpy(table->operand_1 + row, from->operand_1 + first, count*sizeof(AInt32));
+	memcpy(table->operand_2 + row, from->operand_2 + first, count*sizeof(AInt32));
+	memcpy(table->value + row, from->value + first, count*sizeof(AInt32));
+	memcpy(table->n_op + row, from->n_op + first, count*sizeof(AByte));
+	memcpy(table->kind + row, from->kind + first, count*sizeof(AType));
+	memcpy(table->code + row, from->code + first, count*sizeof(AAddr));
+	memcpy(table->status + row, from->status + first, count*sizeof(AByte));
+	table->size += count;
 
-	else
-		return _ds_map_find_handler(node->right, key);
+	return SUCCESS;
 }
 
-_ds_map_node* _ds_map_find(_ds_map* map, AAddr key) {	
-	if (map == NULL)
-		return NULL;
+void ds_IList_clear(IList* ilist) {	/* Drop every row, the columns are kept for reuse   */
+	if ((ilist == NULL) || (ilist->table == NULL))
+		return;
 
-	return _ds_map_find_handler(map->root, key);
-}
-
-ABool _ds_map_empty(_ds_map* map) {
-	if (map == NULL)
-		return TRUE;
-
-	return (map->size == 0)? TRUE: FALSE;
-}
-
-ASize _ds_map_size(_ds_map* map) {
-	if (map == NULL)
-		return NULL;
-
-	return map->size;
-}
-
-static void _ds_map_next_iterator(_ds_map_node* node, _ds_queue* queue) {
-	if (node == NULL)
-		return;
-	if (node->left != NULL)
-		_ds_map_next_iterator(node->left, queue);		
-	
-	_ds_queue_insert(queue, node->data);
-
-	if (node->right != NULL)
-		_ds_map_next_iterator(node->right, queue);
-}
-
-/* --------------------------------------------------------
- * Function for Global Data Structures
- * --------------------------------------------------------*/
-
-
-/**
- * The Functions for Instruction Item
- * -----------------------------------------*/
-void ds_destroy_IItem(IItem* item) {	/* Free the Instruction structure from memory   */
-	if (item == NULL)
-		return;
-
-	if (item->operand_1 != NULL)
-		free(item->operand_1);
-	if (item->operand_2 != NULL)
-		free(item->operand_2);
-
-	free(item);
-	item = NULL;
-}
-
-IItem *ds_new_IItem(AAddr address) {	/* Allocate new Instruction structure in memory   */
-	IItem* item = (IItem*)malloc(sizeof(IItem));
-	if (item == NULL)
-		return NULL;
-
-	item->address = address;
-	item->n_op = 0;	/* Set default num operators to 0  */
-	item->opcode = NULL;
-	item->operand_1 = NULL;
-	item->operand_2 = NULL;
-	item->comment = NULL;
-	item->destroy = ds_destroy_IItem;
-	return item;
-}
-
-/**
- * The Functions for Instruction List
- * -----------------------------------------*/
-
-AErr ds_IList_insert(IList* ilist, IItem* item) {	/* Function to insert item to Instruction List   */
-	if (ilist == NULL)
-		return ERR_DS_INVALID_STRUCT;
-
-	if (ilist->queue == NULL)
-		return ERR_DS_INVALID_STRUCT;
-
-	if (item == NULL)
-		return ERR_DS_INVALID_STRUCT;
-	
-	_ds_queue* queue = (_ds_queue*)(ilist->queue);
-	return _ds_queue_insert(queue, (void*)item);
+	((_ds_itable*)(ilist->table))->size = 0;
 }
 
 IItem *ds_IList_find(IList* ilist, AAddr address) {
@@ -965,90 +761,90 @@ ABool ds_IList_empty(IList* ilist) {
 	if (ilist == NULL)
 		return TRUE;
 
-	if (ilist->queue == NULL)
+	if (ilist->table == NULL)
 		return TRUE;
 
-	return _ds_queue_empty((_ds_queue*)(ilist->queue));
+	return (((_ds_itable*)(ilist->table))->size == 0)? TRUE: FALSE;
 }
 
 ASize ds_IList_size(IList* ilist) {
-	if (ilist == NULL)
-		return ilist;
+	if ((ilist == NULL) || (ilist->table == NULL))
+		return 0;
 
-	return ilist->size;
+	return ((_ds_itable*)(ilist->table))->size;
 }
 
 void ds_destroy_IList(IList* ilist) {
 	if (ilist == NULL)
 		return;
 
-	if (ilist->queue != NULL) {
-		_ds_queue* queue = (_ds_queue*)(ilist->queue);
-		_ds_free_queue(queue, TRUE);
+	if (ilist->table != NULL) {
+		_ds_itable* table = (_ds_itable*)(ilist->table);
+		free(table->address);
+		free(table->lno);
+		free(table->mnemonic);
+		free(table->opcode);
+		free(table->operand_1);
+		free(table->operand_2);
+		free(table->value);
+		free(table->n_op);
+		free(table->kind);
+		free(table->code);
+		free(table->status);
+		free(table);
 	}
 	
 	free(ilist);
 	ilist = NULL;
 }
 
-IItem *ds_IList_get(IList* ilist) {
+IItem *ds_IList_get(IList* ilist) {	/* One walk at a time over all lists, the item is valid until the next call  */
 	static IList* iptr = NULL;
-	static _ds_queue_node* node = NULL;
+	static ICursor cursor;
 
-	if ((ilist == NULL) && (iptr == NULL)) {
-		/* If Nothing is provided and there is no previous memory   */
-		iptr = NULL;
-		node = NULL;
-		return _END_ILIST;
-	} else if (ilist == NULL) {
-		/* If nothing is provided and there is previous memory   */
-		if (node == NULL)
-			return _END_ILIST;
-		node = node->next;
-		if (node == NULL)
-			return _END_ILIST;
-		IItem *item = (IItem*)(node->data);
-		if (item == NULL)
-			return _END_ILIST;
-
-		return item;
-	} else {
+	if (ilist != NULL) {
 		/* Start with refreshed memory   */
 		iptr = ilist;
-		node = NULL;
-		_ds_queue* queue = ilist->queue;
-		if (queue == NULL)
-			return _END_ILIST;
+		ds_IList_begin(iptr, &cursor);
+	} else if (iptr == NULL) {
+		/* If Nothing is provided and there is no previous memory   */
+		return _END_ILIST;
+	}
 
-		node = queue->front;
-		if (node == NULL)
-			return _END_ILIST;
+	if (ds_IList_next(iptr, &cursor) == FALSE)
+		return _END_ILIST;
 
-		IItem *item = (IItem*)(node->data);
-		if (item == NULL)
-			return _END_ILIST;
-		
-		return item;		
-	}
+	return &cursor.item;
 }
 
 IItem *ds_IList_end() {
 	return _END_ILIST;
 }
 
-IList *ds_new_IList() {
+IList *ds_new_IList(Assembly* assembly) {	/* The opcodes and operands are kept as ids of the interner  */
+	if ((assembly == NULL) || (assembly->interner == NULL))
+		return NULL;
+
 	IList *ilist = (IList*)malloc(sizeof(IList));
 	if (ilist == NULL)
 		return NULL;
 
-	_ds_queue* queue = _ds_get_queue();
-	if (queue == NULL) {
-		ds_destroy_IList(ilist);
+	_ds_itable* table = (_ds_itable*)calloc(1, sizeof(_ds_itable));
+	if (table == NULL) {
+		free(ilist);
 		return NULL;
 	}
+	table->interner = assembly->interner;
 
-	ilist->queue = queue;
+	ilist->table = table;
 	ilist->insert = ds_IList_insert;
+	ilist->put = ds_IList_put;
+	ilist->begin = ds_IList_begin;
+	ilist->next = ds_IList_next;
+	ilist->record = ds_IList_record;
+	ilist->retype = ds_IList_retype;
+	ilist->append = ds_IList_append;
+	ilist->clear = ds_IList_clear;
 	ilist->find = ds_IList_find;
 	ilist->empty = ds_IList_empty;
 	ilist->size = ds_IList_size;
@@ -1082,51 +878,170 @@ SymItem* ds_new_SymItem(AString key, AAddr address) {
 	return sitem;
 }
 
+static void _ds_release_SymItem(SymItem* sitem) {	/* `destroy` of a cursor view, the symbol stays in its table  */
+}
+
 /**
  * The Functions for Symbol Table 
  * -----------------------------------------*/
 
-AErr ds_SymTable_insert(SymTable* table, AString key, AAddr address) {
+struct _ds_symbol_struct {
+	AAddr address;
+	ASize seq;		/* 1 + the position of the symbol in insert order, 0 if absent  */
+	ABool constant;	/* Defined by `SET`, the address is its value  */
+};
+
+typedef struct _ds_symbol_struct _ds_symbol;
+
+struct _ds_symtab_struct {
+	_ds_symbol* symbols;	/* The symbols by interned id  */
+	ASize cap;
+	AInt32* order;				/* The ids in insert order  */
+	ASize size;
+	ASize order_cap;
+	struct _ds_symbol_rank_struct* ranks;	/* The ids in walk order  */
+	ASize ranked;				/* The symbols covered by `ranks`  */
+	pthread_mutex_t lock;	/* Guards the ranking  */
+	Interner* interner;	/* The keys of the ids  */
+};
+
+typedef struct _ds_symtab_struct _ds_symtab;
+
+struct _ds_symbol_rank_struct {	/* The sort key of a walk  */
+	AAddr hash;
+	ASize seq;
+	AInt32 id;
+};
+
+typedef struct _ds_symbol_rank_struct _ds_symbol_rank;
+
+static int _ds_symbol_rank_cmp(const void* a, const void* b) {
+	const _ds_symbol_rank* x = (const _ds_symbol_rank*)a;
+	const _ds_symbol_rank* y = (const _ds_symbol_rank*)b;
+	if (x->hash != y->hash)
+		return (x->hash < y->hash)? -1: 1;
+	return (x->seq < y->seq)? -1: (x->seq > y->seq);
+}
+
+static void _ds_symtab_rank(_ds_symtab* symtab) {	/* Sort the ids for the walks, once per change of the table  */
+	if (__atomic_load_n(&symtab->ranked, __ATOMIC_ACQUIRE) == symtab->size)
+		return;
+
+	pthread_mutex_lock(&symtab->lock);
+	if (symtab->ranked != symtab->size) {
+		_ds_symbol_rank* ranks = (_ds_symbol_rank*)realloc(symtab->ranks, symtab->size*sizeof(_ds_symbol_rank));
+		if (ranks != NULL) {
+			Interner* interner = symtab->interner;
+			ASize i;
+			for (i = 0; i<symtab->size; i++) {
+				ranks[i].id = symtab->order[i];
+				ranks[i].seq = i;
+				ranks[i].hash = djb2(interner->string(interner, ranks[i].id));
+			}
+			qsort(ranks, symtab->size, sizeof(_ds_symbol_rank), _ds_symbol_rank_cmp);
+
+			symtab->ranks = ranks;
+			__atomic_store_n(&symtab->ranked, symtab->size, __ATOMIC_RELEASE);
+		}
+	}
+	pthread_mutex_unlock(&symtab->lock);
+}
+
+AErr ds_SymTable_insertId(SymTable* table, AInt32 id, AAddr address) {
+	if ((table == NULL) || (table->hashmap == NULL) || (id == UNSET_DS_INTERN))
+		return ERR_DS_INVALID_STRUCT;
+
+	_ds_symtab* symtab = (_ds_symtab*)(table->hashmap);
+	if ((ASize)id >= symtab->cap) {
+		ASize cap = (symtab->cap == 0)? 256: symtab->cap;
+		while (cap <= (ASize)id)
+			cap *= 2;
+		_ds_symbol* symbols = (_ds_symbol*)realloc(symtab->symbols, cap*sizeof(_ds_symbol));
+		if (symbols == NULL)
+			return ERR_DS_STRUCT_GEN_FAIL;
+		memset(symbols + symtab->cap, 0, (cap - symtab->cap)*sizeof(_ds_symbol));
+		symtab->symbols = symbols;
+		symtab->cap = cap;
+	}
+
+	_ds_symbol* symbol = &symtab->symbols[id];
+	if (symbol->seq == 0) {
+		if (symtab->size == symtab->order_cap) {
+			ASize cap = (symtab->order_cap == 0)? 256: 2*symtab->order_cap;
+			AInt32* order = (AInt32*)realloc(symtab->order, cap*sizeof(AInt32));
+			if (order == NULL)
+				return ERR_DS_STRUCT_GEN_FAIL;
+			symtab->order = order;
+			symtab->order_cap = cap;
+		}
+		symtab->order[symtab->size++] = id;
+		symbol->seq = symtab->size;
+	}
+
+	symbol->address = address;
+	symbol->constant = FALSE;
+	return SUCCESS;
+}
+
+AErr ds_SymTable_insertConst(SymTable* table, AInt32 id, AAddr value) {	/* A symbol of `SET`, its value is known when it is defined  */
+	AErr eno = ds_SymTable_insertId(table, id, value);
+	if (eno != SUCCESS)
+		return eno;
+
+	((_ds_symtab*)(table->hashmap))->symbols[id].constant = TRUE;
+	return SUCCESS;
+}
+
+ABool ds_SymTable_isConst(SymTable* table, AInt32 id) {
+	if ((table == NULL) || (table->hashmap == NULL))
+		return FALSE;
+
+	_ds_symtab* symtab = (_ds_symtab*)(table->hashmap);
+	if (((ASize)id >= symtab->cap) || (symtab->symbols[id].seq == 0))
+		return FALSE;
+
+	return symtab->symbols[id].constant;
+}
+
+AAddr ds_SymTable_findId(SymTable* table, AInt32 id) {
+	if ((table == NULL) || (table->hashmap == NULL))
+		return ERR_MAP_FIND_ADDRESS;
+
+	_ds_symtab* symtab = (_ds_symtab*)(table->hashmap);
+	if (((ASize)id >= symtab->cap) || (symtab->symbols[id].seq == 0))
+		return ERR_MAP_FIND_ADDRESS;
+
+	return symtab->symbols[id].address;
+}
+
+AErr ds_SymTable_insert(SymTable* table, AString key, AAddr address) {	/* The key is interned, the caller keeps its string  */
 	if (table == NULL)
 		return ERR_DS_INVALID_STRUCT;
 
-	if (table->hashmap == NULL)
+	if ((table->hashmap == NULL) || (key == NULL))
 		return ERR_DS_INVALID_STRUCT;
 
-	_ds_smap* smap = (_ds_smap*)(table->hashmap);
-	AAddr* data = (AAddr*)malloc(sizeof(AAddr));
-	if (data == NULL)
+	Interner* interner = ((_ds_symtab*)(table->hashmap))->interner;
+	AInt32 id = interner->intern(interner, NULL, key, strlen(key));
+	if (id == UNSET_DS_INTERN)
 		return ERR_DS_STRUCT_GEN_FAIL;
-	
-	*data = address;
-	return _ds_smap_insert(smap, key, (void*)data);
+
+	return ds_SymTable_insertId(table, id, address);
 }
 
 AAddr ds_SymTable_find(SymTable* table, AString key) {
-	if (table == NULL)
+	if ((table == NULL) || (key == NULL))
 		return ERR_MAP_FIND_ADDRESS;
 
 	if (table->hashmap == NULL)
 		return ERR_MAP_FIND_ADDRESS;
 
-	_ds_smap *smap = (_ds_smap*)(table->hashmap);
-	_ds_smap_node* node = _ds_smap_find(smap, key);
-
-	if (node == NULL)
+	Interner* interner = ((_ds_symtab*)(table->hashmap))->interner;
+	AInt32 id = interner->lookup(interner, key, strlen(key));
+	if (id == UNSET_DS_INTERN)
 		return ERR_MAP_FIND_ADDRESS;
-	
-	AAddr* data = (AAddr*)(node->data);
-	return *data;
-}
-
-ABool ds_SymTable_empty(SymTable *table) {
-	if (table == NULL)
-		return TRUE;
-
-	if (table->hashmap == NULL)
-		return TRUE;
 
-	return _ds_smap_empty((_ds_smap*)(table->hashmap));
+	return ds_SymTable_findId(table, id);
 }
 
 ASize ds_SymTable_size(SymTable *table) {
@@ -1136,7 +1051,11 @@ ASize ds_SymTable_size(SymTable *table) {
 	if (table->hashmap == NULL)
 		return 0;
 
-	return _ds_smap_size((_ds_smap*)(table->hashmap));
+	return ((_ds_symtab*)(table->hashmap))->size;
+}
+
+ABool ds_SymTable_empty(SymTable *table) {
+	return (ds_SymTable_size(table) == 0)? TRUE: FALSE;
 }
 
 void ds_destroy_SymTable(SymTable* table) {
@@ -1144,146 +1063,101 @@ void ds_destroy_SymTable(SymTable* table) {
 		return;
 
 	if (table->hashmap != NULL) {
-		_ds_smap* smap = (_ds_smap*)(table->hashmap);
-		_ds_free_smap(smap);
+		_ds_symtab* symtab = (_ds_symtab*)(table->hashmap);
+		free(symtab->symbols);
+		free(symtab->order);
+		free(symtab->ranks);
+		pthread_mutex_destroy(&symtab->lock);
+		free(symtab);
 	}
 	
 	free(table);
 	table = NULL;
 }
 
-SymItem* ds_SymTable_get(SymTable* table) {
-	static SymTable* tptr = NULL;
-	static _ds_queue* queue = NULL;
-	static _ds_queue_node* bktnode = NULL;
-	static _ds_smap_node* node = NULL;
-	static SymItem* sitem = NULL;
-	
-	ds_destroy_SymItem(sitem);
-
-	if ((table == NULL) && (tptr == NULL)) {
-	/* If the Symbol Table is not provided and there is no back record   */
-		_ds_free_queue(queue, FALSE);
-		bktnode = NULL;
-		node = NULL;
-		return _END_SYMTB;
-	}
-	else if (table == NULL) {
-	/* If the Symbol Table is not provided and there is back record  */
-		if ((node != NULL) && (bktnode != NULL) && (queue != NULL)) {
-			if (node == ((_ds_smap_bucket*)(bktnode->data))->head) {
-					/* Bucket is finished */
-				bktnode = bktnode->next;
-				if (bktnode == NULL)
-					return _END_SYMTB;
-
-				_ds_smap_bucket* bucket = bktnode->data;
-				if (bucket == NULL)
-					return _END_SYMTB;
-
-				if (bucket->size == 0) {
-					bucket = NULL;
-					return _END_SYMTB;
-				}
-
-				node = bucket->head;
-				int i;
-				for (i = 0; i<bucket->size-1; i++) {
-					node = node->next;
-				}
-				
-			} else {
-				node = node->prev;
-				if (node == NULL)
-					return _END_SYMTB;
-			} 
-			sitem = ds_new_SymItem(node->key, *(AAddr*)node->data);
-			if (sitem == NULL) {
-				_ds_free_queue(queue, FALSE);
-				queue = NULL;
-				return _END_SYMTB;
-			}
-			return sitem;
-		} else {
-			/*  Clean up all the mess  */
-			_ds_free_queue(queue, FALSE);
-			queue = NULL;
-			tptr = NULL;
-			bktnode = NULL;
-			node = NULL;
-			return _END_SYMTB;
-		} 
-	}
-	else if ((tptr == NULL) || (tptr != table)) {
-	/* If the Symbol Table is first introduced   */
-		tptr = table;
-		queue = _ds_get_queue();
-		if (queue == NULL)
-			return _END_SYMTB;
-	
-		if (table->hashmap == NULL)
-			return _END_SYMTB;
+void ds_SymTable_begin(SymTable* table, SymCursor* cursor) {	/* Ranks the table if it changed since the last walk  */
+	if (cursor == NULL)
+		return;
 
-		_ds_smap* smap = table->hashmap;
-		_ds_smap_bucket* root = smap->root;
+	cursor->rank = 0;
+	if ((table != NULL) && (table->hashmap != NULL))
+		_ds_symtab_rank((_ds_symtab*)(table->hashmap));
+}
 
-		if (root == NULL)
-			return _END_SYMTB;
+ABool ds_SymTable_next(SymTable* table, SymCursor* cursor) {
+	if ((table == NULL) || (table->hashmap == NULL) || (cursor == NULL))
+		return FALSE;
 
-		_ds_smap_next_iterator(root, queue);
-		if (_ds_queue_size(queue) == 0) {
-			return _END_SYMTB;
-		}
+	_ds_symtab* symtab = (_ds_symtab*)(table->hashmap);
+	if (cursor->rank >= __atomic_load_n(&symtab->ranked, __ATOMIC_ACQUIRE))
+		return FALSE;
 
-		bktnode = queue->front;
+	AInt32 id = symtab->ranks[cursor->rank++].id;
+	Interner* interner = symtab->interner;
+	cursor->item.key = interner->string(interner, id);
+	cursor->item.address = ds_SymTable_findId(table, id);
+	cursor->item.destroy = _ds_release_SymItem;
+	return TRUE;
+}
 
-		if (bktnode == NULL) 
-			return _END_SYMTB;
-	
-		_ds_smap_bucket* bucket = bktnode->data;
-		if (bucket == NULL) 
-			return _END_SYMTB;
+SymItem* ds_SymTable_get(SymTable* table) {	/* One walk at a time over all tables, the item is valid until the next call  */
+	static SymTable* tptr = NULL;
+	static SymCursor cursor;
 
-		
-		if (bucket->size == 0) 
-			return _END_SYMTB;
-		
-		/* If valid case reached finally filterer from above present error handlers  */
-		node = bucket->head;
-		int i;
-		for (i = 0; i<bucket->size-1; i++) {
-			node = node->next;
-		}
+	if (table != NULL) {
+		/* Start with refreshed memory   */
+		tptr = table;
+		ds_SymTable_begin(tptr, &cursor);
+	} else if (tptr == NULL) {
+		/* If Nothing is provided and there is no previous memory   */
+		return _END_SYMTB;
+	}
 
-		sitem = ds_new_SymItem(node->key, *(AAddr*)node->data);
-		if (sitem == NULL)
-			return _END_SYMTB;
+	if (ds_SymTable_next(tptr, &cursor) == FALSE)
+		return _END_SYMTB;
 
-		return sitem;
-	}
+	return &cursor.item;
 }
 
 SymItem*  ds_SymTable_end() {
 	return _END_SYMTB;
 }
 
-SymTable *ds_new_SymTable() {
+SymTable *ds_new_SymTable(Assembly* assembly) {	/* The symbols are keyed by the ids of the interner  */
+	if ((assembly == NULL) || (assembly->interner == NULL))
+		return NULL;
+
 	SymTable *table = (SymTable*)malloc(sizeof(SymTable));
 
 	if (table == NULL)
 		return NULL;
 
-	_ds_smap* smap = _ds_get_smap();
-	if (smap == NULL) {
-		ds_destroy_SymTable(table);
+	_ds_symtab* symtab = (_ds_symtab*)malloc(sizeof(_ds_symtab));
+	if (symtab == NULL) {
+		free(table);
 		return NULL;
 	}
-
-	table->hashmap = (void*)smap;
+	symtab->symbols = NULL;
+	symtab->cap = 0;
+	symtab->order = NULL;
+	symtab->size = 0;
+	symtab->order_cap = 0;
+	symtab->ranks = NULL;
+	symtab->ranked = 0;
+	symtab->interner = assembly->interner;
+	pthread_mutex_init(&symtab->lock, NULL);
+
+	table->hashmap = (void*)symtab;
 	table->insert = ds_SymTable_insert;
 	table->find = ds_SymTable_find;
+	table->insertId = ds_SymTable_insertId;
+	table->findId = ds_SymTable_findId;
+	table->insertConst = ds_SymTable_insertConst;
+	table->isConst = ds_SymTable_isConst;
 	table->empty = ds_SymTable_empty;
 	table->size = ds_SymTable_size;
+	table->begin = ds_SymTable_begin;
+	table->next = ds_SymTable_next;
 	table->get = ds_SymTable_get;
 	table->end = ds_SymTable_end;
 	table->destroy = ds_destroy_SymTable;
@@ -1318,152 +1192,117 @@ void ds_destroy_DItem(DItem *ditem) {
  * The Functions for Data List
  * -----------------------------------------*/
 
-AErr ds_DList_insert(DList* dlist, AInt32 data, AAddr *return_addr) {
+AErr ds_DList_insert(DList* dlist, AInt32 data, AAddr *return_addr) {	/* The word goes right after the last one  */
 	if (dlist == NULL)
 		return ERR_DS_INVALID_STRUCT;
 
-	if (dlist->map == NULL)
-		return ERR_MAP_INVALID_STRUCT;
-
-	AInt address = dlist->offset + dlist->base;
-	/* Size of incoming all data will be 4 byte for now.   */
-
-	DItem* ditem = ds_new_DItem(address, data);
-	if (ditem == NULL)
-		return ERR_DS_STRUCT_GEN_FAIL;
-
-	_ds_map* map = (_ds_map*)(dlist->map);
-
-	dlist->offset+=1;
-	*return_addr = address;
-
-	return _ds_map_insert(map, address, (void*)ditem);
-}
-
-DItem *ds_DList_find(DList *dlist, AAddr address) {
-	if (dlist == NULL)
-		return _END_DLIST;
+	if (dlist->offset == dlist->cap) {
+		ASize cap = (dlist->cap == 0)? SZ_DS_DLIST_WORDS: 2*dlist->cap;
+		AInt32* words;
+		if (dlist->arena == NULL) {
+			words = (AInt32*)realloc(dlist->words, cap*sizeof(AInt32));
+		} else {	/* The old words stay in the arena  */
+			words = (AInt32*)dlist->arena->alloc(dlist->arena, cap*sizeof(AInt32));
+			if ((words != NULL) && (dlist->offset > 0))
+				memcpy(words, dlist->words, dlist->offset*sizeof(AInt32));
+		}
+		if (words == NULL)
+			return ERR_MEM_REALLOC_FAIL;
+		dlist->words = words;
+		dlist->cap = cap;
+	}
 
-	if (dlist->map == NULL)
-		return _END_DLIST;
+	dlist->words[dlist->offset] = data;
+	*return_addr = dlist->base + dlist->offset;
+	dlist->offset += 1;
 
-	_ds_map* map = dlist->map;
-	_ds_map_node* node = _ds_map_find(map, address);
-	if (node == NULL)
-		return _END_DLIST;
-	
-	return (DItem*)(node->data);
+	return SUCCESS;
 }
 
-ABool ds_DList_empty(DList *dlist) {
-	if (dlist == NULL)
-		return TRUE;
-
-	if (dlist->map == NULL)
-		return TRUE;
-
-	_ds_map* map = (_ds_map*)(dlist->map);
+AInt32 *ds_DList_find(DList *dlist, AAddr address) {
+	if ((dlist == NULL) || (address < dlist->base) || (address - dlist->base >= dlist->offset))
+		return NULL;
 
-	return _ds_map_empty(map);
+	return &dlist->words[address - dlist->base];
 }
 
 ASize ds_DList_size(DList *dlist) {
 	if (dlist == NULL)
 		return 0;
 
-	if (dlist->map == NULL)
-		return 0;
-
-	_ds_map* map = (_ds_map*)(dlist->map);
+	return dlist->offset;
+}
 
-	return _ds_map_size(map);
+ABool ds_DList_empty(DList *dlist) {
+	return (ds_DList_size(dlist) == 0)? TRUE: FALSE;
 }
 
 void ds_destroy_DList(DList* dlist) {
 	if (dlist == NULL) 
 		return;
 	
-	if (dlist->map != NULL) {
-		_ds_map* map = dlist->map;
-		_ds_free_map(map);
-	}
-
+	if (dlist->arena == NULL)
+		free(dlist->words);
 	free(dlist);
 	dlist = NULL;
 }
 
-DItem *ds_DList_get(DList* dlist) {
-	static DList* dptr = NULL;
-	static _ds_queue_node* node = NULL;
-	static _ds_queue* queue = NULL;
-
-	if ((dlist == NULL) && (dptr == NULL)) {
-	/* If the data list is not provided and there is no back record */
-		_ds_free_queue(queue, FALSE);
-		node = NULL;
-		return _END_DLIST;
-	}
-	else if (dlist == NULL) {
-	/* If the data list is not provided and there is back record   */
-		if (node == NULL) {
-	/* Wipe memory on one additional call */
-			_ds_free_queue(queue, FALSE);
-			return _END_DLIST;
-		}
+void ds_DList_begin(DList* dlist, DCursor* cursor) {
+	if (cursor == NULL)
+		return;
 
-		node = node->next;
-		if (node == NULL)
-			return _END_DLIST;
-	
-		return (DItem*)(node->data);
-	} else {
-	/* The previous context to be lost and new instance is started  */
-		_ds_free_queue(node, FALSE);
-		dptr = dlist;
-		queue = _ds_get_queue();
-		if (queue == NULL)
-			return _END_DLIST;
-		
-		if (dlist->map == NULL)
-			return _END_DLIST;
+	cursor->index = 0;
+}
 
-		_ds_map* map = dlist->map;
+ABool ds_DList_next(DList* dlist, DCursor* cursor) {
+	if ((dlist == NULL) || (cursor == NULL) || (cursor->index >= dlist->offset))
+		return FALSE;
 
-		_ds_map_next_iterator(map->root, queue);
+	cursor->item.address = dlist->base + cursor->index;
+	cursor->item.data = dlist->words[cursor->index];
+	cursor->index += 1;
+	return TRUE;
+}
 
-		if (_ds_queue_size(queue) == 0) {
-			_ds_free_queue(queue, FALSE);
-			return _END_DLIST;
-		}
+DItem *ds_DList_get(DList* dlist) {	/* One walk at a time over all lists, the item is valid until the next call  */
+	static DList* dptr = NULL;
+	static DCursor cursor;
 
-		/* If first iterator is found   */
-		node = queue->front;
-		return (DItem*)(node->data);
+	if (dlist != NULL) {
+		/* Start with refreshed memory   */
+		dptr = dlist;
+		ds_DList_begin(dptr, &cursor);
+	} else if (dptr == NULL) {
+		/* If Nothing is provided and there is no previous memory   */
+		return _END_DLIST;
 	}
+
+	if (ds_DList_next(dptr, &cursor) == FALSE)
+		return _END_DLIST;
+
+	return &cursor.item;
 }
 
 DList* ds_DList_end() {
 	return _END_DLIST;
 }
 
-DList *ds_new_DList() {
+DList *ds_new_DList(Assembly* assembly) {	/* The words live in the arena of the assembly if one is given  */
 	DList* dlist = (DList*)malloc(sizeof(DList));
 	if (dlist == NULL)
 		return NULL;
 
-	_ds_map* map = _ds_get_map();
-	if (map == NULL) {
-		ds_destroy_DList(dlist);
-		return NULL;
-	}
-
-	dlist->map = (void*)map;
+	dlist->arena = (assembly != NULL)? assembly->arena: NULL;
+	dlist->words = NULL;
+	dlist->cap = 0;
 	dlist->base = 0;
 	dlist->offset = 0;
 	dlist->insert = ds_DList_insert;
 	dlist->find = ds_DList_find;
 	dlist->empty = ds_DList_empty;
 	dlist->size = ds_DList_size;
+	dlist->begin = ds_DList_begin;
+	dlist->next = ds_DList_next;
 	dlist->get = ds_DList_get;
 	dlist->end = ds_DList_end;
 	dlist->destroy = ds_destroy_DList;
@@ -1499,15 +1338,39 @@ void ds_destroy_EWItem(EWItem* item) {
  * The Functions for Error/Warning Item
  * -----------------------------------------*/
 
-AErr ds_EWList_insert(EWList* elist, EWItem* eitem) {
-	if (elist == NULL)
+AErr ds_EWList_put(EWList* elist, const EWItem* eitem) {	/* Copy the item into the storage of the list  */
+	if ((elist == NULL) || (eitem == NULL))
 		return ERR_DS_INVALID_STRUCT;
 
 	if (elist->queue == NULL)
-		return NULL;
+		return ERR_DS_INVALID_STRUCT;
 
-	_ds_queue* queue = (_ds_queue*)(elist->queue);
-	return _ds_queue_insert(queue, (void*)eitem);
+	EWItem* copy = (elist->arena != NULL)?
+		(EWItem*)elist->arena->alloc(elist->arena, sizeof(EWItem)):
+		(EWItem*)malloc(sizeof(EWItem));
+	if (copy == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	*copy = *eitem;
+
+	AErr eno = _ds_queue_insert((_ds_queue*)(elist->queue), (void*)copy);
+	if (eno != SUCCESS) {
+		if (elist->arena == NULL)
+			free(copy);
+		return eno;
+	}
+
+	if (copy->code >= THRESHOLD_EW_ERROR)
+		elist->errors++;
+	return SUCCESS;
+}
+
+AErr ds_EWList_insert(EWList* elist, EWItem* eitem) {	/* Takes the ownership of the item  */
+	AErr eno = ds_EWList_put(elist, eitem);
+	if (eno != SUCCESS)
+		return eno;
+
+	ds_destroy_EWItem(eitem);	/* The list holds a copy  */
+	return SUCCESS;
 }
 
 EWItem *ds_EWList_find(EWList* elist, ASize line) {
@@ -1550,68 +1413,81 @@ void ds_destroy_EWList(EWList *elist) {
 	elist = NULL;
 }
 
-EWItem *ds_EWList_get(EWList* elist) {
-	static EWList* eptr = NULL;
-	static _ds_queue_node* node = NULL;
+void ds_EWList_begin(EWList* elist, EWCursor* cursor) {
+	if (cursor == NULL)
+		return;
 
-	if ((elist == NULL) && (eptr == NULL)) {
-		/* If Nothing is provided and there is no previous memory   */
-		eptr = NULL;
-		node = NULL;
-		return _END_EWLST;
-	} else if (elist == NULL) {
-		/* If nothing is provided and there is previous memory   */
-		if (node == NULL)
-			return _END_EWLST;
-		node = node->next;
-		if (node == NULL)
-			return _END_EWLST;
-		EWItem *eitem = (EWItem*)(node->data);
-		if (eitem == NULL)
-			return _END_EWLST;
+	cursor->item = NULL;
+	cursor->node = NULL;
+	if ((elist != NULL) && (elist->queue != NULL))
+		cursor->node = (void*)(((_ds_queue*)(elist->queue))->front);
+}
 
-		return eitem;
-	} else {
-		/* Start with refreshed memory   */
-		eptr = elist;
-		node = NULL;
-		_ds_queue* queue = elist->queue;
-		if (queue == NULL)
-			return _END_EWLST;
+ABool ds_EWList_next(EWList* elist, EWCursor* cursor) {
+	if ((cursor == NULL) || (cursor->node == NULL))
+		return FALSE;
 
-		node = queue->front;
-		if (node == NULL)
-			return _END_EWLST;
+	_ds_queue_node* node = (_ds_queue_node*)(cursor->node);
+	cursor->item = (EWItem*)(node->data);
+	cursor->node = (void*)(node->next);
+	return (cursor->item != NULL)? TRUE: FALSE;
+}
 
-		EWItem *eitem = (EWItem*)(node->data);
-		if (eitem == NULL)
-			return _END_EWLST;
-		
-		return eitem;		
+EWItem *ds_EWList_get(EWList* elist) {	/* One walk at a time over all lists  */
+	static EWList* eptr = NULL;
+	static EWCursor cursor;
+
+	if (elist != NULL) {
+		/* Start with refreshed memory   */
+		eptr = elist;
+		ds_EWList_begin(eptr, &cursor);
+	} else if (eptr == NULL) {
+		/* If Nothing is provided and there is no previous memory   */
+		return _END_EWLST;
 	}
+
+	if (ds_EWList_next(eptr, &cursor) == FALSE)
+		return _END_EWLST;
+
+	return cursor.item;
 }
 
 IItem *ds_EWList_end() {
 	return _END_EWLST;
 }
-EWList *ds_new_EWList() {
+
+ABool ds_EWList_exhausted(EWList* elist) {
+	if ((elist == NULL) || (elist->budget == SZ_DS_EW_UNLIMITED))
+		return FALSE;
+
+	return (elist->errors >= elist->budget)? TRUE: FALSE;
+}
+EWList *ds_new_EWList(Assembly* assembly) {	/* The items live in the arena of the assembly if one is given  */
+	Arena* arena = (assembly != NULL)? assembly->arena: NULL;
 	EWList* elist = (EWList*)malloc(sizeof(EWList));
 	if (elist == NULL)
 		return NULL;
 
-	_ds_queue* queue = _ds_get_queue();
+	_ds_queue* queue = _ds_get_queue(arena);
 	if (queue == NULL) {
-		ds_destroy_EWList(elist);
+		free(elist);
 		return NULL;
 	}
 
 	elist->queue = (void*)queue;
+	elist->arena = arena;
+	elist->errors = 0;
+	elist->budget = SZ_DS_EW_UNLIMITED;
 	elist->insert = ds_EWList_insert;
+	elist->put = ds_EWList_put;
 	elist->find = ds_EWList_find;
 	elist->empty = ds_EWList_empty;
 	elist->size = ds_EWList_size;
+	elist->begin = ds_EWList_begin;
+	elist->next = ds_EWList_next;
 	elist->get = ds_EWList_get;
 	elist->end = ds_EWList_end;
+	elist->exhausted = ds_EWList_exhausted;
 	elist->destroy = ds_destroy_EWList;
 
 	return elist;
@@ -1638,43 +1514,216 @@ MnItem* ds_new_MnItem(AString key, AAddr encoding, ASize n_operand, AType operan
 	mitem->encoding = encoding;
 	mitem->n_operand = n_operand;
 	mitem->operand_type = operand_type;
+	mitem->id = UNSET_DS_MNEMONIC;
+	mitem->packed = (key == NULL)? UNSET_DS_PACKED: ds_pack_key(key, strlen(key));
 	mitem->destroy = ds_destroy_MnItem;
 	return mitem;
 }
 
+static void _ds_release_MnItem(MnItem* mitem) {	/* `destroy` of an item in an arena, it goes with the arena  */
+}
+
+static MnItem* _ds_arena_MnItem(Arena* arena, AString key, AAddr encoding, ASize n_operand, AType operand_type) {
+	MnItem* mitem = (MnItem*)arena->alloc(arena, sizeof(MnItem));
+	if (mitem == NULL)
+		return NULL;
+
+	mitem->key = key;
+	mitem->encoding = encoding;
+	mitem->n_operand = n_operand;
+	mitem->operand_type = operand_type;
+	mitem->id = UNSET_DS_MNEMONIC;
+	mitem->packed = (key == NULL)? UNSET_DS_PACKED: ds_pack_key(key, strlen(key));
+	mitem->destroy = _ds_release_MnItem;
+	return mitem;
+}
+
+/**
+ * The Functions for Packed Keys
+ * -----------------------------------------*/
+
+APacked ds_pack_key(const char* string, ASize length) {	/* Same value as `DS_PACK` of the characters  */
+	if ((string == NULL) || (length == 0) || (length > SZ_DS_PACKED_KEY))
+		return UNSET_DS_PACKED;
+
+	APacked key = 0;
+	ASize i;
+	for (i = 0; i<length; i++)
+		key |= (APacked)(unsigned char)string[i] << (8*i);
+	return key;
+}
+
 /**
  * The Functions for Mnemonic Map
  * -----------------------------------------*/
 
-AErr ds_MnMap_insert(MnMap* map, AString key, AAddr encoding, ASize n_operand, AType operand_type) {
+#define _DS_MNEMO_MAX_BITS 16		/* The perfect hash gives up beyond 1 << 16 slots  */
+#define _DS_MNEMO_ATTEMPTS 64		/* Multipliers tried for every table size  */
+
+struct _ds_mnemo_index_struct {
+	MnItem** items;		/* The items by id  */
+	ASize size;
+	ASize cap;
+	ASize* slots;			/* 1 + id of the item hashed there, 0 when empty  */
+	ASize shift;			/* 64 - log2 of the number of slots  */
+	APacked multiplier;	/* The odd multiplier that spreads the keys without collision  */
+};
+
+typedef struct _ds_mnemo_index_struct _ds_mnemo_index;
+
+static ASize _ds_mnemo_slot(APacked key, APacked multiplier, ASize shift) {
+	return (ASize)((key*multiplier) >> shift);
+}
+
+static AErr _ds_mnemo_index_build(_ds_mnemo_index* index) {	/* Search a multiplier that maps every packed key to its own slot  */
+	ASize bits = 1;
+	while (((ASize)1 << bits) < 2*index->size)
+		bits++;
+
+	for (; bits<=_DS_MNEMO_MAX_BITS; bits++) {
+		ASize count = (ASize)1 << bits;
+		ASize* slots = (ASize*)realloc(index->slots, count*sizeof(ASize));
+		if (slots == NULL)
+			return ERR_MEM_REALLOC_FAIL;
+		index->slots = slots;
+
+		ASize attempt;
+		for (attempt = 0; attempt<_DS_MNEMO_ATTEMPTS; attempt++) {
+			APacked multiplier = ((((APacked)0x9E3779B9 << 32) | 0x7F4A7C15) + 2*attempt*0x2545F491) | 1;
+			memset(slots, 0, count*sizeof(ASize));
+
+			ASize i;
+			for (i = 0; i<index->size; i++) {
+				MnItem* mitem = index->items[i];
+				if (mitem->packed == UNSET_DS_PACKED)
+					continue;
+
+				ASize slot = _ds_mnemo_slot(mitem->packed, multiplier, 64 - bits);
+				if (slots[slot] != 0)	/* The keys are unique, a repeated insert updates the first item  */
+					break;
+				slots[slot] = i + 1;
+			}
+
+			if (i == index->size) {
+				index->shift = 64 - bits;
+				index->multiplier = multiplier;
+				return SUCCESS;
+			}
+		}
+	}
+
+	return ERR_DS_INSERT_FAIL;
+}
+
+static AErr _ds_MnMap_add(MnMap* map, AString key, AAddr encoding, ASize n_operand, AType operand_type) {	/* Insert without rebuilding the perfect hash   */
 	if (map == NULL)
 		return ERR_DS_INVALID_STRUCT;
 
-	if (map->hashmap == NULL)
+	if ((map->hashmap == NULL) || (map->index == NULL))
 		return ERR_MAP_INVALID_STRUCT;
 
 	_ds_smap* smap = (_ds_smap*)(map->hashmap);
-	MnItem* mitem = ds_new_MnItem(key, encoding, n_operand, operand_type);
+	_ds_mnemo_index* index = (_ds_mnemo_index*)(map->index);
+	if (index->size == index->cap) {
+		ASize cap = (index->cap == 0)? 32: 2*index->cap;
+		MnItem** items = (MnItem**)realloc(index->items, cap*sizeof(MnItem*));
+		if (items == NULL)
+			return ERR_MEM_REALLOC_FAIL;
+		index->items = items;
+		index->cap = cap;
+	}
+
+	MnItem* mitem = (map->arena == NULL)? ds_new_MnItem(key, encoding, n_operand, operand_type):
+		_ds_arena_MnItem(map->arena, key, encoding, n_operand, operand_type);
 	if (mitem == NULL)
 		return ERR_DS_STRUCT_GEN_FAIL;
-	
-	return _ds_smap_insert(smap, key, (void*)mitem);
+
+	void* replaced;
+	AErr eno = _ds_smap_insert(smap, key, (void*)mitem, &replaced);
+	if (eno != SUCCESS) {
+		mitem->destroy(mitem);
+		return eno;
+	}
+
+	if (replaced != NULL) {		/* A repeated key takes the new values in its first item, its id and pointers stay good  */
+		MnItem* first = (MnItem*)replaced;
+		first->encoding = encoding;
+		first->n_operand = n_operand;
+		first->operand_type = operand_type;
+		_ds_smap_find(smap, key)->data = (void*)first;
+		mitem->destroy(mitem);
+		return SUCCESS;
+	}
+
+	mitem->id = index->size;
+	index->items[index->size++] = mitem;
+	return SUCCESS;
+}
+
+AErr ds_MnMap_insert(MnMap* map, AString key, AAddr encoding, ASize n_operand, AType operand_type) {
+	AErr eno = _ds_MnMap_add(map, key, encoding, n_operand, operand_type);
+	if (eno != SUCCESS)
+		return eno;
+
+	return _ds_mnemo_index_build((_ds_mnemo_index*)(map->index));
+}
+
+AErr ds_MnMap_load(MnMap* map, const MnRow* rows, ASize count) {	/* Insert a whole table, the perfect hash is searched once   */
+	if ((map == NULL) || (rows == NULL))
+		return ERR_DS_INVALID_STRUCT;
+
+	ASize i;
+	for (i = 0; i<count; i++) {
+		AErr eno = _ds_MnMap_add(map, rows[i].key, rows[i].encoding, rows[i].n_operand, rows[i].operand_type);
+		if (eno != SUCCESS)
+			return eno;
+	}
+
+	return _ds_mnemo_index_build((_ds_mnemo_index*)(map->index));
+}
+
+MnItem* ds_MnMap_match(MnMap* map, APacked key) {
+	if ((map == NULL) || (map->index == NULL) || (key == UNSET_DS_PACKED))
+		return NULL;
+
+	_ds_mnemo_index* index = (_ds_mnemo_index*)(map->index);
+	if (index->slots == NULL)
+		return NULL;
+
+	ASize slot = index->slots[_ds_mnemo_slot(key, index->multiplier, index->shift)];
+	if (slot == 0)
+		return NULL;
+
+	MnItem* mitem = index->items[slot - 1];
+	return (mitem->packed == key)? mitem: NULL;
+}
+
+MnItem* ds_MnMap_at(MnMap* map, ASize id) {
+	if ((map == NULL) || (map->index == NULL))
+		return NULL;
+
+	_ds_mnemo_index* index = (_ds_mnemo_index*)(map->index);
+	return (id < index->size)? index->items[id]: NULL;
 }
 
 MnItem* ds_MnMap_find(MnMap* map, AString key) {
-	if (map == NULL)
+	if ((map == NULL) || (key == NULL))
 		return NULL;
 
 	if (map->hashmap == NULL)
 		return NULL;
 
+	ASize length = strlen(key);
+	if (length <= SZ_DS_PACKED_KEY)	/* Every short key is in the perfect hash  */
+		return ds_MnMap_match(map, ds_pack_key(key, length));
+
 	_ds_smap *smap = (_ds_smap*)(map->hashmap);
-	_ds_smap_node* node = _ds_smap_find(smap, key);
+	_ds_smap_entry* entry = _ds_smap_find(smap, key);
 
-	if (node == NULL)
+	if (entry == NULL)
 		return NULL;
 	
-	MnItem* mitem = (MnItem*)(node->data);
+	MnItem* mitem = (MnItem*)(entry->data);
 	return mitem;
 }
 
@@ -1704,134 +1753,106 @@ void ds_destroy_MnMap(MnMap* map) {
 
 	if (map->hashmap != NULL) {
 		_ds_smap* smap = (_ds_smap*)(map->hashmap);
-		_ds_free_smap(smap);
+		_ds_free_smap(smap, (map->arena == NULL)? TRUE: FALSE);
+	}
+
+	if (map->index != NULL) {	/* The items themselves went with the hashmap  */
+		_ds_mnemo_index* index = (_ds_mnemo_index*)(map->index);
+		free(index->items);
+		free(index->slots);
+		free(index);
 	}
 	
 	free(map);
 	map = NULL;
 }
 
-MnItem* ds_MnMap_get(MnMap* map) {
-	static MnMap* tptr = NULL;
-	static _ds_queue* queue = NULL;
-	static _ds_queue_node* bktnode = NULL;
-	static _ds_smap_node* node = NULL;
-	
+void ds_MnMap_begin(MnMap* map, MnCursor* cursor) {	/* Ranks the map if it changed since the last walk  */
+	if (cursor == NULL)
+		return;
 
-	if ((map == NULL) && (tptr == NULL)) {
-	/* If the Mnemonic Map is not provided and there is no back record   */
-		_ds_free_queue(queue, FALSE);
-		bktnode = NULL;
-		node = NULL;
-		return _END_MNMAP;
-	}
-	else if (map == NULL) {
-	/* If the Mnemonic Map is not provided and there is back record  */
-		if ((node != NULL) && (bktnode != NULL) && (queue != NULL)) {
-			if (node == ((_ds_smap_bucket*)(bktnode->data))->head) {
-					/* Bucket is finished */
-				bktnode = bktnode->next;
-				if (bktnode == NULL)
-					return _END_MNMAP;
-
-				_ds_smap_bucket* bucket = bktnode->data;
-				if (bucket == NULL)
-					return _END_MNMAP;
-
-				if (bucket->size == 0) {
-					bucket = NULL;
-					return _END_MNMAP;
-				}
-
-				node = bucket->head;
-				int i;
-				for (i = 0; i<bucket->size-1; i++) {
-					node = node->next;
-				}
-				
-			} else {
-				node = node->prev;
-				if (node == NULL)
-					return _END_MNMAP;
-			} 
-			
-			return (MnItem*)(node->data);
-		} else {
-			/*  Clean up all the mess  */
-			_ds_free_queue(queue, FALSE);
-			queue = NULL;
-			tptr = NULL;
-			bktnode = NULL;
-			node = NULL;
-			return _END_MNMAP;
-		} 
-	}
-	else if ((tptr == NULL) || (tptr != map)) {
-	/* If the Mnemonic Map is first introduced   */
-		tptr = map;
-		queue = _ds_get_queue();
-		if (queue == NULL)
-			return _END_MNMAP;
-	
-		if (map->hashmap == NULL)
-			return _END_MNMAP;
+	cursor->rank = 0;
+	cursor->item = NULL;
+	if (map != NULL)
+		_ds_smap_rank((_ds_smap*)(map->hashmap));
+}
 
-		_ds_smap* smap = map->hashmap;
-		_ds_smap_bucket* root = smap->root;
+ABool ds_MnMap_next(MnMap* map, MnCursor* cursor) {
+	if ((map == NULL) || (cursor == NULL))
+		return FALSE;
 
-		if (root == NULL)
-			return _END_MNMAP;
+	_ds_smap_entry* entry = _ds_smap_at_rank((_ds_smap*)(map->hashmap), cursor->rank);
+	if (entry == NULL)
+		return FALSE;
 
-		_ds_smap_next_iterator(root, queue);
-		if (_ds_queue_size(queue) == 0) {
-			return _END_MNMAP;
-		}
+	cursor->rank += 1;
+	cursor->item = (MnItem*)(entry->data);
+	return TRUE;
+}
 
-		bktnode = queue->front;
+MnItem* ds_MnMap_get(MnMap* map) {	/* One walk at a time over all maps  */
+	static MnMap* mptr = NULL;
+	static MnCursor cursor;
 
-		if (bktnode == NULL) 
-			return _END_MNMAP;
-	
-		_ds_smap_bucket* bucket = bktnode->data;
-		if (bucket == NULL) 
-			return _END_MNMAP;
+	if (map != NULL) {
+		/* Start with refreshed memory   */
+		mptr = map;
+		ds_MnMap_begin(mptr, &cursor);
+	} else if (mptr == NULL) {
+		/* If Nothing is provided and there is no previous memory   */
+		return _END_MNMAP;
+	}
 
-		
-		if (bucket->size == 0) 
-			return _END_MNMAP;
-		
-		/* If valid case reached finally filterer from above present error handlers  */
-		node = bucket->head;
-		int i;
-		for (i = 0; i<bucket->size-1; i++) {
-			node = node->next;
-		}
+	if (ds_MnMap_next(mptr, &cursor) == FALSE)
+		return _END_MNMAP;
 
-		return (MnItem*)(node->data);
-	}
+	return cursor.item;
 }
 
 MnItem*  ds_MnMap_end() {
 	return _END_MNMAP;
 }
 
-MnMap *ds_new_MnMap() {
+MnMap *ds_new_MnMap(Assembly* assembly) {	/* The items live in the arena of the assembly if one is given  */
+	Arena* arena = (assembly != NULL)? assembly->arena: NULL;
 	MnMap *map = (MnMap*)malloc(sizeof(MnMap));
 
 	if (map == NULL)
 		return NULL;
 
+	map->hashmap = NULL;
+	map->index = NULL;
+	map->arena = arena;
+
 	_ds_smap* smap = _ds_get_smap();
 	if (smap == NULL) {
 		ds_destroy_MnMap(map);
 		return NULL;
 	}
-
 	map->hashmap = (void*)smap;
+
+	_ds_mnemo_index* index = (_ds_mnemo_index*)malloc(sizeof(_ds_mnemo_index));
+	if (index == NULL) {
+		ds_destroy_MnMap(map);
+		return NULL;
+	}
+	index->items = NULL;
+	index->size = 0;
+	index->cap = 0;
+	index->slots = NULL;
+	index->shift = 63;
+	index->multiplier = 1;
+	map->index = (void*)index;
+
 	map->insert = ds_MnMap_insert;
+	map->load = ds_MnMap_load;
 	map->find = ds_MnMap_find;
+	map->match = ds_MnMap_match;
+	map->at = ds_MnMap_at;
 	map->empty = ds_MnMap_empty;
 	map->size = ds_MnMap_size;
+	map->begin = ds_MnMap_begin;
+	map->next = ds_MnMap_next;
 	map->get = ds_MnMap_get;
 	map->end = ds_MnMap_end;
 	map->destroy = ds_destroy_MnMap;
@@ -1862,6 +1883,9 @@ RegItem* ds_new_RegItem(AString key, AAddr encoding) {
 	return ritem;
 }
 
+static void _ds_release_RegItem(RegItem* ritem) {	/* `destroy` of a cursor view, the register stays in its map  */
+}
+
 /**
  * The Functions for Sym 
  * -----------------------------------------*/
@@ -1874,12 +1898,29 @@ AErr ds_RegMap_insert(RegMap* map, AString key, AAddr encoding) {
 		return ERR_MAP_INVALID_STRUCT;
 
 	_ds_smap* smap = (_ds_smap*)(map->hashmap);
-	AAddr* data = (AAddr*)malloc(sizeof(AAddr));
+	AAddr* data = (map->arena != NULL)? (AAddr*)map->arena->alloc(map->arena, sizeof(AAddr)): (AAddr*)malloc(sizeof(AAddr));
 	if (data == NULL)
 		return ERR_MEM_ALLOC_FAIL;
 	
 	*data = encoding;
-	return _ds_smap_insert(smap, key, (void*)data);
+	void* replaced;
+	AErr eno = _ds_smap_insert(smap, key, (void*)data, &replaced);
+	if (map->arena == NULL)
+		free((eno != SUCCESS)? (void*)data: replaced);	/* The value a repeated key had  */
+	return eno;
+}
+
+AErr ds_RegMap_load(RegMap* map, const RegRow* rows, ASize count) {
+	if (rows == NULL)
+		return ERR_DS_INVALID_STRUCT;
+
+	ASize i;
+	for (i = 0; i<count; i++) {
+		AErr eno = ds_RegMap_insert(map, rows[i].key, rows[i].encoding);
+		if (eno != SUCCESS)
+			return eno;
+	}
+	return SUCCESS;
 }
 
 AAddr ds_RegMap_find(RegMap* map, AString key) {
@@ -1890,12 +1931,12 @@ AAddr ds_RegMap_find(RegMap* map, AString key) {
 		return _END_RGMAP;
 
 	_ds_smap *smap = (_ds_smap*)(map->hashmap);
-	_ds_smap_node* node = _ds_smap_find(smap, key);
+	_ds_smap_entry* entry = _ds_smap_find(smap, key);
 
-	if (node == NULL)
+	if (entry == NULL)
 		return _END_RGMAP;
 	
-	AAddr* data = (AAddr*)(node->data);
+	AAddr* data = (AAddr*)(entry->data);
 	return *data;
 }
 
@@ -1926,134 +1967,70 @@ void ds_destroy_RegMap(RegMap* map) {
 
 	if (map->hashmap != NULL) {
 		_ds_smap* smap = (_ds_smap*)(map->hashmap);
-		_ds_free_smap(smap);
+		_ds_free_smap(smap, (map->arena == NULL)? TRUE: FALSE);
 	}
 	
 	free(map);
 	map = NULL;
 }
 
-RegItem* ds_RegMap_get(RegMap* map) {
-	static RegMap* tptr = NULL;
-	static _ds_queue* queue = NULL;
-	static _ds_queue_node* bktnode = NULL;
-	static _ds_smap_node* node = NULL;
-	static RegItem* ritem = NULL;
-	
-	ds_destroy_RegItem(ritem);
-
-	if ((map == NULL) && (tptr == NULL)) {
-	/* If the Symbol Table is not provided and there is no back record   */
-		_ds_free_queue(queue, FALSE);
-		bktnode = NULL;
-		node = NULL;
-		return _END_SYMTB;
-	}
-	else if (map == NULL) {
-	/* If the Symbol Table is not provided and there is back record  */
-		if ((node != NULL) && (bktnode != NULL) && (queue != NULL)) {
-			if (node == ((_ds_smap_bucket*)(bktnode->data))->head) {
-					/* Bucket is finished */
-				bktnode = bktnode->next;
-				if (bktnode == NULL)
-					return _END_SYMTB;
-
-				_ds_smap_bucket* bucket = bktnode->data;
-				if (bucket == NULL)
-					return _END_SYMTB;
-
-				if (bucket->size == 0) {
-					bucket = NULL;
-					return _END_SYMTB;
-				}
-
-				node = bucket->head;
-				int i;
-				for (i = 0; i<bucket->size-1; i++) {
-					node = node->next;
-				}
-				
-			} else {
-				node = node->prev;
-				if (node == NULL)
-					return _END_SYMTB;
-			} 
-			ritem = ds_new_RegItem(node->key, *(AAddr*)node->data);
-			if (ritem == NULL) {
-				_ds_free_queue(queue, FALSE);
-				queue = NULL;
-				return _END_SYMTB;
-			}
-			return ritem;
-		} else {
-			/*  Clean up all the mess  */
-			_ds_free_queue(queue, FALSE);
-			queue = NULL;
-			tptr = NULL;
-			bktnode = NULL;
-			node = NULL;
-			return _END_SYMTB;
-		} 
-	}
-	else if ((tptr == NULL) || (tptr != map)) {
-	/* If the Symbol Table is first introduced   */
-		tptr = map;
-		queue = _ds_get_queue();
-		if (queue == NULL)
-			return _END_SYMTB;
-	
-		if (map->hashmap == NULL)
-			return _END_SYMTB;
+void ds_RegMap_begin(RegMap* map, RegCursor* cursor) {	/* Ranks the map if it changed since the last walk  */
+	if (cursor == NULL)
+		return;
 
-		_ds_smap* smap = map->hashmap;
-		_ds_smap_bucket* root = smap->root;
+	cursor->rank = 0;
+	if (map != NULL)
+		_ds_smap_rank((_ds_smap*)(map->hashmap));
+}
 
-		if (root == NULL)
-			return _END_SYMTB;
+ABool ds_RegMap_next(RegMap* map, RegCursor* cursor) {
+	if ((map == NULL) || (cursor == NULL))
+		return FALSE;
 
-		_ds_smap_next_iterator(root, queue);
-		if (_ds_queue_size(queue) == 0) {
-			return _END_SYMTB;
-		}
+	_ds_smap_entry* entry = _ds_smap_at_rank((_ds_smap*)(map->hashmap), cursor->rank);
+	if (entry == NULL)
+		return FALSE;
 
-		bktnode = queue->front;
+	cursor->rank += 1;
+	cursor->item.key = entry->key;
+	cursor->item.encoding = *(AAddr*)(entry->data);
+	cursor->item.destroy = _ds_release_RegItem;
+	return TRUE;
+}
 
-		if (bktnode == NULL) 
-			return _END_SYMTB;
-	
-		_ds_smap_bucket* bucket = bktnode->data;
-		if (bucket == NULL) 
-			return _END_SYMTB;
+RegItem* ds_RegMap_get(RegMap* map) {	/* One walk at a time over all maps, the item is valid until the next call  */
+	static RegMap* rptr = NULL;
+	static RegCursor cursor;
 
-		
-		if (bucket->size == 0) 
-			return _END_SYMTB;
-		
-		/* If valid case reached finally filterer from above present error handlers  */
-		node = bucket->head;
-		int i;
-		for (i = 0; i<bucket->size-1; i++) {
-			node = node->next;
-		}
+	if (map != NULL) {
+		/* Start with refreshed memory   */
+		rptr = map;
+		ds_RegMap_begin(rptr, &cursor);
+	} else if (rptr == NULL) {
+		/* If Nothing is provided and there is no previous memory   */
+		return _END_RGMAP;
+	}
 
-		ritem = ds_new_RegItem(node->key, *(AAddr*)node->data);
-		if (ritem == NULL)
-			return _END_SYMTB;
+	if (ds_RegMap_next(rptr, &cursor) == FALSE)
+		return _END_RGMAP;
 
-		return ritem;
-	}
+	return &cursor.item;
 }
 
 RegItem*  ds_RegMap_end() {
 	return _END_RGMAP;
 }
 
-RegMap *ds_new_RegMap() {
+RegMap *ds_new_RegMap(Assembly* assembly) {	/* The encodings live in the arena of the assembly if one is given  */
+	Arena* arena = (assembly != NULL)? assembly->arena: NULL;
 	RegMap *map = (RegMap*)malloc(sizeof(RegMap));
 
 	if (map == NULL)
 		return NULL;
 
+	map->hashmap = NULL;
+	map->arena = arena;
+
 	_ds_smap* smap = _ds_get_smap();
 	if (smap == NULL) {
 		ds_destroy_RegMap(map);
@@ -2062,12 +2039,834 @@ RegMap *ds_new_RegMap() {
 
 	map->hashmap = (void*)smap;
 	map->insert = ds_RegMap_insert;
+	map->load = ds_RegMap_load;
 	map->find = ds_RegMap_find;
 	map->empty = ds_RegMap_empty;
 	map->size = ds_RegMap_size;
+	map->begin = ds_RegMap_begin;
+	map->next = ds_RegMap_next;
 	map->get = ds_RegMap_get;
 	map->end = ds_RegMap_end;
 	map->destroy = ds_destroy_RegMap;
 
 	return map;
 }
+
+/**
+ * The Functions for Arena
+ * -----------------------------------------*/
+
+#define _DS_ARENA_ALIGN 16	/* Every block is aligned for any scalar type  */
+
+struct _ds_arena_chunk_struct {
+	struct _ds_arena_chunk_struct* next;
+	ASize size;	/* The usable bytes after the header  */
+	ASize used;	/* The bytes handed out since the last reset  */
+};
+
+typedef struct _ds_arena_chunk_struct _ds_arena_chunk;
+
+#define _DS_ARENA_HEADER (((sizeof(_ds_arena_chunk) + _DS_ARENA_ALIGN - 1)/_DS_ARENA_ALIGN)*_DS_ARENA_ALIGN)
+
+static _ds_arena_chunk* _ds_get_arena_chunk(ASize size) {	/* Function to allocate an arena chunk of `size` usable bytes  */
+	_ds_arena_chunk* chunk = (_ds_arena_chunk*)malloc(_DS_ARENA_HEADER + size);
+	if (chunk == NULL)
+		return NULL;
+
+	chunk->next = NULL;
+	chunk->size = size;
+	chunk->used = 0;
+
+	return chunk;
+}
+
+void* ds_Arena_alloc(Arena* arena, ASize size) {
+	if (arena == NULL)
+		return NULL;
+
+	size = ((size + _DS_ARENA_ALIGN - 1)/_DS_ARENA_ALIGN)*_DS_ARENA_ALIGN;
+
+	/* Chunks after `current` are empty since the last reset, try them before growing  */
+	_ds_arena_chunk* chunk = (_ds_arena_chunk*)arena->current;
+	while (chunk != NULL) {
+		if (chunk->size - chunk->used >= size) {
+			void* block = (char*)chunk + _DS_ARENA_HEADER + chunk->used;
+			chunk->used += size;
+			arena->current = (void*)chunk;
+			return block;
+		}
+		chunk = chunk->next;
+	}
+
+	chunk = _ds_get_arena_chunk((size > arena->chunk_size)? size: arena->chunk_size);
+	if (chunk == NULL)
+		return NULL;
+
+	if (arena->tail == NULL)
+		arena->head = (void*)chunk;
+	else
+		((_ds_arena_chunk*)arena->tail)->next = chunk;
+	arena->tail = (void*)chunk;
+	arena->current = (void*)chunk;
+
+	chunk->used = size;
+	return (char*)chunk + _DS_ARENA_HEADER;
+}
+
+AString ds_Arena_strndup(Arena* arena, const char* string, ASize length) {
+	if (string == NULL)
+		return NULL;
+
+	AString copy = (AString)ds_Arena_alloc(arena, length + 1);
+	if (copy == NULL)
+		return NULL;
+
+	memcpy(copy, string, length);
+	copy[length] = '\0';
+	return copy;
+}
+
+void ds_Arena_reset(Arena* arena) {
+	if (arena == NULL)
+		return;
+
+	_ds_arena_chunk* chunk = (_ds_arena_chunk*)arena->head;
+	while (chunk != NULL) {
+		chunk->used = 0;
+		chunk = chunk->next;
+	}
+	arena->current = arena->head;
+}
+
+void ds_destroy_Arena(Arena* arena) {
+	if (arena == NULL)
+		return;
+
+	_ds_arena_chunk* chunk = (_ds_arena_chunk*)arena->head;
+	while (chunk != NULL) {
+		_ds_arena_chunk* next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+
+	free(arena);
+	arena = NULL;
+}
+
+Arena *ds_new_Arena(ASize chunk_size) {
+	Arena* arena = (Arena*)malloc(sizeof(Arena));
+
+	if (arena == NULL)
+		return NULL;
+
+	arena->head = NULL;
+	arena->tail = NULL;
+	arena->current = NULL;
+	arena->chunk_size = (chunk_size == 0)? 1: chunk_size;
+
+	arena->alloc = ds_Arena_alloc;
+	arena->strndup = ds_Arena_strndup;
+	arena->reset = ds_Arena_reset;
+	arena->destroy = ds_destroy_Arena;
+
+	return arena;
+}
+
+/**
+ * The Functions for Ring
+ * -----------------------------------------*/
+
+/* Each side reads the index of the other with acquire and publishes its own
+ * with release, so a slot is always written before it can be seen as full
+ * and read before it can be seen as free.  */
+
+ABool ds_Ring_push(Ring* ring, void* item) {
+	if (ring == NULL)
+		return FALSE;
+
+	ASize tail = ring->tail;
+	if (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) > ring->mask)
+		return FALSE;
+
+	ring->slots[tail & ring->mask] = item;
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+	return TRUE;
+}
+
+ABool ds_Ring_pop(Ring* ring, void** item) {
+	if ((ring == NULL) || (item == NULL))
+		return FALSE;
+
+	ASize head = ring->head;
+	if (head == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE))
+		return FALSE;
+
+	*item = ring->slots[head & ring->mask];
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+	return TRUE;
+}
+
+ASize ds_Ring_size(Ring* ring) {	/* Only a snapshot while the other side is running  */
+	if (ring == NULL)
+		return 0;
+
+	return __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+}
+
+void ds_destroy_Ring(Ring* ring) {
+	if (ring == NULL)
+		return;
+
+	free(ring->slots);
+	free(ring);
+	ring = NULL;
+}
+
+Ring *ds_new_Ring(ASize capacity) {
+	Ring* ring = (Ring*)malloc(sizeof(Ring));
+
+	if (ring == NULL)
+		return NULL;
+
+	ASize slots = 1;
+	while (slots < capacity)
+		slots <<= 1;
+
+	ring->slots = (void**)malloc(slots*sizeof(void*));
+	if (ring->slots == NULL) {
+		free(ring);
+		return NULL;
+	}
+
+	ring->mask = slots - 1;
+	ring->head = 0;
+	ring->tail = 0;
+
+	ring->push = ds_Ring_push;
+	ring->pop = ds_Ring_pop;
+	ring->size = ds_Ring_size;
+	ring->destroy = ds_destroy_Ring;
+
+	return ring;
+}
+
+/**
+ * The Functions for Interner
+ * -----------------------------------------*/
+
+#define _DS_INTERN_PAGE ((ASize)1 << SZ_DS_INTERN_PAGE_SHIFT)
+
+struct _ds_intern_slot_struct {
+	AAddr hash;	/* The hash of the string, to skip most comparisons  */
+	ASize length;	/* The length of the string, checked before its bytes  */
+	AInt32 id;	/* UNSET_DS_INTERN when the slot is empty  */
+};
+
+typedef struct _ds_intern_slot_struct _ds_intern_slot;
+
+struct _ds_intern_stripe_struct {
+	pthread_mutex_t lock;
+	_ds_intern_slot* slots;	/* Open addressing table, a power of two of slots  */
+	ASize cap;
+	ASize size;
+	Arena* arena;		/* The strings of the stripe  */
+	char _pad[SZ_DS_CACHE_LINE];	/* Keep the locks of neighbouring stripes apart  */
+};
+
+typedef struct _ds_intern_stripe_struct _ds_intern_stripe;
+
+struct _ds_intern_directory_struct {
+	pthread_mutex_t lock;	/* Guards the allocation of pages  */
+	ASize next;						/* The next id, taken atomically  */
+	AString* pages[SZ_DS_INTERN_PAGES];
+};
+
+typedef struct _ds_intern_directory_struct _ds_intern_directory;
+
+static AAddr _ds_intern_hash(const char* string, ASize length) {	/* `djb2` over a span  */
+	AAddr hash = 5381;
+	ASize i;
+	for (i = 0; i<length; i++)
+		hash = ((hash << 5) + hash) + (unsigned char)string[i];
+	return hash;
+}
+
+static ASize _ds_intern_cache_slot(APacked key) {
+	return (ASize)((key*((((APacked)0x9E3779B9 << 32) | 0x7F4A7C15))) >> 56) & (SZ_DS_INTERN_CACHE - 1);
+}
+
+static _ds_intern_slot* _ds_intern_probe(_ds_intern_stripe* stripe, _ds_intern_directory* directory, AAddr hash, const char* string, ASize length) {	/* The slot of the string, or the empty slot it would take  */
+	ASize mask = stripe->cap - 1;
+	ASize i = (hash >> 6) & mask;	/* The low bits chose the stripe  */
+	while (1) {
+		_ds_intern_slot* slot = &stripe->slots[i];
+		if (slot->id == UNSET_DS_INTERN)
+			return slot;
+		if ((slot->hash == hash) && (slot->length == length)) {
+			AString other = directory->pages[slot->id >> SZ_DS_INTERN_PAGE_SHIFT][slot->id & (_DS_INTERN_PAGE - 1)];
+			if (memcmp(other, string, length) == 0)
+				return slot;
+		}
+		i = (i + 1) & mask;
+	}
+}
+
+static AErr _ds_intern_grow(_ds_intern_stripe* stripe, _ds_intern_directory* directory) {	/* Double the table of the stripe  */
+	ASize cap = (stripe->cap == 0)? 64: 2*stripe->cap;
+	_ds_intern_slot* slots = (_ds_intern_slot*)malloc(cap*sizeof(_ds_intern_slot));
+	if (slots == NULL)
+		return ERR_MEM_ALLOC_FAIL;
+
+	ASize i;
+	for (i = 0; i<cap; i++)
+		slots[i].id = UNSET_DS_INTERN;
+
+	_ds_intern_slot* old = stripe->slots;
+	ASize old_cap = stripe->cap;
+	stripe->slots = slots;
+	stripe->cap = cap;
+	for (i = 0; i<old_cap; i++) {
+		if (old[i].id == UNSET_DS_INTERN)
+			continue;
+		ASize j = (old[i].hash >> 6) & (cap - 1);
+		while (slots[j].id != UNSET_DS_INTERN)
+			j = (j + 1) & (cap - 1);
+		slots[j] = old[i];
+	}
+
+	free(old);
+	return SUCCESS;
+}
+
+static AInt32 _ds_intern_new_id(_ds_intern_directory* directory, AString string) {	/* Publish `string` under a fresh id  */
+	ASize id = __atomic_fetch_add(&directory->next, 1, __ATOMIC_RELAXED);
+	ASize page = id >> SZ_DS_INTERN_PAGE_SHIFT;
+	if (page >= SZ_DS_INTERN_PAGES)
+		return UNSET_DS_INTERN;
+
+	if (__atomic_load_n(&directory->pages[page], __ATOMIC_ACQUIRE) == NULL) {
+		pthread_mutex_lock(&directory->lock);
+		if (directory->pages[page] == NULL) {
+			AString* strings = (AString*)calloc(_DS_INTERN_PAGE, sizeof(AString));
+			__atomic_store_n(&directory->pages[page], strings, __ATOMIC_RELEASE);
+		}
+		pthread_mutex_unlock(&directory->lock);
+		if (directory->pages[page] == NULL)
+			return UNSET_DS_INTERN;
+	}
+
+	directory->pages[page][id & (_DS_INTERN_PAGE - 1)] = string;
+	return (AInt32)id;
+}
+
+AInt32 ds_Interner_intern(Interner* interner, InternCache* cache, const char* string, ASize length) {
+	if ((interner == NULL) || (string == NULL))
+		return UNSET_DS_INTERN;
+
+	APacked key = ds_pack_key(string, length);
+	ASize cslot = 0;
+	if ((cache != NULL) && (key != UNSET_DS_PACKED)) {
+		cslot = _ds_intern_cache_slot(key);
+		if (cache->keys[cslot] == key)
+			return cache->ids[cslot];
+	}
+
+	_ds_intern_directory* directory = (_ds_intern_directory*)(interner->directory);
+	AAddr hash = _ds_intern_hash(string, length);
+	_ds_intern_stripe* stripe = &((_ds_intern_stripe*)(interner->stripes))[hash & (SZ_DS_INTERN_STRIPES - 1)];
+
+	AInt32 id = UNSET_DS_INTERN;
+	pthread_mutex_lock(&stripe->lock);
+	if ((2*(stripe->size + 1) <= stripe->cap) || (_ds_intern_grow(stripe, directory) == SUCCESS)) {
+		_ds_intern_slot* slot = _ds_intern_probe(stripe, directory, hash, string, length);
+		if (slot->id != UNSET_DS_INTERN)
+			id = slot->id;
+		else {
+			AString copy = stripe->arena->strndup(stripe->arena, string, length);
+			if (copy != NULL)
+				id = _ds_intern_new_id(directory, copy);
+			if (id != UNSET_DS_INTERN) {
+				slot->hash = hash;
+				slot->length = length;
+				slot->id = id;
+				stripe->size++;
+			}
+		}
+	}
+	pthread_mutex_unlock(&stripe->lock);
+
+	if ((cache != NULL) && (key != UNSET_DS_PACKED) && (id != UNSET_DS_INTERN)) {
+		cache->keys[cslot] = key;
+		cache->ids[cslot] = id;
+	}
+	return id;
+}
+
+AInt32 ds_Interner_lookup(Interner* interner, const char* string, ASize length) {
+	if ((interner == NULL) || (string == NULL))
+		return UNSET_DS_INTERN;
+
+	_ds_intern_directory* directory = (_ds_intern_directory*)(interner->directory);
+	AAddr hash = _ds_intern_hash(string, length);
+	_ds_intern_stripe* stripe = &((_ds_intern_stripe*)(interner->stripes))[hash & (SZ_DS_INTERN_STRIPES - 1)];
+
+	AInt32 id = UNSET_DS_INTERN;
+	pthread_mutex_lock(&stripe->lock);
+	if (stripe->cap != 0)
+		id = _ds_intern_probe(stripe, directory, hash, string, length)->id;
+	pthread_mutex_unlock(&stripe->lock);
+	return id;
+}
+
+AString ds_Interner_string(Interner* interner, AInt32 id) {	/* The id must have been handed out before, by any thread  */
+	if ((interner == NULL) || (id == UNSET_DS_INTERN))
+		return NULL;
+
+	_ds_intern_directory* directory = (_ds_intern_directory*)(interner->directory);
+	if ((ASize)id >= __atomic_load_n(&directory->next, __ATOMIC_RELAXED))
+		return NULL;
+
+	AString* page = __atomic_load_n(&directory->pages[id >> SZ_DS_INTERN_PAGE_SHIFT], __ATOMIC_ACQUIRE);
+	return (page == NULL)? NULL: page[id & (_DS_INTERN_PAGE - 1)];
+}
+
+ASize ds_Interner_size(Interner* interner) {
+	if (interner == NULL)
+		return 0;
+
+	_ds_intern_directory* directory = (_ds_intern_directory*)(interner->directory);
+	ASize size = __atomic_load_n(&directory->next, __ATOMIC_RELAXED);
+	ASize limit = (ASize)SZ_DS_INTERN_PAGES << SZ_DS_INTERN_PAGE_SHIFT;
+	return (size > limit)? limit: size;
+}
+
+void ds_destroy_Interner(Interner* interner) {
+	if (interner == NULL)
+		return;
+
+	ASize i;
+	_ds_intern_stripe* stripes = (_ds_intern_stripe*)(interner->stripes);
+	if (stripes != NULL) {
+		for (i = 0; i<SZ_DS_INTERN_STRIPES; i++) {
+			pthread_mutex_destroy(&stripes[i].lock);
+			free(stripes[i].slots);
+			if (stripes[i].arena != NULL)
+				stripes[i].arena->destroy(stripes[i].arena);
+		}
+		free(stripes);
+	}
+
+	_ds_intern_directory* directory = (_ds_intern_directory*)(interner->directory);
+	if (directory != NULL) {
+		pthread_mutex_destroy(&directory->lock);
+		for (i = 0; i<SZ_DS_INTERN_PAGES; i++)
+			free(directory->pages[i]);
+		free(directory);
+	}
+
+	free(interner);
+	interner = NULL;
+}
+
+Interner *ds_new_Interner() {
+	Interner* interner = (Interner*)malloc(sizeof(Interner));
+
+	if (interner == NULL)
+		return NULL;
+
+	interner->stripes = NULL;
+	interner->directory = NULL;
+	interner->destroy = ds_destroy_Interner;
+
+	_ds_intern_stripe* stripes = (_ds_intern_stripe*)calloc(SZ_DS_INTERN_STRIPES, sizeof(_ds_intern_stripe));
+	if (stripes == NULL) {
+		ds_destroy_Interner(interner);
+		return NULL;
+	}
+	interner->stripes = (void*)stripes;
+
+	ASize i;
+	for (i = 0; i<SZ_DS_INTERN_STRIPES; i++) {
+		pthread_mutex_init(&stripes[i].lock, NULL);
+		stripes[i].arena = ds_new_Arena(SZ_DS_INTERN_CHUNK);
+		if (stripes[i].arena == NULL) {
+			ds_destroy_Interner(interner);
+			return NULL;
+		}
+	}
+
+	_ds_intern_directory* directory = (_ds_intern_directory*)calloc(1, sizeof(_ds_intern_directory));
+	if (directory == NULL) {
+		ds_destroy_Interner(interner);
+		return NULL;
+	}
+	pthread_mutex_init(&directory->lock, NULL);
+	interner->directory = (void*)directory;
+
+	interner->intern = ds_Interner_intern;
+	interner->lookup = ds_Interner_lookup;
+	interner->string = ds_Interner_string;
+	interner->size = ds_Interner_size;
+
+	return interner;
+}
+
+void ds_init_InternCache(InternCache* cache) {
+	if (cache == NULL)
+		return;
+
+	ASize i;
+	for (i = 0; i<SZ_DS_INTERN_CACHE; i++) {
+		cache->keys[i] = UNSET_DS_PACKED;
+		cache->ids[i] = UNSET_DS_INTERN;
+	}
+}
+
+/**
+ * The Functions for Concurrent Symbol Table
+ * -----------------------------------------*/
+
+struct _ds_csym_struct {
+	AAddr address;
+	ASize line;		/* The line of the definition that holds the symbol  */
+	ASize col;
+	ABool defined;
+	ABool constant;	/* Defined by `SET`, the address is its value  */
+};
+
+typedef struct _ds_csym_struct _ds_csym;
+
+struct _ds_csym_def_struct {	/* Where a symbol was defined  */
+	ASize line;
+	ASize col;
+	AInt32 id;
+};
+
+typedef struct _ds_csym_def_struct _ds_csym_def;
+
+struct _ds_csym_stripe_struct {
+	pthread_mutex_t lock;
+	_ds_csym_def* dups;		/* The definitions that lost, in no order  */
+	ASize size;
+	ASize cap;
+	char _pad[SZ_DS_CACHE_LINE];	/* Keep the locks of neighbouring stripes apart  */
+};
+
+typedef struct _ds_csym_stripe_struct _ds_csym_stripe;
+
+struct _ds_csymtab_struct {
+	_ds_csym_stripe stripes[SZ_DS_SYM_STRIPES];
+	pthread_mutex_t lock;	/* Guards the allocation of pages  */
+	_ds_csym* pages[SZ_DS_INTERN_PAGES];	/* The symbols by interned id, a page never moves  */
+	ASize size;				/* The defined symbols, counted atomically  */
+	_ds_csym_def* order;	/* The definitions that won, by line; set by `publish`  */
+	ABool published;
+	Interner* interner;	/* The keys of the ids  */
+};
+
+typedef struct _ds_csymtab_struct _ds_csymtab;
+
+static int _ds_csym_def_cmp(const void* a, const void* b) {	/* By line, then column, then id  */
+	const _ds_csym_def* x = (const _ds_csym_def*)a;
+	const _ds_csym_def* y = (const _ds_csym_def*)b;
+	if (x->line != y->line)
+		return (x->line < y->line)? -1: 1;
+	if (x->col != y->col)
+		return (x->col < y->col)? -1: 1;
+	return (x->id < y->id)? -1: (x->id > y->id);
+}
+
+static _ds_csym* _ds_csymtab_slot(_ds_csymtab* symtab, AInt32 id, ABool create) {	/* The symbol of an id, its page is made on demand  */
+	ASize page = (ASize)id >> SZ_DS_INTERN_PAGE_SHIFT;
+	if (page >= SZ_DS_INTERN_PAGES)
+		return NULL;
+
+	_ds_csym* symbols = __atomic_load_n(&symtab->pages[page], __ATOMIC_ACQUIRE);
+	if ((symbols == NULL) && (create == TRUE)) {
+		pthread_mutex_lock(&symtab->lock);
+		symbols = symtab->pages[page];
+		if (symbols == NULL) {
+			symbols = (_ds_csym*)calloc(_DS_INTERN_PAGE, sizeof(_ds_csym));
+			__atomic_store_n(&symtab->pages[page], symbols, __ATOMIC_RELEASE);
+		}
+		pthread_mutex_unlock(&symtab->lock);
+	}
+
+	return (symbols == NULL)? NULL: &symbols[id & (_DS_INTERN_PAGE - 1)];
+}
+
+static AErr _ds_CSymTable_define(CSymTable* table, AInt32 id, AAddr address, ASize line, ASize col, ABool constant) {
+	if ((table == NULL) || (table->hashmap == NULL) || (id == UNSET_DS_INTERN))
+		return ERR_DS_INVALID_STRUCT;
+
+	_ds_csymtab* symtab = (_ds_csymtab*)(table->hashmap);
+	if (__atomic_load_n(&symtab->published, __ATOMIC_ACQUIRE) == TRUE)
+		return ERR_DS_INSERT_FAIL;
+
+	_ds_csym* symbol = _ds_csymtab_slot(symtab, id, TRUE);
+	if (symbol == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+
+	_ds_csym_stripe* stripe = &symtab->stripes[id & (SZ_DS_SYM_STRIPES - 1)];
+	AErr eno = SUCCESS;
+	pthread_mutex_lock(&stripe->lock);
+	if (symbol->defined == FALSE) {
+		symbol->address = address;
+		symbol->line = line;
+		symbol->col = col;
+		symbol->constant = constant;
+		symbol->defined = TRUE;
+		__atomic_add_fetch(&symtab->size, 1, __ATOMIC_RELAXED);
+	}
+	else {
+		if (stripe->size == stripe->cap) {	/* Room for the loser first, the symbol is left as it was on failure  */
+			ASize cap = (stripe->cap == 0)? 16: 2*stripe->cap;
+			_ds_csym_def* dups = (_ds_csym_def*)realloc(stripe->dups, cap*sizeof(_ds_csym_def));
+			if (dups == NULL) {
+				pthread_mutex_unlock(&stripe->lock);
+				return ERR_MEM_REALLOC_FAIL;
+			}
+			stripe->dups = dups;
+			stripe->cap = cap;
+		}
+
+		_ds_csym_def lost;
+		lost.id = id;
+		lost.line = line;
+		lost.col = col;
+		if ((line < symbol->line) || ((line == symbol->line) && (col < symbol->col))) {
+			/* The earlier line takes the symbol over, whichever thread came first  */
+			lost.line = symbol->line;
+			lost.col = symbol->col;
+			symbol->address = address;
+			symbol->line = line;
+			symbol->col = col;
+			symbol->constant = constant;
+		}
+		else
+			eno = ERR_MAP_DUP_KEY;
+		stripe->dups[stripe->size++] = lost;
+	}
+	pthread_mutex_unlock(&stripe->lock);
+
+	return eno;
+}
+
+AErr ds_CSymTable_define(CSymTable* table, AInt32 id, AAddr address, ASize line, ASize col) {	/* ERR_MAP_DUP_KEY if an earlier line already holds the symbol  */
+	return _ds_CSymTable_define(table, id, address, line, col, FALSE);
+}
+
+AErr ds_CSymTable_defineConst(CSymTable* table, AInt32 id, AAddr value, ASize line, ASize col) {	/* A symbol of `SET`  */
+	return _ds_CSymTable_define(table, id, value, line, col, TRUE);
+}
+
+AAddr ds_CSymTable_findId(CSymTable* table, AInt32 id) {	/* Wait-free once published, under the lock of the stripe before  */
+	if ((table == NULL) || (table->hashmap == NULL))
+		return ERR_MAP_FIND_ADDRESS;
+
+	_ds_csymtab* symtab = (_ds_csymtab*)(table->hashmap);
+	_ds_csym* symbol = _ds_csymtab_slot(symtab, id, FALSE);
+	if (symbol == NULL)
+		return ERR_MAP_FIND_ADDRESS;
+
+	if (__atomic_load_n(&symtab->published, __ATOMIC_ACQUIRE) == TRUE)
+		return (symbol->defined == TRUE)? symbol->address: ERR_MAP_FIND_ADDRESS;
+
+	_ds_csym_stripe* stripe = &symtab->stripes[id & (SZ_DS_SYM_STRIPES - 1)];
+	pthread_mutex_lock(&stripe->lock);
+	AAddr address = (symbol->defined == TRUE)? symbol->address: ERR_MAP_FIND_ADDRESS;
+	pthread_mutex_unlock(&stripe->lock);
+	return address;
+}
+
+AAddr ds_CSymTable_find(CSymTable* table, AString key) {
+	if ((table == NULL) || (key == NULL))
+		return ERR_MAP_FIND_ADDRESS;
+
+	if (table->hashmap == NULL)
+		return ERR_MAP_FIND_ADDRESS;
+
+	Interner* interner = ((_ds_csymtab*)(table->hashmap))->interner;
+	AInt32 id = interner->lookup(interner, key, strlen(key));
+	if (id == UNSET_DS_INTERN)
+		return ERR_MAP_FIND_ADDRESS;
+
+	return ds_CSymTable_findId(table, id);
+}
+
+ASize ds_CSymTable_size(CSymTable* table) {
+	if ((table == NULL) || (table->hashmap == NULL))
+		return 0;
+
+	return __atomic_load_n(&((_ds_csymtab*)(table->hashmap))->size, __ATOMIC_RELAXED);
+}
+
+AErr ds_CSymTable_publish(CSymTable* table, EWList* elist, AErr code) {	/* Once every thread is done; the lost definitions go to the list by line  */
+	if ((table == NULL) || (table->hashmap == NULL))
+		return ERR_DS_INVALID_STRUCT;
+
+	_ds_csymtab* symtab = (_ds_csymtab*)(table->hashmap);
+	if (symtab->published == TRUE)
+		return SUCCESS;
+
+	/* Taking each lock once orders every define before the publish  */
+	ASize i, total = 0;
+	for (i = 0; i<SZ_DS_SYM_STRIPES; i++) {
+		pthread_mutex_lock(&symtab->stripes[i].lock);
+		total += symtab->stripes[i].size;
+		pthread_mutex_unlock(&symtab->stripes[i].lock);
+	}
+
+	_ds_csym_def* dups = (_ds_csym_def*)malloc((total + 1)*sizeof(_ds_csym_def));
+	_ds_csym_def* order = (_ds_csym_def*)malloc((symtab->size + 1)*sizeof(_ds_csym_def));
+	if ((dups == NULL) || (order == NULL)) {
+		free(dups);
+		free(order);
+		return ERR_MEM_ALLOC_FAIL;
+	}
+
+	ASize n = 0;
+	for (i = 0; i<SZ_DS_SYM_STRIPES; i++) {
+		memcpy(dups + n, symtab->stripes[i].dups, symtab->stripes[i].size*sizeof(_ds_csym_def));
+		n += symtab->stripes[i].size;
+	}
+	qsort(dups, total, sizeof(_ds_csym_def), _ds_csym_def_cmp);
+
+	n = 0;
+	for (i = 0; i<SZ_DS_INTERN_PAGES; i++) {
+		_ds_csym* symbols = symtab->pages[i];
+		ASize j;
+		for (j = 0; (symbols != NULL) && (j<_DS_INTERN_PAGE); j++) {
+			if (symbols[j].defined == FALSE)
+				continue;
+			order[n].line = symbols[j].line;
+			order[n].col = symbols[j].col;
+			order[n].id = (AInt32)((i << SZ_DS_INTERN_PAGE_SHIFT) | j);
+			n++;
+		}
+	}
+	qsort(order, n, sizeof(_ds_csym_def), _ds_csym_def_cmp);
+	symtab->order = order;
+	__atomic_store_n(&symtab->published, TRUE, __ATOMIC_RELEASE);
+
+	AErr eno = SUCCESS;
+	for (i = 0; (elist != NULL) && (i<total) && (eno == SUCCESS); i++) {
+		EWItem eitem;
+		eitem.line = dups[i].line;
+		eitem.col = dups[i].col;
+		eitem.code = code;
+		eno = elist->put(elist, &eitem);
+	}
+
+	free(dups);
+	return eno;
+}
+
+AErr ds_CSymTable_copy(CSymTable* table, SymTable* stable) {	/* The symbols by line, as one thread defining them would have inserted  */
+	if ((table == NULL) || (table->hashmap == NULL) || (stable == NULL))
+		return ERR_DS_INVALID_STRUCT;
+
+	_ds_csymtab* symtab = (_ds_csymtab*)(table->hashmap);
+	if (__atomic_load_n(&symtab->published, __ATOMIC_ACQUIRE) == FALSE)
+		return ERR_DS_INVALID_STRUCT;
+
+	ASize i;
+	for (i = 0; i<symtab->size; i++) {
+		_ds_csym* symbol = _ds_csymtab_slot(symtab, symtab->order[i].id, FALSE);
+		AErr eno = (symbol->constant == TRUE)? stable->insertConst(stable, symtab->order[i].id, symbol->address):
+			stable->insertId(stable, symtab->order[i].id, symbol->address);
+		if (eno != SUCCESS)
+			return eno;
+	}
+
+	return SUCCESS;
+}
+
+void ds_destroy_CSymTable(CSymTable* table) {
+	if (table == NULL)
+		return;
+
+	if (table->hashmap != NULL) {
+		_ds_csymtab* symtab = (_ds_csymtab*)(table->hashmap);
+		ASize i;
+		for (i = 0; i<SZ_DS_SYM_STRIPES; i++) {
+			pthread_mutex_destroy(&symtab->stripes[i].lock);
+			free(symtab->stripes[i].dups);
+		}
+		for (i = 0; i<SZ_DS_INTERN_PAGES; i++)
+			free(symtab->pages[i]);
+		pthread_mutex_destroy(&symtab->lock);
+		free(symtab->order);
+		free(symtab);
+	}
+
+	free(table);
+	table = NULL;
+}
+
+CSymTable *ds_new_CSymTable(Assembly* assembly) {	/* The symbols are keyed by the ids of the interner  */
+	if ((assembly == NULL) || (assembly->interner == NULL))
+		return NULL;
+
+	CSymTable* table = (CSymTable*)malloc(sizeof(CSymTable));
+
+	if (table == NULL)
+		return NULL;
+
+	_ds_csymtab* symtab = (_ds_csymtab*)calloc(1, sizeof(_ds_csymtab));
+	if (symtab == NULL) {
+		free(table);
+		return NULL;
+	}
+	symtab->interner = assembly->interner;
+
+	ASize i;
+	for (i = 0; i<SZ_DS_SYM_STRIPES; i++)
+		pthread_mutex_init(&symtab->stripes[i].lock, NULL);
+	pthread_mutex_init(&symtab->lock, NULL);
+
+	table->hashmap = (void*)symtab;
+	table->define = ds_CSymTable_define;
+	table->defineConst = ds_CSymTable_defineConst;
+	table->findId = ds_CSymTable_findId;
+	table->find = ds_CSymTable_find;
+	table->size = ds_CSymTable_size;
+	table->publish = ds_CSymTable_publish;
+	table->copy = ds_CSymTable_copy;
+	table->destroy = ds_destroy_CSymTable;
+
+	return table;
+}
+
+/**
+ * The Functions for Assembly
+ * -----------------------------------------*/
+
+void ds_destroy_Assembly(Assembly* assembly) {	/* Everything carved from the arena or interned goes with it  */
+	if (assembly == NULL)
+		return;
+
+	if (assembly->arena != NULL)
+		assembly->arena->destroy(assembly->arena);
+	if (assembly->interner != NULL)
+		assembly->interner->destroy(assembly->interner);
+	free(assembly);
+	assembly = NULL;
+}
+
+Assembly *ds_new_Assembly(ASize chunk_size) {
+	Assembly* assembly = (Assembly*)malloc(sizeof(Assembly));
+
+	if (assembly == NULL)
+		return NULL;
+
+	assembly->arena = ds_new_Arena(chunk_size);
+	assembly->interner = ds_new_Interner();
+	assembly->destroy = ds_destroy_Assembly;
+	if ((assembly->arena == NULL) || (assembly->interner == NULL)) {
+		ds_destroy_Assembly(assembly);
+		return NULL;
+	}
+
+	return assembly;
+}
@@ -12,33 +12,29 @@ static AErr _dc_insert_error(EWList* elist, ASize line, ASize col, AErr err) {
         return ERR_DS_INVALID_STRUCT;
     }
 
-    EWItem* item = ds_new_EWItem(line, col, err);
-    if (item == NULL) {
-        return ERR_DS_INVALID_STRUCT;
-    }
+    EWItem item;    /* The list copies it into its own storage */
+    item.line = line;
+    item.col = col;
+    item.code = err;
 
-    return elist->insert(elist, item);
+    return elist->put(elist, &item);
 }
 
-static AErr _dc_decode_instruction_handler(IItem* item, AAddr* addr, EWList* elist, MnMap* mnmap, SymTable* stable, AType mode) {
-    if (item == NULL || addr == NULL) {
-        return ERR_DS_INVALID_STRUCT;
-    }
+static MnItem* _dc_mnemonic(IItem* item, MnMap* mnmap) {    /* The mnemonic of an instruction, NULL if it has none */
+    /* Items from the parser carry the mnemonic id, only hand made ones need the lookup */
+    MnItem* mitem = (item->mnemonic != UNSET_DS_MNEMONIC)? mnmap->at(mnmap, item->mnemonic): mnmap->find(mnmap, item->opcode);
+    return (mitem == _END_MNMAP)? NULL: mitem;
+}
 
+static AErr _dc_encode(IItem* item, AAddr* addr, MnMap* mnmap, SymTable* stable) {    /* The machine code of an instruction, nothing is reported */
     AErr eno = SUCCESS;
 
-    if (item->opcode == NULL) {
-        if (mode == DECODER_MODE_BIN)
-            return _dc_insert_error(elist, item->lno, 1, ERR_ASM_INVALID_MNEMONIC);  
+    if (item->opcode == NULL)
         return ERR_STR_INVALID_STRING;
-    }
 
-    MnItem* mitem = mnmap->find(mnmap, item->opcode);
-    if (mitem == _END_MNMAP) {
-        if (mode == DECODER_MODE_BIN)
-            return _dc_insert_error(elist, item->lno, 1, ERR_ASM_INVALID_MNEMONIC);
+    MnItem* mitem = _dc_mnemonic(item, mnmap);
+    if (mitem == NULL)
         return ERR_ASM_INVALID_MNEMONIC;
-    }
     *addr = 0;    
 
     /* In the current format used there can be only 0 or 1 operand */
@@ -47,36 +43,28 @@ static AErr _dc_decode_instruction_handler(IItem* item, AAddr* addr, EWList* eli
         if (operand == NULL)
             return ERR_STR_INVALID_STRING;
         
-        AInt32 value = 0;
-        if (isalpha(*operand)) {
+        /* The parser types the operands, only hand made items need it here */
+        AInt32 value = item->operand_value;
+        AType kind = item->operand_kind;
+        if (kind == UNSET_DS_OPERAND)
+            kind = ds_operand_kind(operand, &value);
+
+        if (kind == TYPE_DS_OPERAND_BAD)
+            return PSR_ERR_FMT_OPRND;   /* Value is not in number form */
+
+        if (kind == TYPE_DS_OPERAND_SYMBOL) {
             /* Check if the operand is a label */
-            AAddr address = stable->find(stable, operand);
-            if (address == ERR_MAP_FIND_ADDRESS) {
-                if (mode == DECODER_MODE_BIN)
-                    _dc_insert_error(elist, item->lno, 1, DEC_ERR_LBL_UNDEF);
+            AAddr address = (item->operand_1_id != UNSET_DS_INTERN)? stable->findId(stable, item->operand_1_id): stable->find(stable, operand);
+            if (address == ERR_MAP_FIND_ADDRESS)
                 return DEC_ERR_LBL_UNDEF;
-            }
-
             value = address;
-            if (mitem->operand_type == TYPE_MNE_OPERAND_OFFSET) {
-                /* The operand is label to jump */
-                value =  value - (AInt32)(item->address);
-                if (value == -1) {
-                    /* Case of Infinite Loop */
-                    if (mode == DECODER_MODE_BIN) {
-                        _dc_insert_error(elist, item->lno, 1, WARN_ASM_INFINITE_LOOP);
-                    }
-                    eno = WARN_ASM_INFINITE_LOOP;
-                }
-            }
-        } else {
-            /*Value is in number form*/
-            value = strtol(operand, NULL, 0);
-            if (value == 0 && (strcmp(operand, "0")!=0)) {
-                if (mode == DECODER_MODE_BIN)
-                    _dc_insert_error(elist, item->lno, 1, PSR_ERR_FMT_OPRND);
-                return PSR_ERR_FMT_OPRND;
-            }
+        }
+
+        if ((kind != TYPE_DS_OPERAND_NUMBER) && (mitem->operand_type == TYPE_MNE_OPERAND_OFFSET)) {
+            /* The operand is label to jump */
+            value =  value - (AInt32)(item->address);
+            if (value == -1)
+                eno = WARN_ASM_INFINITE_LOOP;   /* Case of Infinite Loop */
         }
 
         *addr = value<<8;
@@ -87,6 +75,35 @@ static AErr _dc_decode_instruction_handler(IItem* item, AAddr* addr, EWList* eli
     return eno;
 }
 
+static AErr _dc_report_code(IItem* item, AErr eno) {    /* The code `_dc_report` puts into the error list, SUCCESS for none */
+    if ((item->opcode == NULL) || (eno == ERR_ASM_INVALID_MNEMONIC))
+        return ERR_ASM_INVALID_MNEMONIC;
+    if ((eno == DEC_ERR_LBL_UNDEF) || (eno == PSR_ERR_FMT_OPRND) || (eno == WARN_ASM_INFINITE_LOOP))
+        return eno;
+    return SUCCESS;
+}
+
+static AErr _dc_report(IItem* item, AErr eno, EWList* elist) {    /* Put the outcome of `_dc_encode` into the error list, only the binary pass does it */
+    AErr code = _dc_report_code(item, eno);
+    if (code == ERR_ASM_INVALID_MNEMONIC)
+        return _dc_insert_error(elist, item->lno, 1, code);
+    if (code != SUCCESS)
+        _dc_insert_error(elist, item->lno, 1, code);
+    
+    return eno;
+}
+
+static AErr _dc_decode_instruction_handler(IItem* item, AAddr* addr, EWList* elist, MnMap* mnmap, SymTable* stable, AType mode) {
+    if (item == NULL || addr == NULL) {
+        return ERR_DS_INVALID_STRUCT;
+    }
+
+    AErr eno = _dc_encode(item, addr, mnmap, stable);
+    if (mode == DECODER_MODE_BIN)
+        return _dc_report(item, eno, elist);
+    return eno;
+}
+
 static void word2bytes(AInt32 word, AByte byte_array[]) {
     int i;
     for (i = 0; i<4; i++) {
@@ -106,13 +123,19 @@ static void dump_data_section(DList* dlist, FILE* stream) {
     word2bytes(size, size_byte);
     fwrite(size_byte, sizeof(AByte), sizeof(size_byte), stream);
 
-    DItem* ditem = dlist->get(dlist);
-    while (ditem != NULL) {
-        AInt32 data = ditem->data;
-        AByte word[4];
-        word2bytes(data, word);
-        fwrite(word, sizeof(AByte), sizeof(word), stream);
-        ditem = dlist->get(NULL);
+    /* The words are contiguous: convert a block to big endian and write it at once */
+    AByte block[4*DECODER_DATA_BLOCK];
+    ASize i = 0;
+    while (i < dlist->size(dlist)) {
+        ASize n = dlist->size(dlist) - i;
+        if (n > DECODER_DATA_BLOCK)
+            n = DECODER_DATA_BLOCK;
+
+        ASize j;
+        for (j = 0; j<n; j++)
+            word2bytes(dlist->words[i + j], block + 4*j);
+        fwrite(block, sizeof(AByte), 4*n, stream);
+        i += n;
     }
 }
 
@@ -145,6 +168,9 @@ AErr dc_decode(DecoderInterface* di, FILE* stream) {
     if ((di->dlist == NULL) && (di->ilist == NULL) && (di->mnmap) && (di->stable))
         return ERR_DS_INVALID_STRUCT;
 
+    if (di->elist->exhausted(di->elist) == TRUE)
+        return DEC_ERR_ERR_CAPTD;   /* The parse already spent the error budget */
+
     /* Allocate buffer for instructions */    
     AByte* buffer = (AByte*)malloc(DECODER_IBUF_SIZ);
     if (buffer == NULL)
@@ -154,14 +180,22 @@ AErr dc_decode(DecoderInterface* di, FILE* stream) {
     ASize bytepos =  0;
 
     IList* ilist = di->ilist;
-    IItem* item = ilist->get(ilist);
+    ICursor cursor;
+    ilist->begin(ilist, &cursor);
     AErr err = SUCCESS;
-    while (item != _END_ILIST) {
-        AAddr addr;
-        err = _dc_decode_instruction_handler(item, &addr, di->elist, di->mnmap, di->stable, DECODER_MODE_BIN);
+    while (ilist->next(ilist, &cursor)) {
+        AAddr addr = 0;
+        AErr eno = _dc_encode(&cursor.item, &addr, di->mnmap, di->stable);
+        ilist->record(ilist, &cursor, addr, eno);   /* The listing reads it back instead of decoding again */
         
         if (is_error(err))
-            break;
+            continue;   /* Past the first error only the listing needs the rows */
+
+        err = _dc_report(&cursor.item, eno, di->elist);
+        if (is_error(err) && (di->elist->exhausted(di->elist) == TRUE))
+            break;      /* Out of budget, skip the rows kept only for the listing */
+        if (is_error(err))
+            continue;
 
         word2bytes(addr, buffer+bytepos);
         bytepos+=4;
@@ -174,8 +208,6 @@ AErr dc_decode(DecoderInterface* di, FILE* stream) {
             }
             cursize+=DECODER_IBUF_SIZ;
         }
-
-        item = ilist->get(NULL);
     }
     
     if (is_error(err)) {
@@ -197,6 +229,12 @@ AErr dc_decode(DecoderInterface* di, FILE* stream) {
 AErr dc_decode_instruction(DecoderInterface* di, IItem* item, AAddr* addr, AType mode) {
     if (item == NULL || addr == NULL || di == NULL)
         return ERR_DS_INVALID_STRUCT;
+
+    if ((mode == DECODER_MODE_ALF) && (item->status != UNSET_DS_STATUS)) {
+        /* Already encoded by `dc_decode` */
+        *addr = item->code;
+        return item->status;
+    }
     
     return _dc_decode_instruction_handler(item, addr, di->elist, di->mnmap, di->stable, mode);
 }
@@ -225,3 +263,230 @@ DecoderInterface* dc_new_DecoderInterface(IList* ilist, SymTable* stable, DList*
     di->destroy = dc_destroy;
     return di;
 }
+
+
+/**
+ * Functions for Single Pass Encoder
+ * ---------------------------------*/
+
+#define _DC_FIXUP_NONE ((ASize)-1)  /* End of a fixup chain */
+
+static AErr _dc_sp_issue(SinglePass* sp, ASize row, ASize lno, AErr code, AErr status) {
+    if (sp->n_issues == sp->cap_issues) {
+        ASize cap = (sp->cap_issues == 0)? DECODER_IBUF_SIZ: 2*sp->cap_issues;
+        DcIssue* issues = (DcIssue*)realloc(sp->issues, cap*sizeof(DcIssue));
+        if (issues == NULL)
+            return ERR_MEM_REALLOC_FAIL;
+        sp->issues = issues;
+        sp->cap_issues = cap;
+    }
+
+    DcIssue* issue = &sp->issues[sp->n_issues++];
+    issue->row = row;
+    issue->lno = lno;
+    issue->code = code;
+    issue->status = status;
+    return SUCCESS;
+}
+
+static AErr _dc_sp_fixup(SinglePass* sp, IItem* item, MnItem* mitem, ASize row) {   /* Chain the instruction on the symbol of its operand */
+    ASize id = (ASize)item->operand_1_id;
+    if (id >= sp->n_heads) {
+        ASize n = (sp->n_heads == 0)? DECODER_IBUF_SIZ: sp->n_heads;
+        while (n <= id)
+            n *= 2;
+        ASize* heads = (ASize*)realloc(sp->heads, n*sizeof(ASize));
+        if (heads == NULL)
+            return ERR_MEM_REALLOC_FAIL;
+        ASize i;
+        for (i = sp->n_heads; i<n; i++)
+            heads[i] = _DC_FIXUP_NONE;
+        sp->heads = heads;
+        sp->n_heads = n;
+    }
+
+    if (sp->n_fixups == sp->cap_fixups) {
+        ASize cap = (sp->cap_fixups == 0)? DECODER_IBUF_SIZ: 2*sp->cap_fixups;
+        DcFixup* fixups = (DcFixup*)realloc(sp->fixups, cap*sizeof(DcFixup));
+        if (fixups == NULL)
+            return ERR_MEM_REALLOC_FAIL;
+        sp->fixups = fixups;
+        sp->cap_fixups = cap;
+    }
+
+    DcFixup* fixup = &sp->fixups[sp->n_fixups];
+    fixup->row = row;
+    fixup->lno = item->lno;
+    fixup->address = item->address;
+    fixup->encoding = mitem->encoding;
+    fixup->operand_type = mitem->operand_type;
+    fixup->next = sp->heads[id];
+    fixup->pending = TRUE;
+    sp->heads[id] = sp->n_fixups++;
+    return SUCCESS;
+}
+
+AErr dc_SinglePass_emit(SinglePass* sp, IItem* item) {
+    if ((sp == NULL) || (item == NULL))
+        return ERR_DS_INVALID_STRUCT;
+
+    if (sp->bytepos == sp->cursize) {
+        AByte* buffer = (AByte*)realloc(sp->buffer, sp->cursize + DECODER_IBUF_SIZ);
+        if (buffer == NULL)
+            return ERR_MEM_REALLOC_FAIL;
+        sp->buffer = buffer;
+        sp->cursize += DECODER_IBUF_SIZ;
+    }
+
+    ASize row = sp->bytepos/4;
+    AAddr addr = 0;
+    AErr err = SUCCESS;
+    AErr eno = _dc_encode(item, &addr, sp->mnmap, sp->stable);
+    if ((eno == DEC_ERR_LBL_UNDEF) && (item->operand_1_id != UNSET_DS_INTERN)) {
+        /* Forward reference, the word is written again by `define`; the mnemonic was found by the encode */
+        eno = _dc_sp_fixup(sp, item, _dc_mnemonic(item, sp->mnmap), row);
+        if (eno != SUCCESS)
+            return eno;
+    }
+    else {
+        AErr code = _dc_report_code(item, eno);
+        AErr status = (code == ERR_ASM_INVALID_MNEMONIC)? SUCCESS: eno;
+        if ((code != SUCCESS) || is_error(status))
+            err = _dc_sp_issue(sp, row, item->lno, code, status);
+    }
+
+    word2bytes(addr, sp->buffer + sp->bytepos);
+    sp->bytepos += 4;
+    return err;     /* The word is written even if its issue could not be kept */
+}
+
+AErr dc_SinglePass_define(SinglePass* sp, AInt32 id) {
+    if (sp == NULL)
+        return ERR_DS_INVALID_STRUCT;
+    if ((id < 0) || ((ASize)id >= sp->n_heads))
+        return SUCCESS;     /* Nothing is waiting on it */
+
+    AAddr address = sp->stable->findId(sp->stable, id);
+    if (address == ERR_MAP_FIND_ADDRESS)
+        return SUCCESS;
+
+    AErr err = SUCCESS;
+    ASize i = sp->heads[id];
+    sp->heads[id] = _DC_FIXUP_NONE;
+    while (i != _DC_FIXUP_NONE) {
+        DcFixup* fixup = &sp->fixups[i];
+
+        /* Same as `_dc_encode` for a symbol operand */
+        AInt32 value = address;
+        if (fixup->operand_type == TYPE_MNE_OPERAND_OFFSET) {
+            value = value - (AInt32)(fixup->address);
+            if ((value == -1) && (_dc_sp_issue(sp, fixup->row, fixup->lno, WARN_ASM_INFINITE_LOOP, WARN_ASM_INFINITE_LOOP) != SUCCESS))
+                err = ERR_MEM_REALLOC_FAIL;     /* The rest of the chain is still written */
+        }
+        word2bytes((value<<8) | fixup->encoding, sp->buffer + 4*fixup->row);
+
+        fixup->pending = FALSE;
+        i = fixup->next;
+    }
+    return err;
+}
+
+static int _dc_sp_issue_cmp(const void* a, const void* b) {
+    ASize ra = ((const DcIssue*)a)->row;
+    ASize rb = ((const DcIssue*)b)->row;
+    return (ra < rb)? -1: (ra > rb);
+}
+
+AErr dc_SinglePass_finish(SinglePass* sp, FILE* stream) {
+    if ((sp == NULL) || (stream == NULL))
+        return ERR_DS_INVALID_STRUCT;
+
+    if (sp->elist->exhausted(sp->elist) == TRUE)
+        return DEC_ERR_ERR_CAPTD;   /* The parse already spent the error budget */
+
+    ASize i;
+    for (i = 0; i<sp->n_fixups; i++) {
+        if ((sp->fixups[i].pending == TRUE) &&
+            (_dc_sp_issue(sp, sp->fixups[i].row, sp->fixups[i].lno, DEC_ERR_LBL_UNDEF, DEC_ERR_LBL_UNDEF) != SUCCESS))
+            return ERR_MEM_REALLOC_FAIL;
+    }
+
+    /* Report in row order up to the first error, as `dc_decode` does */
+    if (sp->n_issues != 0)
+        qsort(sp->issues, sp->n_issues, sizeof(DcIssue), _dc_sp_issue_cmp);
+    for (i = 0; i<sp->n_issues; i++) {
+        DcIssue* issue = &sp->issues[i];
+        if (issue->code != SUCCESS)
+            _dc_insert_error(sp->elist, issue->lno, 1, issue->code);
+        if (is_error(issue->status))
+            return DEC_ERR_ERR_CAPTD;
+    }
+
+    if (sp->dlist->size(sp->dlist) != 0) {
+        write_header(stream, TRUE);
+        dump_data_section(sp->dlist, stream);
+    } else
+        write_header(stream, FALSE);
+    dump_text_section(sp->buffer, sp->bytepos, stream);
+
+    return SUCCESS;
+}
+
+void dc_destroy_SinglePass(SinglePass* sp) {
+    if (sp == NULL)
+        return;
+
+    free(sp->buffer);
+    free(sp->fixups);
+    free(sp->heads);
+    free(sp->issues);
+    free(sp);
+}
+
+static AErr _dc_sp_sink_emit(void* target, IItem* item) {
+    return dc_SinglePass_emit((SinglePass*)target, item);
+}
+
+static AErr _dc_sp_sink_define(void* target, AInt32 id) {
+    return dc_SinglePass_define((SinglePass*)target, id);
+}
+
+SinglePass* dc_new_SinglePass(SymTable* stable, DList* dlist, MnMap* mnmap, EWList* elist) {
+    if ((stable == NULL) || (dlist == NULL) || (mnmap == NULL) || (elist == NULL))
+        return NULL;
+
+    SinglePass* sp = (SinglePass*)malloc(sizeof(SinglePass));
+    if (sp == NULL)
+        return NULL;
+
+    sp->buffer = (AByte*)malloc(DECODER_IBUF_SIZ);
+    if (sp->buffer == NULL) {
+        free(sp);
+        return NULL;
+    }
+    sp->bytepos = 0;
+    sp->cursize = DECODER_IBUF_SIZ;
+
+    sp->stable = stable;
+    sp->dlist = dlist;
+    sp->mnmap = mnmap;
+    sp->elist = elist;
+    sp->sink.target = sp;
+    sp->sink.emit = _dc_sp_sink_emit;
+    sp->sink.define = _dc_sp_sink_define;
+
+    sp->fixups = NULL;
+    sp->n_fixups = 0;
+    sp->cap_fixups = 0;
+    sp->heads = NULL;
+    sp->n_heads = 0;
+    sp->issues = NULL;
+    sp->n_issues = 0;
+    sp->cap_issues = 0;
+
+    sp->emit = dc_SinglePass_emit;
+    sp->define = dc_SinglePass_define;
+    sp->finish = dc_SinglePass_finish;
+    sp->destroy = dc_destroy_SinglePass;
+    return sp;
+}
@@ -0,0 +1,50 @@
+/******************************************************
+ *	Instruction Set
+ *
+ *	Each include of the definition file expands its
+ *	rows with the macros set right before it; the
+ *	macro of the other kind of row expands to nothing.
+ ******************************************************/
+
+#include <isa.h>
+#include <err_codes.h>
+
+static const MnRow _isa_mnemonics[] = {
+#define ISA_MNEMONIC(name, opcode, operands, type) {#name, opcode, operands, TYPE_MNE_OPERAND_##type},
+#define ISA_REGISTER(name, encoding)
+#include ISA_DEFINITION
+#undef ISA_MNEMONIC
+#undef ISA_REGISTER
+};
+
+static const RegRow _isa_registers[] = {
+#define ISA_MNEMONIC(name, opcode, operands, type)
+#define ISA_REGISTER(name, encoding) {"$" #name, encoding},
+#include ISA_DEFINITION
+#undef ISA_MNEMONIC
+#undef ISA_REGISTER
+};
+
+#define _ISA_COUNT(table) (sizeof(table)/sizeof(table[0]))
+
+ASize isa_mnemonics(void) {
+	return _ISA_COUNT(_isa_mnemonics);
+}
+
+ASize isa_registers(void) {
+	return _ISA_COUNT(_isa_registers);
+}
+
+AErr isa_load_MnMap(MnMap* map) {
+	if (map == NULL)
+		return ERR_DS_INVALID_STRUCT;
+
+	return map->load(map, _isa_mnemonics, _ISA_COUNT(_isa_mnemonics));
+}
+
+AErr isa_load_RegMap(RegMap* map) {
+	if (map == NULL)
+		return ERR_DS_INVALID_STRUCT;
+
+	return map->load(map, _isa_registers, _ISA_COUNT(_isa_registers));
+}
@@ -21,6 +21,8 @@ PEDesc parser_error_description[] = {
 	{PSR_ERR_INV_LABEL, "Invalid Label"},
 	{PSR_ERR_DUP_LABEL, "Duplicate Label"},
 	{PSR_ERR_INV_JRTYP, "Invalid Jar Type"},
+	{PSR_ERR_INV_MACRO, "Invalid Macro"},
+	{PSR_ERR_INV_COND, "Invalid Conditional"},
     {DEC_ERR_LBL_UNDEF, "Undefined Label"},
     {DEC_ERR_INV_OPRND, "Invalid Operand"},
     {DEC_ERR_INV_OFFST, "Invalid Offset"},
@@ -162,9 +164,11 @@ AErr lg_log(LoggerInterface* li, AType level) {
         return ERR_LOG_FAIL;
 
     EWList* elist = li->elist;
-    EWItem* item = li->elist->get(li->elist);
+    EWCursor cursor;
+    elist->begin(elist, &cursor);
 
-    while (item != NULL) {
+    while (elist->next(elist, &cursor)) {
+        EWItem* item = cursor.item;
         if (item->code >= level) {
             /* Print error in red, warning in magenta, info in yellow and debug in white*/
             if (is_error(item->code) == TRUE)
@@ -179,7 +183,6 @@ AErr lg_log(LoggerInterface* li, AType level) {
                 fprintf(li->stream1, "%sUnknown%s line%d:%d\n", reset, reset, item->line, item->col);   
             fprintf(li->stream1, "%s%s%s\n", err_msg, get_parser_error_description(item->code), reset);
         }
-        item = li->elist->get(NULL);
     }
 
 
@@ -202,12 +205,13 @@ AErr lg_log_mnemonic(LoggerInterface* li) {
     if (map == NULL)
         return ERR_INVALID_INTERFACE;
 
-    MnItem* item = map->get(map);
+    MnCursor cursor;
+    map->begin(map, &cursor);
 
     fprintf(li->stream1, "\n%-*s %-*s %-*s\n-------------------------------\n", 10, "Mnemonic", 10, "Operands", 10, "Opcode");
-    while (item != map->end()) {
+    while (map->next(map, &cursor)) {
+        MnItem* item = cursor.item;
         fprintf(li->stream1, "%-*s %-*d %s%04X%s\n", 10, item->key, 10, item->n_operand, green, item->encoding, reset);
-        item = map->get(NULL);
     }
     printf("\n");
     return SUCCESS;
@@ -222,10 +226,10 @@ AErr lg_log_register(LoggerInterface* li) {
 
     printf("\n%-*s %-*s\n--------------------\n", 10, "Register", 10, "Address");
     RegMap* map = li->rmap;
-    RegItem* item = map->get(map);
-    while (item != NULL) {
-        printf("%-*s %s%04X%s\n",  10, item->key, magenta, item->encoding, reset);
-        item = map->get(NULL);
+    RegCursor cursor;
+    map->begin(map, &cursor);
+    while (map->next(map, &cursor)) {
+        printf("%-*s %s%04X%s\n",  10, cursor.item.key, magenta, cursor.item.encoding, reset);
     }
 
     printf("\n");
@@ -238,10 +242,10 @@ static AErr _lg_dump_symbol_table(SymTable* stable, FILE* file) {
     
     fprintf(file, "\nSymbol Table\n------------------------------\n");
     fprintf(file, "%-*s %-*s\n------------------------------\n", 10, "Label", 10, "Address");
-    SymItem* sitem = stable->get(stable);
-    while (sitem != stable->end()) {
-        fprintf(file, "%-*s %08X\n", 10, sitem->key, sitem->address);
-        sitem = stable->get(NULL);
+    SymCursor cursor;
+    stable->begin(stable, &cursor);
+    while (stable->next(stable, &cursor)) {
+        fprintf(file, "%-*s %08X\n", 10, cursor.item.key, cursor.item.address);
     }
 
     return SUCCESS;
@@ -251,15 +255,16 @@ static AErr _lg_dump_ewlist(EWList* elist, FILE* file) {
     if (elist == NULL || file == NULL)
         return ERR_INVALID_INTERFACE;
 
-    EWItem* eitem = elist->get(elist);
+    EWCursor cursor;
+    elist->begin(elist, &cursor);
     fprintf(file, "\nError/Warning List\n--------------------------------------------------\n");
     fprintf(file, "%-*s %-*s %-*s %-*s %-*s\n", 6, "Flag", 4, "Line", 4, "Col", 6, "Code", 32, "Description");
     fprintf(file, "--------------------------------------------------\n");
-    while (eitem != elist->end()) {
+    while (elist->next(elist, &cursor)) {
+        EWItem* eitem = cursor.item;
         AString flag = (is_error(eitem->code) == TRUE)? "ERROR": "WARN";
         AString desc = get_parser_error_description(eitem->code);
         fprintf(file, "%-*s %-*d %-*d %04X\t%-*s\n", 6, flag, 4, eitem->line, 4, eitem->col, eitem->code, 32, desc);
-        eitem = elist->get(NULL);
     }
     return SUCCESS;
 }
@@ -268,12 +273,12 @@ static AErr _lg_dump_dlist(DList* dlist, FILE* file) {
     if (dlist == NULL || file == NULL)
         return ERR_INVALID_INTERFACE;
 
-    DItem* ditem = dlist->get(dlist);
+    DCursor cursor;
+    dlist->begin(dlist, &cursor);
     fprintf(file, "\nMemory Map\n----------------------------------------\n");
     fprintf(file, "%-*s %-*s\n----------------------------------------\n", 10, "Offset", 10, "Data");
-    while (ditem != dlist->end()) {
-        fprintf(file, "%08X\t%d\n", ditem->address, ditem->data);
-        ditem = dlist->get(NULL);
+    while (dlist->next(dlist, &cursor)) {
+        fprintf(file, "%08X\t%d\n", cursor.item.address, cursor.item.data);
     }
     return SUCCESS;
 }
@@ -290,8 +295,10 @@ AErr lg_generate_alf(LoggerInterface* li, DecoderInterface* di, FILE* file) {
     fprintf(file, "Instruction Table\n-----------------------------------------------------------------------------\n");
     fprintf(file, "%-*s %-*s %-*s %-*s %-*s %-*s\n", 10, "Address", 10, "Line", 10, "Opcode", 10, "Operand", 10, "Machine-Code", 15, "Decoder-Status");
     fprintf(file, "-----------------------------------------------------------------------------\n");
-    IItem* item = li->ilist->get(li->ilist);
-    while (item != li->ilist->end()) {
+    ICursor cursor;
+    li->ilist->begin(li->ilist, &cursor);
+    while (li->ilist->next(li->ilist, &cursor)) {
+        IItem* item = &cursor.item;
         AAddr address = item->address;
         ASize line = item->lno;
         ASize n_op = item->n_op;
@@ -310,7 +317,6 @@ AErr lg_generate_alf(LoggerInterface* li, DecoderInterface* di, FILE* file) {
                 status = "WARN";
         }
         fprintf(file, "%-*d %-*d %-*s %-*s %08X\t\t%-*s\n", 10, address, 10, line, 10, opcode, 10, operand1, machine_code, 10, status);
-        item = li->ilist->get(NULL);
     }
 
     AErr eno = _lg_dump_symbol_table(li->stable, file);
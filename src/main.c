@@ -4,39 +4,37 @@
 #include <decoder/decoder.h>
 #include <logger/logger.h>
 #include <common_ds.h>
+#include <isa.h>
 #include <common_types.h>
 #include <err_codes.h>
 
 /* Functions declaration  */
 AErr execute_argument();
-void handle_error_and_execute_argument(int error_code);
+int handle_error_and_execute_argument(int error_code);
 
 static Args parsed_args = {0};
 
 /* Assembler entry point  */
 int main(int argc, char **argv) {
-    handle_error_and_execute_argument(parse_arguments(argc, argv, &parsed_args));
-    return 0;
+    return handle_error_and_execute_argument(parse_arguments(argc, argv, &parsed_args));
 }
 
 /*  To-do: Verbosity and better error representation  */
 
-void handle_error_and_execute_argument(int error_code) {
+int handle_error_and_execute_argument(int error_code) {	/* The exit status: non-zero when the job failed or reported errors  */
     switch (error_code) {
         case _ARG_PF:
             printf("Argument parsing failed\n");
             break;
         case _ARG_SP:
             /* parsing succesful  */
-            execute_argument();
-            break;
+            return (execute_argument() == SUCCESS)? 0: 1;
         case _ARG_ATTR_HD:
             /* help is displayed in this case  */
             printf("Help is displayed.\n");
             break;
 		case _ARG_ATTR_MNE:
-			execute_argument();
-			break;
+			return (execute_argument() == SUCCESS)? 0: 1;
         case _ARG_ATTR_RNM:
             printf("Argument requirement not met.\n");
             break;
@@ -52,83 +50,36 @@ void handle_error_and_execute_argument(int error_code) {
         case _ARG_ATTR_ALF:
             printf("Missing file. Usage -a <filename> or --alf <filename>\n");
             break;
+        case _ARG_ATTR_MXE:
+            printf("Missing count. Usage -e <count> or --max-errors <count>\n");
+            break;
         default:
             break;
     }
+    return 0;
 }
 
-typedef struct {
-    AString mnemonic;
-    AAddr encoding;
-    ASize n_operand;
-    AType operand_type;
-} Rule;
-
-typedef struct {
-    AString key;
-    AAddr encoding;
-} Register;
-
 AErr execute_argument() {
     char *input_file = parsed_args.input_filename;
     char *output_file = (parsed_args.output == 1)? parsed_args.output_filename: "machine.bin";
     char *alf_file = (parsed_args.alf == 1)? parsed_args.alf_filename: NULL;
     
 
-    IList* ilist = ds_new_IList();
-    DList* dlist = ds_new_DList();
-    SymTable* stable = ds_new_SymTable();
-    MnMap* map = ds_new_MnMap();
-    EWList* elist = ds_new_EWList();
-    RegMap* regmap = ds_new_RegMap();
-    
-    /* Add Instuctions  */
-    Rule rules[19] = {
-        {"ldc", 0, 1, TYPE_MNE_OPERAND_VALUE},
-        {"adc", 1, 1, TYPE_MNE_OPERAND_VALUE},
-        {"ldl", 2, 1, TYPE_MNE_OPERAND_VALUE},
-        {"stl", 3, 1, TYPE_MNE_OPERAND_VALUE},
-        {"ldnl", 4, 1, TYPE_MNE_OPERAND_VALUE},
-        {"stnl", 5, 1, TYPE_MNE_OPERAND_VALUE},
-        {"add", 6, 0, TYPE_MNE_OPERAND_NONE},
-        {"sub", 7, 0, TYPE_MNE_OPERAND_NONE},
-        {"shl", 8, 0, TYPE_MNE_OPERAND_NONE},
-        {"shr", 9, 0, TYPE_MNE_OPERAND_NONE},
-        {"adj", 10, 1, TYPE_MNE_OPERAND_VALUE},
-        {"a2sp", 11, 0, TYPE_MNE_OPERAND_NONE},
-        {"sp2a", 12, 0, TYPE_MNE_OPERAND_NONE},
-        {"call", 13, 1, TYPE_MNE_OPERAND_OFFSET},
-        {"return", 14, 0, TYPE_MNE_OPERAND_NONE},
-        {"brz", 15, 1, TYPE_MNE_OPERAND_OFFSET},
-        {"brlz", 16, 1, TYPE_MNE_OPERAND_OFFSET},
-        {"br", 17, 1, TYPE_MNE_OPERAND_OFFSET},
-        {"HALT", 18, 0}
-    };
-
-	Register registers[10] = {
-        {"$s0", 0},
-        {"$s1", 1},
-        {"$s2", 2},
-        {"$s3", 3},
-        {"$s4", 4},
-        {"$s5", 5},
-        {"$s6", 6},
-        {"$s7", 7},
-        {"$s8", 8},
-        {"$s9", 9},
-    };
-
-
-	AInt j;
-    for (j = 0; j<19; j++) {
-        if (map->insert(map, rules[j].mnemonic, rules[j].encoding, rules[j].n_operand, rules[j].operand_type) != SUCCESS)
-            return ERR_MAIN_EXECUTION;
-    }
+    /* The small items and the identifiers of the job, freed with it at the end  */
+    Assembly* assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    if (assembly == NULL)
+        return ERR_MAIN_EXECUTION;
 
-    for (j = 0; j<10; j++) {
-        if (regmap->insert(regmap, registers[j].key, registers[j].encoding) != SUCCESS)
+    IList* ilist = ds_new_IList(assembly);
+    DList* dlist = ds_new_DList(assembly);
+    SymTable* stable = ds_new_SymTable(assembly);
+    MnMap* map = ds_new_MnMap(assembly);
+    EWList* elist = ds_new_EWList(assembly);
+    RegMap* regmap = ds_new_RegMap(assembly);
+    
+    /* The instruction set comes from static tables  */
+    if ((isa_load_MnMap(map) != SUCCESS) || (isa_load_RegMap(regmap) != SUCCESS))
         return ERR_MAIN_EXECUTION;
-    }
 	
 	LoggerInterface* li = lg_new_LoggerInterface(stdout, stdout, 0, elist, ilist, stable, dlist, map, regmap);
 	if (li == NULL)
@@ -140,17 +91,20 @@ AErr execute_argument() {
 	}
 
   FILE* file_input = fopen(input_file, "r");
-  FILE* file_output = fopen(output_file, "w");
   FILE* file_alf = fopen(alf_file, "w");
 
 	if (parsed_args.input == 1 && file_input == NULL)
 		return ERR_MAIN_EXECUTION;
-	if (parsed_args.output == 1 && file_output == NULL)
-		return ERR_MAIN_EXECUTION;
 	if (parsed_args.alf == 1 && file_alf == NULL)
 		return ERR_MAIN_EXECUTION;
 
-	ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file_input);
+	/* Every stage stops once the list holds this many errors  */
+	if (parsed_args.fail_fast == 1)
+		elist->budget = 1;
+	else if (parsed_args.max_errors == 1)
+		elist->budget = parsed_args.max_errors_count;
+
+	ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file_input, assembly);
     if (pi == NULL)
         return ERR_MAIN_EXECUTION;
 
@@ -158,29 +112,64 @@ AErr execute_argument() {
     if (di == NULL)
         return ERR_MAIN_EXECUTION;
 
+	/* The listing needs the instruction list, so `alf` keeps both passes  */
+	SinglePass* sp = NULL;
+	if ((parsed_args.single_pass == 1) && (parsed_args.alf == 0)) {
+		sp = dc_new_SinglePass(stable, dlist, map, elist);
+		if (sp == NULL)
+			return ERR_MAIN_EXECUTION;
+		pi->sink = &sp->sink;
+	}
+
 	if (pi->parse(pi, file_input) != SUCCESS)
 		return ERR_MAIN_EXECUTION;
 	
-	AErr err = di->decode(di, file_output);
+	/* A run that gave up makes no output file  */
+	FILE* file_output = NULL;
+	AErr err = DEC_ERR_ERR_CAPTD;
+	if (elist->exhausted(elist) == FALSE) {
+		file_output = fopen(output_file, "w");
+		if (file_output == NULL)
+			return ERR_MAIN_EXECUTION;
+		err = (sp != NULL)? sp->finish(sp, file_output): di->decode(di, file_output);
+	}
 
 	li->log(li, 0);
 
+	if (elist->budget != SZ_DS_EW_UNLIMITED) {
+		AString stop = (elist->exhausted(elist) == TRUE)? ", stopped at the limit": "";
+		printf("%lu error(s), %lu warning(s)%s\n", elist->errors, elist->size(elist) - elist->errors, stop);
+	}
+
 	if (parsed_args.alf == 1)
 		li->generate_alf(li, di, file_alf);
 
-  if (err != SUCCESS)
-      return ERR_MAIN_EXECUTION;
+	/* Any error fails the job, and its output is not kept  */
+	AErr status = ((err != SUCCESS) || (elist->errors != 0))? ERR_MAIN_EXECUTION: SUCCESS;
 
 	if (file_input)
 		fclose(file_input);
-	if (file_output)
+	if (file_output) {
 		fclose(file_output);
+		if (status != SUCCESS)
+			remove(output_file);
+	}
 	if (file_alf)	
 		fclose(file_alf);
 
 	pi->destroy(pi);
 	di->destroy(di);
 	li->destroy(li);
-
-	return SUCCESS;
+	if (sp != NULL)
+		sp->destroy(sp);
+
+	ilist->destroy(ilist);
+	dlist->destroy(dlist);
+	stable->destroy(stable);
+	map->destroy(map);
+	elist->destroy(elist);
+	regmap->destroy(regmap);
+	assembly->destroy(assembly);
+
+	return status;
 }
@@ -16,10 +16,19 @@
 
 
 #include <parser/parser.h>
+#include <sched.h>
+#include <unistd.h>
 
 /**
  * Function for Jar Classifier 
  * ---------------------------------*/
+
+/* The directives compared against the packed Token content  */
+#define _PSR_KEY_SET		DS_PACK('S', 'E', 'T', 0, 0, 0, 0, 0)
+#define _PSR_KEY_DATA		DS_PACK('d', 'a', 't', 'a', 0, 0, 0, 0)
+#define _PSR_KEY_SEC_DATA	DS_PACK('.', 'd', 'a', 't', 'a', 0, 0, 0)
+#define _PSR_KEY_SEC_TEXT	DS_PACK('.', 't', 'e', 'x', 't', 0, 0, 0)
+
 AType psr_jar_classify(Jar* jar) {
 	if (jar == NULL)
 		return ERR_TOK_INVALID_JAR;
@@ -48,19 +57,23 @@ AType psr_jar_classify(Jar* jar) {
 			return TYPE_PSR_JAR_LABEL;
 		}
 		token = jar->get(jar, cur);
-		AString stok = token->token;
-		if (strcmp(stok, "SET") == 0)
+		if (token->type == TYPE_TOK_MACRO)
+			return TYPE_PSR_JAR_MACRO;
+		if (token->packed == _PSR_KEY_SET)
 			return TYPE_PSR_JAR_SET_DIRECT;
-		if (strcmp(stok, "data") == 0)
+		if (token->packed == _PSR_KEY_DATA)
 			return TYPE_PSR_JAR_DATA_DECL;
 
 		return TYPE_PSR_JAR_LABL_INSTR;
 	}
 	/* Token can be section directive or instruction */
-	AString stok = token->token;
-	if (strcmp(stok, ".data") == 0)
+	if (token->type == TYPE_TOK_MACRO)
+		return TYPE_PSR_JAR_MACRO;
+	if (token->type == TYPE_TOK_COND)
+		return TYPE_PSR_JAR_COND;
+	if (token->packed == _PSR_KEY_SEC_DATA)
 		return TYPE_PSR_JAR_DAT_DIRECT;
-	if (strcmp(stok, ".text") == 0)
+	if (token->packed == _PSR_KEY_SEC_TEXT)
 		return TYPE_PSR_JAR_TEX_DIRECT;
 
 	/* Treat all other cases as instruction type: errors handled later  */
@@ -70,28 +83,97 @@ AType psr_jar_classify(Jar* jar) {
 /* Function for Grammar Checking  
  * ---------------------------------*/
 
-static AString _psr_alloc_astring(AString string, ASize max_size) {	/* Function to allocate a string into memory   */
-	if (string == NULL)
-		return NULL;
-	ASize length = strlen(string);
-	length = (length+1 > max_size)? max_size: length+1;
-	AString buff = (AString)malloc(length);
-	memcpy(buff, string, length-1);
-	buff[length-1] = '\0';
+static AInt32 _psr_token_id(Chunk* chunk, Token* token) {	/* Interned id of the token; words come interned from the tokenizer   */
+	if (token->id != UNSET_DS_INTERN)
+		return token->id;
 
-	return buff;
+	if (token->token == NULL)
+		return UNSET_DS_INTERN;
+	return chunk->interner->intern(chunk->interner, NULL, token->token, token->length);
 }
 
-static AErr _psr_insert_error(EWList* elist, ASize lno, ASize cno, AErr code) {
-	EWItem* eitem = ds_new_EWItem(lno, cno, code);
-	if (eitem == NULL)
-		return ERR_DS_STRUCT_GEN_FAIL;
+static AErr _psr_put_operands(Chunk* chunk, IItem* iitem, Jar* jar, ASize cur) {	/* Set the operands of `iitem` from the tokens at `cur`; `SET` uses are typed by the merge   */
+	Interner* interner = chunk->interner;
+	ASize i;
+	for (i = 0; i<iitem->n_op; i++) {
+		Token* token = jar->get(jar, cur++);
+		AInt32 id = _psr_token_id(chunk, token);
+		if (id == UNSET_DS_INTERN)
+			return ERR_MEM_ALLOC_FAIL;
+
+		if (i == 0) {
+			iitem->operand_1 = interner->string(interner, id);
+			iitem->operand_1_id = id;
+			iitem->operand_kind = ds_operand_kind(iitem->operand_1, &iitem->operand_value);
+		}
+		if (i == 1) {
+			iitem->operand_2 = interner->string(interner, id);
+			iitem->operand_2_id = id;
+		}
+	}
+
+	return SUCCESS;
+}
+
+static MnItem* _psr_find_mnemonic(MnMap* mnemonic_map, Token* token) {	/* Perfect hash on the packed content; only longer tokens need the string lookup   */
+	if (token->packed != UNSET_DS_PACKED)
+		return mnemonic_map->match(mnemonic_map, token->packed);
+	return mnemonic_map->find(mnemonic_map, token->token);
+}
+
+static AErr _psr_insert_error(EWList* elist, ASize lno, ASize cno, AErr code) {	/* The list copies the item into its own storage  */
+	EWItem eitem;
+	eitem.line = lno;
+	eitem.col = cno;
+	eitem.code = code;
 
-	return elist->insert(elist, eitem);
+	return elist->put(elist, &eitem);
 }
 
-static AErr _psr_verify_instruction(AAddr address, IList* ilist, EWList* elist, Jar* jar, MnMap* mnemonic_map) {	/* Function to check and insert instructions into instruction list   */
-	if ((jar == NULL) || (elist == NULL) || (ilist == NULL) || (mnemonic_map == NULL))
+/**
+ * Function for Chunk Events
+ * ---------------------------------*/
+
+static ChunkEvent _psr_event(AType kind, ASize lno, ASize cno) {	/* An event of the line, everything else unset   */
+	ChunkEvent event;
+	event.kind = kind;
+	event.dependent = FALSE;
+	event.lno = lno;
+	event.cno = cno;
+	event.col = 0;
+	event.code = SUCCESS;
+	event.id = UNSET_DS_INTERN;
+	event.value = 0;
+	event.row = UNSET_PSR_ROW;
+	return event;
+}
+
+static AErr _psr_chunk_push(Chunk* chunk, ChunkEvent* event) {	/* Events raised after a label of the same line depend on it   */
+	if (chunk->size == chunk->cap) {
+		ASize cap = (chunk->cap == 0)? 64: 2*chunk->cap;
+		ChunkEvent* events = (ChunkEvent*)realloc(chunk->events, cap*sizeof(ChunkEvent));
+		if (events == NULL)
+			return ERR_MEM_ALLOC_FAIL;
+		chunk->events = events;
+		chunk->cap = cap;
+	}
+
+	event->dependent = chunk->guard;
+	chunk->events[chunk->size++] = *event;
+	return SUCCESS;
+}
+
+static AErr _psr_chunk_error(Chunk* chunk, ASize lno, ASize cno, AErr code) {	/* Errors wait in line order for the merge   */
+	ChunkEvent event = _psr_event(TYPE_PSR_EVENT_ERROR, lno, cno);
+	event.code = code;
+	return _psr_chunk_push(chunk, &event);
+}
+
+/* Function for Grammar Checking of a Chunk
+ * ---------------------------------*/
+
+static AErr _psr_verify_instruction(AAddr address, Chunk* chunk, SymTable* stable, Jar* jar, MnMap* mnemonic_map) {	/* Function to check and insert instructions into the instruction list of the chunk   */
+	if ((jar == NULL) || (chunk == NULL) || (stable == NULL) || (mnemonic_map == NULL))
 		return ERR_PSR_NULL_ARG;
 	if (jar->size == 0)
 		return ERR_PSR_INVALID_JAR;
@@ -115,55 +197,40 @@ static AErr _psr_verify_instruction(AAddr address, IList* ilist, EWList* elist,
 	if (stok == NULL)
 		return ERR_PSR_TOK_STRING_TEMPERED;
 
-	MnItem* mitem = mnemonic_map->find(mnemonic_map, stok);
+	MnItem* mitem = _psr_find_mnemonic(mnemonic_map, token);
 	if (mitem == NULL) {
 		/* Invalid Mnemonic  */
-		return _psr_insert_error(elist, jar->lno, token->cno, PSR_ERR_INV_MNEMO);
+		return _psr_chunk_error(chunk, jar->lno, token->cno, PSR_ERR_INV_MNEMO);
 	}
 	
 	jsize-=1;	/* Operand Count = Total Tokens - 1 # for mnemonic   */
-	IItem* iitem = ds_new_IItem(address);
-	if (iitem == NULL)
-		return ERR_DS_STRUCT_GEN_FAIL;
-
-	iitem->opcode = mitem->key;
-	iitem->n_op = mitem->n_operand;
-	iitem->lno = jar->lno;
+	IItem iitem;	/* Copied into the columns of the list by `put`  */
+	ds_init_IItem(&iitem, address);
+
+	iitem.opcode = mitem->key;
+	iitem.opcode_id = token->id;
+	iitem.mnemonic = mitem->id;
+	iitem.n_op = mitem->n_operand;
+	iitem.lno = jar->lno;
 	
-	if (iitem->n_op != jsize) {
+	if (iitem.n_op != jsize) {
 		/* If Number of operands is not equal to required number of operands   */
-		iitem->destroy(iitem);
-		return _psr_insert_error(elist, jar->lno, token->cno, PSR_ERR_MMT_OPRND);
+		return _psr_chunk_error(chunk, jar->lno, token->cno, PSR_ERR_MMT_OPRND);
 	}
 
 	cur++;	/* Move to the operand tokens   */
 	/* Insert operands if required   */
-	ASize i;
-	for (i = 0; i<iitem->n_op; i++) {
-		token = jar->get(jar, cur++);
-		AString operand = token->token;
-		
-		AString buff = _psr_alloc_astring(operand, SZ_PSR_BUFF_OPRND);
-		if (buff == NULL) {
-			iitem->destroy(iitem);
-			return ERR_MEM_ALLOC_FAIL;
-		}
-		if (i == 0)
-			iitem->operand_1 = buff;
-		if (i == 1)
-			iitem->operand_2 = buff;
-	}
+	if (_psr_put_operands(chunk, &iitem, jar, cur) != SUCCESS)
+		return ERR_MEM_ALLOC_FAIL;
 
-	if (ilist->insert(ilist, iitem) != SUCCESS) {
-		iitem->destroy(iitem);
+	if (chunk->ilist->put(chunk->ilist, &iitem) != SUCCESS)
 		return ERR_DS_INSERT_FAIL;
-	}
 
 	return SUCCESS;
 }
 
-static AErr _psr_verify_labels(AAddr address, Jar* jar, SymTable* stable, EWList* elist) {	/* Function to verify labels and add into symbol table   */
-	if ((jar == NULL) || (stable == NULL) || (elist == NULL))
+static AErr _psr_verify_labels(AAddr address, Jar* jar, Chunk* chunk) {	/* Function to verify labels, the merge adds them into symbol table   */
+	if ((jar == NULL) || (chunk == NULL))
 		return ERR_PSR_NULL_ARG;
 
 	ASize jsize = jar->size;
@@ -186,25 +253,22 @@ static AErr _psr_verify_labels(AAddr address, Jar* jar, SymTable* stable, EWList
 	
 	if (jsize != 1) {
 		/* Redundant Tokens  */
-		return _psr_insert_error(elist, jar->lno, token->cno, PSR_ERR_MMT_OPRND);
+		return _psr_chunk_error(chunk, jar->lno, token->cno, PSR_ERR_MMT_OPRND);
 	}
 
-	AString stok = token->token;
-	if (stable->find(stable, stok) != ERR_MAP_FIND_ADDRESS) {
-	/* Duplicate label case   */
-		return _psr_insert_error(elist, jar->lno, token->cno, PSR_ERR_DUP_LABEL);
-	}
-
-	/* TO-DO: Add the functionality to filter invalid labels   */
-	AString string = _psr_alloc_astring(stok, SZ_PSR_BUFF_OPRND);
-	if (string == NULL)
+	AInt32 id = _psr_token_id(chunk, token);
+	if (id == UNSET_DS_INTERN)
 		return ERR_MEM_ALLOC_FAIL;
 
-	return stable->insert(stable, string, address);
+	/* TO-DO: Add the functionality to filter invalid labels   */
+	ChunkEvent event = _psr_event(TYPE_PSR_EVENT_LABEL, jar->lno, token->cno);
+	event.id = id;
+	event.value = (AInt32)address;
+	return _psr_chunk_push(chunk, &event);
 }
 
-static AErr _psr_verify_labl_instr(AAddr address, Jar* jar, IList* ilist, SymTable* stable, EWList* elist, MnMap* mnemonic_map) {
-	if ((jar == NULL) || (ilist == NULL) || (stable == NULL) || (elist == NULL))
+static AErr _psr_verify_labl_instr(AAddr address, Jar* jar, Chunk* chunk, SymTable* stable, MnMap* mnemonic_map) {
+	if ((jar == NULL) || (chunk == NULL) || (stable == NULL))
 		return ERR_PSR_NULL_ARG;
 
 	ASize cur = 0;
@@ -219,20 +283,19 @@ static AErr _psr_verify_labl_instr(AAddr address, Jar* jar, IList* ilist, SymTab
 			return ERR_PSR_INVALID_TOKEN;
 	}
 
-	AString label = token->token;
 	if (token == NULL) return ERR_PSR_TOK_STRING_TEMPERED;
 
-	AString string = _psr_alloc_astring(label, SZ_PSR_BUFF_OPRND);
-	if (string == NULL) return ERR_MEM_ALLOC_FAIL;
+	AInt32 id = _psr_token_id(chunk, token);
+	if (id == UNSET_DS_INTERN) return ERR_MEM_ALLOC_FAIL;
 
-	if (stable->find(stable, string) != ERR_MAP_FIND_ADDRESS) {
-		/* Case of invalid label */
-		free(string);
-		return _psr_insert_error(elist, jar->lno, token->cno, PSR_ERR_DUP_LABEL);
-	}
-
-	if (stable->insert(stable, string, address) != SUCCESS)
+	/* A duplicate label drops the whole line, so the rest depends on it   */
+	ChunkEvent event = _psr_event(TYPE_PSR_EVENT_LABEL, jar->lno, token->cno);
+	event.id = id;
+	event.value = (AInt32)address;
+	if (_psr_chunk_push(chunk, &event) != SUCCESS)
 		return ERR_DS_INSERT_FAIL;
+	ASize label = chunk->size - 1;
+	chunk->guard = TRUE;
 
 	cur++;	/* Move to the instruction insertion   */
 	ASize jsize = jar->size-cur;
@@ -244,56 +307,41 @@ static AErr _psr_verify_labl_instr(AAddr address, Jar* jar, IList* ilist, SymTab
 	if (stok == NULL)
 		return ERR_PSR_TOK_STRING_TEMPERED;
 
-	MnItem* mitem = mnemonic_map->find(mnemonic_map, stok);
+	MnItem* mitem = _psr_find_mnemonic(mnemonic_map, token);
 	if (mitem == NULL) {
 		/* Invalid Mnemonic  */
-		return _psr_insert_error(elist, jar->lno, token->cno, PSR_ERR_INV_MNEMO);
+		return _psr_chunk_error(chunk, jar->lno, token->cno, PSR_ERR_INV_MNEMO);
 	}
 	
 	jsize-=1;	/* Operand Count = Total Tokens - 1 # for mnemonic   */
-	IItem* iitem = ds_new_IItem(address);
-	if (iitem == NULL)
-		return ERR_DS_STRUCT_GEN_FAIL;
-
-	iitem->opcode = mitem->key;
-	iitem->n_op = mitem->n_operand;
-	iitem->lno = jar->lno;
+	IItem iitem;	/* Copied into the columns of the list by `put`  */
+	ds_init_IItem(&iitem, address);
+
+	iitem.opcode = mitem->key;
+	iitem.opcode_id = token->id;
+	iitem.mnemonic = mitem->id;
+	iitem.n_op = mitem->n_operand;
+	iitem.lno = jar->lno;
 	
-	if (iitem->n_op != jsize) {
+	if (iitem.n_op != jsize) {
 		/* If Number of operands is not equal to required number of operands   */
-		iitem->destroy(iitem);
-		return _psr_insert_error(elist, jar->lno, token->cno, PSR_ERR_MMT_OPRND);
+		return _psr_chunk_error(chunk, jar->lno, token->cno, PSR_ERR_MMT_OPRND);
 	}
 
 	cur++;	/* Move to the operand tokens   */
 	/* Insert operands if required   */
-	ASize i;
-	for (i = 0; i<iitem->n_op; i++) {
-		token = jar->get(jar, cur++);
-		AString operand = token->token;
-		
-		AString buff = _psr_alloc_astring(operand, SZ_PSR_BUFF_OPRND);
-		if (buff == NULL) {
-			iitem->destroy(iitem);
-			return ERR_MEM_ALLOC_FAIL;
-		}
-		if (i == 0)
-			iitem->operand_1 = buff;
-		if (i == 1)
-			iitem->operand_2 = buff;
-	}
+	if (_psr_put_operands(chunk, &iitem, jar, cur) != SUCCESS)
+		return ERR_MEM_ALLOC_FAIL;
 
-	if (ilist->insert(ilist, iitem) != SUCCESS) {
-		iitem->destroy(iitem);
+	if (chunk->ilist->put(chunk->ilist, &iitem) != SUCCESS)
 		return ERR_DS_INSERT_FAIL;
-	}
 
+	chunk->events[label].row = chunk->ilist->size(chunk->ilist) - 1;
 	return SUCCESS;
 }
 
-static AErr _psr_verify_data_decl(Jar* jar, DList* dlist, SymTable* stable, EWList* elist) {	/* Function to add data allocations to memory and maintain symbol table for that   */
-	/* Add functionality of data address record keeping in dlist   */
-	if ((jar == NULL) || (dlist == NULL) || (stable == NULL))
+static AErr _psr_verify_data_decl(Jar* jar, Chunk* chunk) {	/* Function to check data allocations; the merge gives them addresses and symbols   */
+	if ((jar == NULL) || (chunk == NULL))
 		return ERR_PSR_NULL_ARG;
 
 	ASize cur = 0;
@@ -306,42 +354,40 @@ static AErr _psr_verify_data_decl(Jar* jar, DList* dlist, SymTable* stable, EWLi
 		jsize-=1;
 	}
 	
-	AString label = token->token;
-	if (stable->find(stable, label) != ERR_MAP_FIND_ADDRESS)  {
-	/* Case of Duplicate label   */
-		return _psr_insert_error(elist, jar->lno, token->cno, PSR_ERR_DUP_LABEL);		
-	}
+	AInt32 id = _psr_token_id(chunk, token);
+	if (id == UNSET_DS_INTERN)
+		return ERR_MEM_ALLOC_FAIL;
+
+	/* A duplicate label is only known at the merge, it wins over the errors below   */
+	ChunkEvent event = _psr_event(TYPE_PSR_EVENT_DATA, jar->lno, token->cno);
+	event.id = id;
 
 	cur = cur+2;
 	token = jar->get(jar, cur);
 	if (token == NULL) {
 	/* Data Missing   */
-		return _psr_insert_error(elist, jar->lno, 3, PSR_ERR_MIS_DDATA);
-	}
-	
-	AString data = token->token;
-
-	AInt32 value = strtol(data, NULL, 0);
-
-	if ((strcmp(data, "0")!=0) && (value == 0)) {
-		return _psr_insert_error(elist, jar->lno, token->cno, PSR_ERR_FMT_DDATA);
-	}
-
-	AAddr address;
-	if (dlist->insert(dlist, value, &address) != SUCCESS) {
-		return ERR_DS_INSERT_FAIL;
+		event.code = PSR_ERR_MIS_DDATA;
+		event.col = 3;
+	} else if (ds_operand_kind(token->token, &event.value) != TYPE_DS_OPERAND_NUMBER) {
+		event.code = PSR_ERR_FMT_DDATA;
+		event.col = token->cno;
 	}
 
+	return _psr_chunk_push(chunk, &event);
+}
 
-	AString string = _psr_alloc_astring(label, SZ_PSR_BUFF_OPRND);
-	if (stable->insert(stable, label, address) != SUCCESS) {
-		return ERR_DS_INSERT_FAIL;
+static AErr _psr_verify_marked(Jar* jar, Chunk* chunk, AType type, AErr code) {	/* The tokenizer marks the token of a macro or conditional line it could not use   */
+	ASize i;
+	for (i = 0; i<jar->size; i++) {
+		Token* token = jar->get(jar, i);
+		if (token->type == type)
+			return _psr_chunk_error(chunk, jar->lno, token->cno, code);
 	}
-	return SUCCESS;
+	return ERR_PSR_INVALID_JAR;
 }
 
-static AErr _psr_verify_set_directive(Jar* jar, SymTable* stable, EWList* elist) {
-	if ((jar == NULL) || (stable == NULL) || (elist == NULL))
+static AErr _psr_verify_set_directive(Jar* jar, Chunk* chunk) {
+	if ((jar == NULL) || (chunk == NULL))
 		return ERR_PSR_NULL_ARG;
 
 	ASize cur = 0;
@@ -359,43 +405,29 @@ static AErr _psr_verify_set_directive(Jar* jar, SymTable* stable, EWList* elist)
 			return ERR_PSR_INVALID_TOKEN;
 	}
 
-	AString label = _psr_alloc_astring(token->token, SZ_PSR_BUFF_OPRND);
-	if (label == NULL)
+	AInt32 id = _psr_token_id(chunk, token);
+	if (id == UNSET_DS_INTERN)
 		return ERR_MEM_ALLOC_FAIL;
 	
-	/* Case of Duplicate label  */
-	if (stable->find(stable, label) != ERR_MAP_FIND_ADDRESS) {
-		free(label);
-		return _psr_insert_error(elist, jar->lno, token->cno, PSR_ERR_DUP_LABEL);
-	}
+	ChunkEvent event = _psr_event(TYPE_PSR_EVENT_SET, jar->lno, token->cno);
+	event.id = id;
+
 	cur+=2;	/* Jump the cursor to the value of set directive   */
 	token = jar->get(jar, cur);
 
 	if (token == NULL) {
 		/* Case of missing set directive data   */
-		return _psr_insert_error(elist, jar->lno, 3, PSR_ERR_MIS_SETDA);
-	}
-
-	AString value = token->token;
-	if (value == NULL) {
-		free(label);
+		event.code = PSR_ERR_MIS_SETDA;
+		event.col = 3;
+	} else if (token->token == NULL) {
 		return ERR_PSR_TOK_STRING_TEMPERED;
-	}
-
-	AInt operand_value = strtol(value, NULL, 0);
-
-	if ((strcmp(value, "0")!=0) && (operand_value == 0)) {
+	} else if (ds_operand_kind(token->token, &event.value) != TYPE_DS_OPERAND_NUMBER) {
 	/* Invalid operand format: Parsing failed   */
-		free(label);
-		return _psr_insert_error(elist, jar->lno, token->cno, PSR_ERR_FMT_DDATA);
-	}
-
-	if (stable->insert(stable, label, operand_value) != SUCCESS) {
-		free(label);
-		return ERR_DS_INSERT_FAIL;
+		event.code = PSR_ERR_FMT_DDATA;
+		event.col = token->cno;
 	}
 
-	return SUCCESS;
+	return _psr_chunk_push(chunk, &event);
 }
 
 /* *
@@ -425,11 +457,10 @@ static void _psr_debug_print_symbol_table(SymTable* stable) {
 		return;
 
 	printf("Symbol Table\n---------------------------\n");
-	SymItem* item = stable->get(stable);
-	while (item != NULL) {
-		printf("%s -> %d\n", item->key, item->address);
-		item = stable->get(NULL);
-	}
+	SymCursor cursor;
+	stable->begin(stable, &cursor);
+	while (stable->next(stable, &cursor))
+		printf("%s -> %d\n", cursor.item.key, cursor.item.address);
 	printf("\n");
 }
 
@@ -438,11 +469,10 @@ static void _psr_debug_print_ewlist(EWList* elist) {
 		return;
 
 	printf("\nError/Warning List\n----------------------\n");
-	EWItem* eitem = elist->get(elist);
-	while (eitem != NULL) {
-		printf("%d: %d ==> %d\n", eitem->line, eitem->col, eitem->code);
-		eitem = elist->get(NULL);
-	}
+	EWCursor cursor;
+	elist->begin(elist, &cursor);
+	while (elist->next(elist, &cursor))
+		printf("%d: %d ==> %d\n", cursor.item->line, cursor.item->col, cursor.item->code);
 	printf("\n");
 }
 
@@ -460,35 +490,21 @@ void psr_destroy_ParserInterface(ParserInterface* pi) {
 	pi = NULL;
 }
 
-AErr psr_ParserInterface_parse(ParserInterface* pi, FILE* file) {
-	if (pi == NULL)
-		return ERR_INVALID_INTERFACE;
-
-	if (file == NULL)
-		return ERR_FILE_INVALID_FILE;
-
-	TokInterface* ti = tk_new_TokInterface(file, 1);		/* 1 Worker number: currently no multi threading implemented. */
-	if (ti == NULL)
-		return ERR_INTERFACE_GEN_FAIL;
-
-	Cargo* cargo = tk_new_Cargo();
-	if (cargo == NULL) {
-		ti->destroy(ti);
-		return ERR_DS_STRUCT_GEN_FAIL;
-	}
-
-	if (ti->fillCargo(ti, cargo) != SUCCESS) {
-		ti->destroy(ti);
-		cargo->destroy(cargo, TRUE);
-		return ERR_TOK_CARGO_LOAD_FAIL;
-	}
+static void _psr_parse_range(ParserInterface* pi, ParsePool* pool, Chunk* chunk) {	/* Check the grammar of the Jars [lo, hi) of a batch with chunk relative addresses   */
+	chunk->ilist->clear(chunk->ilist);
+	chunk->size = 0;
+	chunk->address_counter = 0;
+	chunk->status = SUCCESS;
 
-	/* Cargo is filled with jars   */
-	ASize sz = cargo->size;
-	int i;
-	AAddr address_counter = 0;
-	for (i = 0; i<sz; i++) {
-		Jar* jar = cargo->get(cargo, i);
+	ASize w = 0;		/* The window of Jar `i`, whose first Jar is `first` in the batch   */
+	ASize first = 0;
+	ASize i;
+	for (i = chunk->lo; i<chunk->hi; i++) {
+		while (i >= pool->ends[w]) {
+			first = pool->ends[w];
+			w++;
+		}
+		Jar* jar = pool->windows[w]->get(pool->windows[w], i - first);
 		if (jar == NULL) {
 			printf("DEBUG: A jar is missing.\n");
 		}
@@ -497,40 +513,569 @@ AErr psr_ParserInterface_parse(ParserInterface* pi, FILE* file) {
 		AErr eno = SUCCESS;
 		if (jar_type == TYPE_PSR_JAR_INSTRUCTION) {
 			/* Jar has instrucitons  */
-			eno = _psr_verify_instruction(address_counter, pi->ilist, pi->elist, jar, pi->mnemonic_map);
-			address_counter += 1;	/* Fixed size instrucions   */
+			eno = _psr_verify_instruction(chunk->address_counter, chunk, pi->stable, jar, pi->mnemonic_map);
+			chunk->address_counter += 1;	/* Fixed size instrucions   */
 		}
 		else if (jar_type == TYPE_PSR_JAR_LABEL) {
 			/* Jar has labels  */
-			eno = _psr_verify_labels(address_counter, jar, pi->stable, pi->elist);
+			eno = _psr_verify_labels(chunk->address_counter, jar, chunk);
 		}
 		else if (jar_type == TYPE_PSR_JAR_DATA_DECL) {
 			/* Jar has data declaration  */
-			eno = _psr_verify_data_decl(jar, pi->dlist, pi->stable, pi->elist);
+			eno = _psr_verify_data_decl(jar, chunk);
 		}
 		else if (jar_type == TYPE_PSR_JAR_SET_DIRECT) {
 			/* Jar has set directive  */
-			eno = _psr_verify_set_directive(jar, pi->stable, pi->elist);
+			eno = _psr_verify_set_directive(jar, chunk);
 		}
 		else if (jar_type == TYPE_PSR_JAR_LABL_INSTR) {
 			/* Jar has label with instruction on same line  */
-			eno = _psr_verify_labl_instr(address_counter, jar, pi->ilist, pi->stable, pi->elist, pi->mnemonic_map);
+			eno = _psr_verify_labl_instr(chunk->address_counter, jar, chunk, pi->stable, pi->mnemonic_map);
+			chunk->address_counter += 1;	/* The instruction after the label takes a slot too   */
+		}
+		else if (jar_type == TYPE_PSR_JAR_MACRO) {
+			/* Jar has a malformed macro line  */
+			eno = _psr_verify_marked(jar, chunk, TYPE_TOK_MACRO, PSR_ERR_INV_MACRO);
+		}
+		else if (jar_type == TYPE_PSR_JAR_COND) {
+			/* Jar has a malformed conditional line  */
+			eno = _psr_verify_marked(jar, chunk, TYPE_TOK_COND, PSR_ERR_INV_COND);
 		}
 		else {
-			printf("Invalid Jar Type\n");
 			eno = WARN_PSR_INVALID_JAR_TYPE;
 		}
 
 		if (eno != SUCCESS) {
+			/* Reported by the merge, so the messages come out in line order   */
+			ChunkEvent event = _psr_event(TYPE_PSR_EVENT_STATUS, (jar == NULL)? 0: jar->lno, 0);
+			event.code = eno;
+			if (_psr_chunk_push(chunk, &event) != SUCCESS)
+				chunk->status = ERR_MEM_ALLOC_FAIL;
+		}
+		chunk->guard = FALSE;
+	}
+}
+
+static AErr _psr_flush_rows(ParserInterface* pi, IList* rows, ASize first, ASize count, AAddr base) {	/* Hand rows [first, first+count) of a chunk over at `base`   */
+	if (pi->sink == NULL)
+		return pi->ilist->append(pi->ilist, rows, first, count, base);
+
+	AErr err = SUCCESS;
+	ICursor cursor;
+	rows->begin(rows, &cursor);
+	cursor.row = first;
+	while ((cursor.row < first + count) && (rows->next(rows, &cursor) == TRUE)) {
+		cursor.item.address += base;
+		AErr eno = pi->sink->emit(pi->sink->target, &cursor.item);
+		if (eno != SUCCESS)
+			err = eno;
+	}
+	return err;
+}
+
+static AErr _psr_define(ParserInterface* pi, AInt32 id) {	/* Tell the sink a symbol has its value   */
+	if (pi->sink == NULL)
+		return SUCCESS;
+	return pi->sink->define(pi->sink->target, id);
+}
+
+static void _psr_type_consts(ParserInterface* pi, IList* rows, ICursor* typed, ASize lno) {	/* Type the rows of the chunk before line `lno` whose operand names a `SET` seen so far   */
+	while (rows->next(rows, typed) == TRUE) {
+		if (typed->item.lno >= lno) {
+			typed->row--;	/* Typed again once the `SET` of `lno` is in   */
+			return;
+		}
+		AInt32 id = typed->item.operand_1_id;
+		if ((typed->item.operand_kind == TYPE_DS_OPERAND_SYMBOL) && (pi->stable->isConst(pi->stable, id) == TRUE))
+			rows->retype(rows, typed, TYPE_DS_OPERAND_CONST, (AInt32)pi->stable->findId(pi->stable, id));
+	}
+}
+
+/* A status that means a row or an event of the line was lost, not a bad line  */
+#define _PSR_LOST(code)	(((code) == ERR_MEM_ALLOC_FAIL) || ((code) == ERR_MEM_REALLOC_FAIL) || ((code) == ERR_DS_INSERT_FAIL))
+
+static AErr _psr_merge_chunk(ParserInterface* pi, Chunk* chunk, AAddr base) {	/* Replay the events of a chunk in line order and append its instructions at `base`   */
+	IList* rows = chunk->ilist;
+	ASize copied = 0;		/* The rows of the chunk before this one are done  */
+	ABool skip = FALSE;	/* The label before was a duplicate  */
+	ICursor typed;			/* The rows before it know whether they use a `SET`  */
+	rows->begin(rows, &typed);
+	if (chunk->status != SUCCESS)
+		return chunk->status;	/* Merged without all its events, the output would be wrong   */
+
+	ASize i;
+	for (i = 0; i<chunk->size; i++) {
+		if (pi->elist->exhausted(pi->elist) == TRUE)
+			return SUCCESS;		/* Out of error budget, nothing after this matters   */
+
+		ChunkEvent* event = &chunk->events[i];
+		if ((event->dependent == TRUE) && (skip == TRUE))
+			continue;
+		skip = FALSE;
+
+		AErr eno = SUCCESS;
+		if (event->kind == TYPE_PSR_EVENT_ERROR) {
+			eno = _psr_insert_error(pi->elist, event->lno, event->cno, event->code);
+		}
+		else if (event->kind == TYPE_PSR_EVENT_STATUS) {
+			if (event->code == WARN_PSR_INVALID_JAR_TYPE)
+				printf("Invalid Jar Type\n");
+			if (_PSR_LOST(event->code))
+				return event->code;
 			printf("FAILURE\n");
 		}
+		else if (pi->stable->findId(pi->stable, event->id) != ERR_MAP_FIND_ADDRESS) {
+			/* Duplicate label: the line is dropped, instruction included   */
+			eno = _psr_insert_error(pi->elist, event->lno, event->cno, PSR_ERR_DUP_LABEL);
+			if ((eno == SUCCESS) && (event->row != UNSET_PSR_ROW)) {
+				_psr_type_consts(pi, rows, &typed, event->lno);
+				eno = _psr_flush_rows(pi, rows, copied, event->row - copied, base);
+				copied = event->row + 1;
+			}
+			skip = TRUE;
+		}
+		else if (event->code != SUCCESS) {
+			eno = _psr_insert_error(pi->elist, event->lno, event->col, event->code);
+		}
+		else if (event->kind == TYPE_PSR_EVENT_LABEL) {
+			eno = pi->stable->insertId(pi->stable, event->id, base + (AAddr)event->value);
+			if (eno == SUCCESS)
+				eno = _psr_define(pi, event->id);
+		}
+		else if (event->kind == TYPE_PSR_EVENT_DATA) {
+			AAddr address;
+			eno = pi->dlist->insert(pi->dlist, event->value, &address);
+			if (eno == SUCCESS)
+				eno = pi->stable->insertId(pi->stable, event->id, address);
+			if (eno == SUCCESS)
+				eno = _psr_define(pi, event->id);
+		}
+		else {
+			/* The rows above the `SET` must not see it, whichever chunk it came from   */
+			_psr_type_consts(pi, rows, &typed, event->lno);
+			eno = pi->stable->insertConst(pi->stable, event->id, (AAddr)event->value);
+			if (eno == SUCCESS)
+				eno = _psr_define(pi, event->id);
+		}
+
+		if (eno != SUCCESS)
+			return eno;
+	}
+
+	_psr_type_consts(pi, rows, &typed, UNSET_PSR_LINE);
+	return _psr_flush_rows(pi, rows, copied, rows->size(rows) - copied, base);
+}
+
+/**
+ * Functions for Parse Pool
+ * ---------------------------------*/
+
+static void _psr_ParsePool_run(ParsePool* pool, struct psr_worker* worker) {	/* Parse the chunk that belongs to `worker`   */
+	if (worker->index >= pool->active)
+		return;
+
+	_psr_parse_range(pool->pi, pool, &worker->chunk);
+}
+
+static void* _psr_ParsePool_main(void* arg) {	/* The loop of a pool thread: wait for a job, parse its chunk, report back   */
+	struct psr_worker* worker = (struct psr_worker*)arg;
+	ParsePool* pool = worker->pool;
+	ASize seen = 0;
+
+	pthread_mutex_lock(&pool->lock);
+	while (1) {
+		while ((pool->generation == seen) && (!pool->shutdown))
+			pthread_cond_wait(&pool->start, &pool->lock);
+		if (pool->shutdown)
+			break;
+		seen = pool->generation;
+		pthread_mutex_unlock(&pool->lock);
+
+		_psr_ParsePool_run(pool, worker);
+
+		pthread_mutex_lock(&pool->lock);
+		pool->pending--;
+		if (pool->pending == 0)
+			pthread_cond_signal(&pool->done);
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	return NULL;
+}
+
+static void _psr_destroy_ParsePool(ParsePool* pool) {	/* Stop and join the pool threads, then release the pool   */
+	if (pool == NULL)
+		return;
+
+	pthread_mutex_lock(&pool->lock);
+	pool->shutdown = TRUE;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+
+	ASize i;
+	for (i = 1; i<pool->size; i++)
+		pthread_join(pool->workers[i].thread, NULL);
+
+	for (i = 0; i<SZ_PSR_MAX_THREAD; i++) {
+		Chunk* chunk = &pool->workers[i].chunk;
+		if (chunk->ilist != NULL)
+			chunk->ilist->destroy(chunk->ilist);
+		free(chunk->events);
+	}
+
+	pthread_cond_destroy(&pool->done);
+	pthread_cond_destroy(&pool->start);
+	pthread_mutex_destroy(&pool->lock);
+	free(pool);
+}
+
+static ParsePool* _psr_new_ParsePool(ASize size, Assembly* assembly) {	/* Start `size - 1` threads; the calling thread acts as worker 0   */
+	ParsePool* pool = (ParsePool*)calloc(1, sizeof(ParsePool));
+	if (pool == NULL)
+		return NULL;
+
+	if (size > SZ_PSR_MAX_THREAD)
+		size = SZ_PSR_MAX_THREAD;
+
+	pool->size = 1;
+	pool->shutdown = FALSE;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->start, NULL);
+	pthread_cond_init(&pool->done, NULL);
+
+	ASize i;
+	for (i = 0; i<size; i++) {
+		pool->workers[i].pool = pool;
+		pool->workers[i].index = i;
+		pool->workers[i].chunk.interner = assembly->interner;
+		pool->workers[i].chunk.ilist = ds_new_IList(assembly);
+		if (pool->workers[i].chunk.ilist == NULL) {
+			_psr_destroy_ParsePool(pool);
+			return NULL;
+		}
+	}
+
+	for (i = 1; i<size; i++) {
+		if (pthread_create(&pool->workers[i].thread, NULL, _psr_ParsePool_main, &pool->workers[i]) != 0)
+			break;	/* Carry on with the threads we managed to start   */
+		pool->size++;
+	}
+
+	return pool;
+}
+
+static AErr _psr_parse_batch(ParserInterface* pi, Cargo** windows, ASize size) {	/* Check the grammar of every Jar of `size` consecutive Cargo windows   */
+	ParsePool* pool = pi->pool;
+	ASize count = 0;
+	ASize i;
+	for (i = 0; i<size; i++) {
+		count += windows[i]->size;
+		pool->windows[i] = windows[i];
+		pool->ends[i] = count;
+	}
+	pool->count = size;
+	if (count == 0)
+		return SUCCESS;
+
+	/* Every worker parses a contiguous chunk as if it started at address 0.
+	 * The merge then walks the chunks in order, so the running address total
+	 * (a prefix sum of the chunk sizes) rebases each one, and the labels and
+	 * errors reach the shared lists in the same order as a single pass.   */
+	ASize active = (count + SZ_PSR_CHUNK_MIN_JARS - 1)/SZ_PSR_CHUNK_MIN_JARS;
+	if (active > pool->size)
+		active = pool->size;
+
+	for (i = 0; i<active; i++) {
+		pool->workers[i].chunk.lo = (count * i)/active;
+		pool->workers[i].chunk.hi = (count * (i + 1))/active;
+	}
+	pool->pi = pi;
+	pool->active = active;
+
+	if (active == 1) {
+		_psr_ParsePool_run(pool, &pool->workers[0]);
+	} else {
+		pthread_mutex_lock(&pool->lock);
+		pool->pending = pool->size - 1;
+		pool->generation++;
+		pthread_cond_broadcast(&pool->start);
+		pthread_mutex_unlock(&pool->lock);
+
+		_psr_ParsePool_run(pool, &pool->workers[0]);
+
+		pthread_mutex_lock(&pool->lock);
+		while (pool->pending != 0)
+			pthread_cond_wait(&pool->done, &pool->lock);
+		pthread_mutex_unlock(&pool->lock);
+	}
+
+	for (i = 0; i<active; i++) {
+		Chunk* chunk = &pool->workers[i].chunk;
+		AErr eno = _psr_merge_chunk(pi, chunk, pi->address_counter);
+		if (eno != SUCCESS)
+			return eno;
+		pi->address_counter += chunk->address_counter;
+	}
+	return SUCCESS;
+}
+
+static void _psr_unload_cargo(Cargo* cargo) {	/* Free the Jars of a parsed window and empty the Cargo for the next one   */
+	ASize i;
+	for (i = 0; i<cargo->size; i++) {
+		Jar* jar = cargo->get(cargo, i);
+		if (jar != NULL)
+			jar->destroy(jar);
+	}
+	cargo->clear(cargo, FALSE);
+}
+
+/**
+ * Functions for Pipeline
+ * ---------------------------------*/
+
+/* Every Ring has room for all the Cargos and the end marker, so a push only
+ * waits if that is broken; the stages are throttled by the `empty` Ring,
+ * the reader cannot run further ahead than SZ_PSR_PIPE_DEPTH windows. The
+ * parser holds at most SZ_PSR_PARSE_BATCH of them while it gathers a batch,
+ * the depth is larger so the reader always has a window to fill.  */
+
+static void _psr_Pipeline_wake(Pipeline* pipe) {	/* Every sleeper checks its Ring again  */
+	pthread_mutex_lock(&pipe->lock);
+	pthread_cond_broadcast(&pipe->moved);
+	pthread_mutex_unlock(&pipe->lock);
+}
+
+static void _psr_Pipeline_push(Pipeline* pipe, Ring* ring, Cargo* cargo) {
+	ASize spin;
+	for (spin = 0; spin<SZ_PSR_PIPE_SPIN; spin++) {
+		if (ring->push(ring, (void*)cargo) == TRUE) {
+			_psr_Pipeline_wake(pipe);
+			return;
+		}
+		sched_yield();
+	}
+
+	/* A slow stage on the other side: sleep rather than spin  */
+	pthread_mutex_lock(&pipe->lock);
+	while (ring->push(ring, (void*)cargo) == FALSE)
+		pthread_cond_wait(&pipe->moved, &pipe->lock);
+	pthread_cond_broadcast(&pipe->moved);
+	pthread_mutex_unlock(&pipe->lock);
+}
+
+static Cargo* _psr_Pipeline_pop(Pipeline* pipe, Ring* ring) {
+	void* cargo;
+	ASize spin;
+	for (spin = 0; spin<SZ_PSR_PIPE_SPIN; spin++) {
+		if (ring->pop(ring, &cargo) == TRUE) {
+			_psr_Pipeline_wake(pipe);
+			return (Cargo*)cargo;
+		}
+		sched_yield();
+	}
+
+	/* Blocked on the input or on a busy stage: sleep rather than spin  */
+	pthread_mutex_lock(&pipe->lock);
+	while (ring->pop(ring, &cargo) == FALSE)
+		pthread_cond_wait(&pipe->moved, &pipe->lock);
+	pthread_cond_broadcast(&pipe->moved);
+	pthread_mutex_unlock(&pipe->lock);
+	return (Cargo*)cargo;
+}
+
+static AErr _psr_Pipeline_status(Pipeline* pipe) {
+	return __atomic_load_n(&pipe->status, __ATOMIC_ACQUIRE);
+}
+
+static void _psr_Pipeline_fail(Pipeline* pipe, AErr status) {	/* Keep the first error only  */
+	AErr expected = SUCCESS;
+	__atomic_compare_exchange_n(&pipe->status, &expected, status, FALSE, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static void* _psr_Pipeline_reader(void* arg) {	/* Stage 1: load windows of Line Packets  */
+	Pipeline* pipe = (Pipeline*)arg;
+	TokInterface* ti = pipe->ti;
+
+	while ((ti->status == 0) && (_psr_Pipeline_status(pipe) == SUCCESS)) {
+		Cargo* cargo = _psr_Pipeline_pop(pipe, pipe->empty);
+		if (ti->loadCargo(ti, cargo) != SUCCESS)
+			_psr_Pipeline_fail(pipe, ERR_TOK_CARGO_LOAD_FAIL);
+		_psr_Pipeline_push(pipe, pipe->to_tok, cargo);	/* Passed on even if it failed, its packets need freeing  */
+	}
+
+	_psr_Pipeline_push(pipe, pipe->to_tok, NULL);
+	return NULL;
+}
+
+static void* _psr_Pipeline_tokenizer(void* arg) {	/* Stage 2: turn the Line Packets into Jars  */
+	Pipeline* pipe = (Pipeline*)arg;
+	TokInterface* ti = pipe->ti;
+
+	while (1) {
+		Cargo* cargo = _psr_Pipeline_pop(pipe, pipe->to_tok);
+		if ((cargo != NULL) && (_psr_Pipeline_status(pipe) == SUCCESS)) {
+			if (ti->jarifyCargo(ti, cargo) != SUCCESS)
+				_psr_Pipeline_fail(pipe, ERR_TOK_CARGO_LOAD_FAIL);
+		}
+
+		_psr_Pipeline_push(pipe, pipe->to_psr, cargo);
+		if (cargo == NULL)
+			break;
+	}
+
+	return NULL;
+}
+
+static AErr _psr_init_Pipeline(Pipeline* pipe, TokInterface* ti, Cargo* first) {	/* The Cargos except `first` belong to the Pipeline  */
+	pipe->ti = ti;
+	pipe->status = SUCCESS;
+	pthread_mutex_init(&pipe->lock, NULL);
+	pthread_cond_init(&pipe->moved, NULL);
+	pipe->to_tok = ds_new_Ring(SZ_PSR_PIPE_DEPTH + 1);
+	pipe->to_psr = ds_new_Ring(SZ_PSR_PIPE_DEPTH + 1);
+	pipe->empty = ds_new_Ring(SZ_PSR_PIPE_DEPTH + 1);
+
+	ASize i;
+	for (i = 0; i<SZ_PSR_PIPE_DEPTH; i++)
+		pipe->cargos[i] = (i == 0)? first: tk_new_Cargo();
+
+	if ((pipe->to_tok == NULL) || (pipe->to_psr == NULL) || (pipe->empty == NULL))
+		return ERR_DS_STRUCT_GEN_FAIL;
+	for (i = 0; i<SZ_PSR_PIPE_DEPTH; i++) {
+		if (pipe->cargos[i] == NULL)
+			return ERR_DS_STRUCT_GEN_FAIL;
+		pipe->empty->push(pipe->empty, (void*)pipe->cargos[i]);
 	}
 
 	return SUCCESS;
 }
 
-ParserInterface* psr_new_ParserInterface(IList*  ilist, EWList* elist, SymTable* stable, DList* dlist, MnMap* mnemonic_map, RegMap* reg_map, FILE* file) {
-	if ((ilist == NULL) || (elist == NULL) || (stable == NULL) || (file == NULL) || (dlist == NULL) || (mnemonic_map == NULL) || (reg_map == NULL))
+static void _psr_release_Pipeline(Pipeline* pipe) {	/* Free whatever `_psr_init_Pipeline` managed to allocate  */
+	ASize i;
+	for (i = 1; i<SZ_PSR_PIPE_DEPTH; i++) {
+		if (pipe->cargos[i] != NULL)
+			pipe->cargos[i]->destroy(pipe->cargos[i], TRUE);
+	}
+
+	if (pipe->to_tok != NULL)
+		pipe->to_tok->destroy(pipe->to_tok);
+	if (pipe->to_psr != NULL)
+		pipe->to_psr->destroy(pipe->to_psr);
+	if (pipe->empty != NULL)
+		pipe->empty->destroy(pipe->empty);
+	pthread_cond_destroy(&pipe->moved);
+	pthread_mutex_destroy(&pipe->lock);
+}
+
+AErr psr_ParserInterface_parse(ParserInterface* pi, FILE* file) {
+	if (pi == NULL)
+		return ERR_INVALID_INTERFACE;
+
+	if (file == NULL)
+		return ERR_FILE_INVALID_FILE;
+
+	ASize workers = pi->workers;
+	if (workers == SZ_PSR_AUTO_THREAD) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN);	/* One worker per online processor  */
+		workers = (online > 0)? (ASize)online: 1;
+	}
+
+	TokInterface* ti = tk_new_TokInterface(file, workers, pi->assembly);
+	if (ti == NULL)
+		return ERR_INTERFACE_GEN_FAIL;
+
+	Cargo* cargo = tk_new_Cargo();
+	if (cargo == NULL) {
+		ti->destroy(ti);
+		return ERR_DS_STRUCT_GEN_FAIL;
+	}
+	pi->cargo = cargo;
+
+	pi->pool = _psr_new_ParsePool(workers, pi->assembly);
+	if (pi->pool == NULL) {
+		ti->destroy(ti);
+		return ERR_INTERFACE_GEN_FAIL;
+	}
+
+	Pipeline pipe;
+	if (_psr_init_Pipeline(&pipe, ti, cargo) != SUCCESS) {
+		_psr_release_Pipeline(&pipe);
+		_psr_destroy_ParsePool(pi->pool);
+		pi->pool = NULL;
+		ti->destroy(ti);
+		return ERR_DS_STRUCT_GEN_FAIL;
+	}
+
+	/* Reading, tokenizing and parsing overlap on three threads. Windows reach the
+	 * parser in source order, and the address counter and the symbol table live
+	 * in the interface, so they carry across windows as before. The parser takes
+	 * windows in batches big enough to give every pool worker a full chunk, and
+	 * splits the Jars of a batch in chunks over the parse pool.   */
+	pthread_t reader, tokenizer;
+	if (pthread_create(&tokenizer, NULL, _psr_Pipeline_tokenizer, (void*)&pipe) != 0) {
+		_psr_release_Pipeline(&pipe);
+		_psr_destroy_ParsePool(pi->pool);
+		pi->pool = NULL;
+		ti->destroy(ti);
+		return ERR_INTERFACE_GEN_FAIL;
+	}
+	if (pthread_create(&reader, NULL, _psr_Pipeline_reader, (void*)&pipe) != 0) {
+		_psr_Pipeline_push(&pipe, pipe.to_tok, NULL);	/* The tokenizer stage has no reader to wait for  */
+		_psr_Pipeline_fail(&pipe, ERR_INTERFACE_GEN_FAIL);
+		pthread_join(tokenizer, NULL);
+		_psr_release_Pipeline(&pipe);
+		_psr_destroy_ParsePool(pi->pool);
+		pi->pool = NULL;
+		ti->destroy(ti);
+		return ERR_INTERFACE_GEN_FAIL;
+	}
+
+	ABool end = FALSE;
+	while (end == FALSE) {		/* Stage 3: check the grammar of the windows in order  */
+		Cargo* batch[SZ_PSR_PARSE_BATCH];
+		ASize size = 0;
+		ASize jars = 0;
+		while ((size < SZ_PSR_PARSE_BATCH) && (jars < pi->pool->size*SZ_PSR_CHUNK_MIN_JARS)) {
+			Cargo* window = _psr_Pipeline_pop(&pipe, pipe.to_psr);
+			if (window == NULL) {
+				end = TRUE;
+				break;
+			}
+			batch[size++] = window;
+			jars += window->size;
+		}
+
+		if ((size > 0) && (_psr_Pipeline_status(&pipe) == SUCCESS)) {
+			AErr eno = _psr_parse_batch(pi, batch, size);
+			if (eno != SUCCESS)
+				_psr_Pipeline_fail(&pipe, eno);	/* Rows or errors were lost, stop every stage  */
+			else if (pi->elist->exhausted(pi->elist) == TRUE)
+				_psr_Pipeline_fail(&pipe, WARN_PSR_ERROR_BUDGET);	/* Stops the reader and the tokenizer  */
+		}
+
+		ASize i;
+		for (i = 0; i<size; i++) {
+			_psr_unload_cargo(batch[i]);
+			_psr_Pipeline_push(&pipe, pipe.empty, batch[i]);
+		}
+	}
+
+	pthread_join(reader, NULL);
+	pthread_join(tokenizer, NULL);
+
+	AErr status = _psr_Pipeline_status(&pipe);
+	if (status == WARN_PSR_ERROR_BUDGET)
+		status = SUCCESS;		/* Not a failure of the parse, the caller sees it in the list  */
+	pi->status = status;
+	_psr_release_Pipeline(&pipe);
+	_psr_destroy_ParsePool(pi->pool);
+	pi->pool = NULL;
+	ti->destroy(ti);
+	return status;
+}
+
+ParserInterface* psr_new_ParserInterface(IList*  ilist, EWList* elist, SymTable* stable, DList* dlist, MnMap* mnemonic_map, RegMap* reg_map, FILE* file, Assembly* assembly) {
+	if ((ilist == NULL) || (elist == NULL) || (stable == NULL) || (file == NULL) || (dlist == NULL) || (mnemonic_map == NULL) || (reg_map == NULL) || (assembly == NULL))
 		return NULL;
 
 	ParserInterface* pi = (ParserInterface*)malloc(sizeof(ParserInterface));
@@ -544,6 +1089,13 @@ ParserInterface* psr_new_ParserInterface(IList*  ilist, EWList* elist, SymTable*
 	pi->file = file;
 	pi->reg_map = reg_map;
 	pi->mnemonic_map = mnemonic_map;
+	pi->assembly = assembly;
+	pi->cargo = NULL;
+	pi->status = 0;
+	pi->address_counter = 0;
+	pi->pool = NULL;
+	pi->workers = SZ_PSR_AUTO_THREAD;
+	pi->sink = NULL;
 	
 	pi->destroy = psr_destroy_ParserInterface;
 	pi->parse = psr_ParserInterface_parse;
@@ -0,0 +1,126 @@
+/******************************************************
+ *	Line Scanner
+ *
+ *	The scanner classifies a whole block of bytes with
+ *	a handful of vector compares and turns the result
+ *	into three bit masks: newlines, comment separators
+ *	and non-blank bytes. Lines are then cut out of the
+ *	masks with count-trailing-zeros, so the bytes of a
+ *	line are looked at exactly once.
+ *
+ *	Bytes that do not fill a whole block (the tail of
+ *	the source) go through the scalar loop, which is
+ *	also the only path on targets without SSE2.
+ ******************************************************/
+
+#include <tokenizer/scanner.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define _TK_SCAN_BLOCK 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define _TK_SCAN_BLOCK 16
+#endif
+
+#define _TK_SCAN_NONE ((ASize)-1)	/* Marker for a field not found yet  */
+
+static void _tk_scan_emit(LineSpan* span, ASize start, ASize end, ASize comment, ASize text) {
+	span->start = start;
+	span->end = end;
+	span->comment = (comment == _TK_SCAN_NONE)? end: comment;
+	span->text = (text == _TK_SCAN_NONE)? end: text;
+}
+
+static ABool _tk_scan_blank(char c) {	/* Same set as `isspace` in the C locale  */
+	return ((c == ' ') || ((c >= '\t') && (c <= '\r')))? TRUE: FALSE;
+}
+
+#ifdef _TK_SCAN_BLOCK
+static void _tk_scan_block(const char* block, unsigned int* nl, unsigned int* cm, unsigned int* nb) {	/* Newline, comment and non-blank masks of a block  */
+#if defined(__AVX2__)
+	__m256i v = _mm256_loadu_si256((const __m256i*)block);
+	__m256i ctl = _mm256_sub_epi8(v, _mm256_set1_epi8('\t'));		/* '\t'..'\r' become 0..4  */
+	__m256i blank = _mm256_or_si256(
+		_mm256_cmpeq_epi8(_mm256_min_epu8(ctl, _mm256_set1_epi8(4)), ctl),
+		_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+
+	*nl = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+	*cm = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(SEPARATOR_COMMENT)));
+	*nb = ~(unsigned int)_mm256_movemask_epi8(blank);
+#else
+	__m128i v = _mm_loadu_si128((const __m128i*)block);
+	__m128i ctl = _mm_sub_epi8(v, _mm_set1_epi8('\t'));			/* '\t'..'\r' become 0..4  */
+	__m128i blank = _mm_or_si128(
+		_mm_cmpeq_epi8(_mm_min_epu8(ctl, _mm_set1_epi8(4)), ctl),
+		_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+
+	*nl = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+	*cm = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(SEPARATOR_COMMENT)));
+	*nb = ~(unsigned int)_mm_movemask_epi8(blank) & 0xFFFFu;
+#endif
+}
+#endif
+
+ASize tk_scan_lines(const char* buffer, ASize size, ASize pos, LineSpan* spans, ASize max) {	/* Returns the number of lines indexed; the next line starts at the last `end`  */
+	if ((buffer == NULL) || (spans == NULL))
+		return 0;
+
+	ASize count = 0;
+	ASize start = pos;
+	ASize comment = _TK_SCAN_NONE;
+	ASize text = _TK_SCAN_NONE;
+
+	while ((pos<size) && (count<max)) {
+#ifdef _TK_SCAN_BLOCK
+		if (size - pos >= _TK_SCAN_BLOCK) {
+			unsigned int nl, cm, nb;
+			_tk_scan_block(buffer + pos, &nl, &cm, &nb);
+
+			while (1) {
+				unsigned int before = (nl == 0)? ~0u: (nl & (0u - nl)) - 1;	/* Bytes ahead of the next newline  */
+				if ((text == _TK_SCAN_NONE) && ((nb & before) != 0))
+					text = pos + (ASize)__builtin_ctz(nb & before);
+				if ((comment == _TK_SCAN_NONE) && ((cm & before) != 0))
+					comment = pos + (ASize)__builtin_ctz(cm & before);
+				if (nl == 0)
+					break;
+
+				ASize eol = pos + (ASize)__builtin_ctz(nl) + 1;
+				_tk_scan_emit(&spans[count++], start, eol, comment, text);
+				if (count == max)
+					return count;
+
+				start = eol;
+				comment = _TK_SCAN_NONE;
+				text = _TK_SCAN_NONE;
+
+				unsigned int rest = ~((nl & (0u - nl)) | before);	/* Drop the line just cut  */
+				nl &= rest;
+				cm &= rest;
+				nb &= rest;
+			}
+
+			pos += _TK_SCAN_BLOCK;
+			continue;
+		}
+#endif
+		char c = buffer[pos++];
+		if (c == '\n') {
+			_tk_scan_emit(&spans[count++], start, pos, comment, text);
+			start = pos;
+			comment = _TK_SCAN_NONE;
+			text = _TK_SCAN_NONE;
+			continue;
+		}
+		if ((text == _TK_SCAN_NONE) && (_tk_scan_blank(c) == FALSE))
+			text = pos - 1;
+		if ((comment == _TK_SCAN_NONE) && (c == SEPARATOR_COMMENT))
+			comment = pos - 1;
+	}
+
+	if ((start<size) && (pos>=size) && (count<max))	/* Last line without a newline  */
+		_tk_scan_emit(&spans[count++], start, size, comment, text);
+
+	return count;
+}
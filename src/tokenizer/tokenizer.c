@@ -21,6 +21,10 @@
  ******************************************************/
 
 #include <tokenizer/tokenizer.h>
+#include <ctype.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /* ***************************************************
  * Functions for Data Structures
@@ -48,6 +52,9 @@ Token* tk_new_Token(AType type, AString token) {
 
 	tk->type = type;
 	tk->token = token;
+	tk->length = (token != NULL)? strlen(token): 0;
+	tk->packed = ds_pack_key(token, tk->length);
+	tk->id = UNSET_DS_INTERN;
 	tk->lno = UNSET_TOK_LINE;
 	tk->cno = UNSET_TOK_COL;
 
@@ -56,6 +63,53 @@ Token* tk_new_Token(AType type, AString token) {
 	return tk;
 }
 
+static void _tk_release_Token(Token* tk) {	/* Tokens carved from an arena go back with the arena reset  */
+	(void)tk;
+}
+
+static Token* _tk_Arena_new_Token(Arena* arena, AType type, const char* text, ASize length) {	/* Token and its text bump allocated from `arena`  */
+	Token* tk = (Token*)arena->alloc(arena, sizeof(Token));
+	if (tk == NULL)
+		return NULL;
+
+	tk->token = arena->strndup(arena, text, length);
+	if (tk->token == NULL)
+		return NULL;
+
+	tk->type = type;
+	tk->length = length;
+	tk->packed = ds_pack_key(text, length);
+	tk->id = UNSET_DS_INTERN;
+	tk->lno = UNSET_TOK_LINE;
+	tk->cno = UNSET_TOK_COL;
+
+	tk->destroy = _tk_release_Token;
+
+	return tk;
+}
+
+static Token* _tk_Arena_new_Word(Arena* arena, Interner* interner, InternCache* cache, AType type, const char* text, ASize length) {	/* Token whose text is interned instead of copied  */
+	AInt32 id = interner->intern(interner, cache, text, length);
+	if (id == UNSET_DS_INTERN)
+		return NULL;
+
+	Token* tk = (Token*)arena->alloc(arena, sizeof(Token));
+	if (tk == NULL)
+		return NULL;
+
+	tk->token = interner->string(interner, id);
+	tk->type = type;
+	tk->length = length;
+	tk->packed = ds_pack_key(text, length);
+	tk->id = id;
+	tk->lno = UNSET_TOK_LINE;
+	tk->cno = UNSET_TOK_COL;
+
+	tk->destroy = _tk_release_Token;
+
+	return tk;
+}
+
 /**
  * Functions for Jar Data Structure
 * ---------------------------------------*/
@@ -64,54 +118,78 @@ void tk_destroy_Jar(Jar* jar) {
 	if (jar == NULL)
 		return;
 
-	int i;
-	Token* prev = NULL;
-	Token* cur = jar->tokens;
-	for (i = 0; i<(jar->size); i++) {
-		prev = cur->next;
-		prev->destroy(prev);
+	ASize i;
+	for (i = 0; i<jar->size; i++) {
+		Token* token = jar->get(jar, i);
+		token->destroy(token);
 	}
 
+	free(jar->spill);
 	free(jar);
 	jar = NULL;
 }
 
+static AErr _tk_Jar_grow_spill(Jar* jar) {	/* Double the overflow array; arena Jars never give the old one back  */
+	ASize capacity = (jar->spill_cap == 0)? SZ_TOK_JAR_INLINE: jar->spill_cap*2;
+	Token** spill = NULL;
+
+	if (jar->arena == NULL) {
+		spill = (Token**)realloc(jar->spill, capacity*sizeof(Token*));
+		if (spill == NULL)
+			return ERR_MEM_REALLOC_FAIL;
+	} else {
+		spill = (Token**)jar->arena->alloc(jar->arena, capacity*sizeof(Token*));
+		if (spill == NULL)
+			return ERR_MEM_ALLOC_FAIL;
+		if (jar->spill_cap > 0)
+			memcpy(spill, jar->spill, jar->spill_cap*sizeof(Token*));
+	}
+
+	jar->spill = spill;
+	jar->spill_cap = capacity;
+	return SUCCESS;
+}
+
 AErr tk_Jar_put(Jar* jar, Token* token) {
 	if (jar == NULL)
 		return ERR_TOK_INVALID_JAR;
 
 	if (token == NULL)
 		return ERR_TOK_INVALID_JAR;
-	
-	int i;
-	Token* cur = jar->tokens;
-	if (cur = NULL) {
-		jar->tokens = token;
+
+	if (jar->size < SZ_TOK_JAR_INLINE) {
+		jar->tokens[jar->size++] = token;
 		return SUCCESS;
 	}
 
-	token->next = jar->tokens;
-	jar->tokens = token;
+	ASize index = jar->size - SZ_TOK_JAR_INLINE;
+	if ((index >= jar->spill_cap) && (_tk_Jar_grow_spill(jar) != SUCCESS))
+		return ERR_DS_INSERT_FAIL;
+
+	jar->spill[index] = token;
 	jar->size += 1;
 	return SUCCESS;
 }
 
 Token* tk_Jar_get(const Jar* jar, ASize index) {
 	if (jar == NULL)
-		return ERR_TOK_INVALID_JAR;
-	if ((index>=jar->size) || (index<0))
+		return NULL;
+	if (index>=jar->size)
 		return NULL;
 
-	index = jar->size-1-index;
-	Token* cur = jar->tokens;
-	int i;
-	for (i = 0; i<index; i++) {
-		if (cur == NULL)
-			return ERR_TOK_INVALID_TOKEN;
-		cur = cur->next;
-	}
+	return (index < SZ_TOK_JAR_INLINE)? jar->tokens[index]: jar->spill[index - SZ_TOK_JAR_INLINE];
+}
 
-	return cur;
+static void _tk_Jar_init(Jar* jar, Arena* arena, ASize lno) {
+	jar->size = 0;
+	jar->spill_cap = 0;
+	jar->spill = NULL;
+	jar->arena = arena;
+	jar->lno = lno;
+
+	jar->destroy = tk_destroy_Jar;
+	jar->put = tk_Jar_put;
+	jar->get = tk_Jar_get;
 }
 
 Jar* tk_new_Jar(ASize lno) {
@@ -119,14 +197,21 @@ Jar* tk_new_Jar(ASize lno) {
 	if (jar == NULL)
 		return NULL;
 
-	jar->size = 0;
-	jar->tokens = NULL;
-	jar->lno = lno;
+	_tk_Jar_init(jar, NULL, lno);
+	return jar;
+}
 
-	jar->destroy = tk_destroy_Jar;
-	jar->put = tk_Jar_put;
-	jar->get = tk_Jar_get;
+static void _tk_release_Jar(Jar* jar) {	/* Jars carved from an arena go back with the arena reset  */
+	(void)jar;
+}
 
+static Jar* _tk_Arena_new_Jar(Arena* arena, ASize lno) {	/* Jar bump allocated from `arena`; its spill comes from there too  */
+	Jar* jar = (Jar*)arena->alloc(arena, sizeof(Jar));
+	if (jar == NULL)
+		return NULL;
+
+	_tk_Jar_init(jar, arena, lno);
+	jar->destroy = _tk_release_Jar;
 	return jar;
 }
 
@@ -147,6 +232,15 @@ void tk_destroy_Packet(Packet* packet, ABool erase_content) {
 	packet = NULL;
 }
 
+static void _tk_destroy_crated_Packet(Packet* packet, ABool erase_content) {	/* Packets living in a Crate only own their content  */
+	if (packet == NULL)
+		return;
+
+	if ((erase_content == TRUE) && (packet->owned == TRUE) && (packet->content != NULL))
+		free(packet->content);
+	packet->content = NULL;
+}
+
 AString tk_Packet_get(const Packet* packet) {
 	if (packet == NULL)
 		return NULL;
@@ -154,16 +248,25 @@ AString tk_Packet_get(const Packet* packet) {
 	return (AString)(packet->content);
 }
 
+static void _tk_Packet_init(Packet* packet, void* content, ASize lno) {
+	packet->content = content;
+	packet->lno = lno;
+	packet->offset = 0;
+	packet->length = 0;
+	packet->text = 0;
+	packet->comment = 0;
+	packet->owned = TRUE;
+	packet->mark = 0;
+	packet->destroy = tk_destroy_Packet;
+	packet->get = tk_Packet_get;
+}
+
 Packet* tk_new_Packet(void* content, ASize lno) {
 	Packet* packet = (Packet*)malloc(sizeof(Packet));
 	if (packet == NULL)
 		return NULL;
 
-	packet->content = content;
-	packet->lno = lno;
-	packet->next = NULL;
-	packet->destroy = tk_destroy_Packet;
-	
+	_tk_Packet_init(packet, content, lno);
 	return packet;
 }
 
@@ -171,49 +274,115 @@ Packet* tk_new_Packet(void* content, ASize lno) {
  * Functions for Cargo Data Structure
  * ---------------------------------------*/
 
-void tk_destroy_Cargo(Cargo* cargo, ABool erase_content) {
+void tk_Cargo_clear(Cargo* cargo, ABool erase_content) {	/* Drop all the packets so that the Cargo can carry the next window; the Crates are kept  */
 	if (cargo == NULL)
 		return;
 
-	if (cargo->size > 0) {	/* Destroy all the packets */
-		int i;
-		Packet* prev = NULL;
-		Packet* cur = cargo->front;
-		for (i = 0; i<cargo->size; i++) {
-			prev = cur;
-			if (prev == NULL)
-				break;
-			cur = cur->next;
-			prev->destroy(prev, erase_content);
-		}
+	ASize i;
+	for (i = 0; i<cargo->size; i++) {
+		Packet* packet = &cargo->crates[i >> SZ_TOK_CARGO_CRATE_SHIFT][i & (cargo->crate_size - 1)];
+		packet->destroy(packet, erase_content);
 	}
 
+	for (i = 0; i<SZ_TOK_IF_MAX_THREAD; i++) {	/* Every Jar of the window goes at once  */
+		if (cargo->arenas[i] != NULL)
+			cargo->arenas[i]->reset(cargo->arenas[i]);
+	}
+
+	cargo->size = 0;
+	cargo->jarified = 0;
+}
+
+void tk_destroy_Cargo(Cargo* cargo, ABool erase_content) {
+	if (cargo == NULL)
+		return;
+
+	tk_Cargo_clear(cargo, erase_content);
+
+	ASize i;
+	for (i = 0; i<cargo->crate_num; i++)
+		free(cargo->crates[i]);
+	free(cargo->crates);
+	for (i = 0; i<SZ_TOK_IF_MAX_THREAD; i++) {
+		if (cargo->arenas[i] != NULL)
+			cargo->arenas[i]->destroy(cargo->arenas[i]);
+	}
+	free(cargo->text);
 	free(cargo);
 	cargo = NULL;
 }
 
+static Packet* _tk_Cargo_next_slot(Cargo* cargo) {	/* Reserve the packet after `back`, adding a Crate when the last one is full  */
+	ASize crate = cargo->size >> SZ_TOK_CARGO_CRATE_SHIFT;
+
+	if (crate == cargo->crate_num) {
+		if (cargo->crate_num == cargo->crate_cap) {	/* Only the Crate directory moves; packets keep their address  */
+			ASize cap = (cargo->crate_cap == 0)? 8: cargo->crate_cap*2;
+			Packet** crates = (Packet**)realloc(cargo->crates, cap*sizeof(Packet*));
+			if (crates == NULL)
+				return NULL;
+			cargo->crates = crates;
+			cargo->crate_cap = cap;
+		}
+
+		Packet* packets = (Packet*)malloc(cargo->crate_size*sizeof(Packet));
+		if (packets == NULL)
+			return NULL;
+		cargo->crates[cargo->crate_num++] = packets;
+	}
+
+	Packet* packet = &cargo->crates[crate][cargo->size & (cargo->crate_size - 1)];
+	cargo->size += 1;
+	return packet;
+}
+
 AErr tk_Cargo_load(Cargo* cargo, ASize lno, void* stuff) {
 	if (cargo == NULL)
 		return ERR_TOK_INVALID_CARGO;
 	if (stuff == NULL)
 		return SUCCESS;	/* Add Warning instead for Null pointer insertion  */
 
-	Packet* packet = tk_new_Packet(stuff, lno);
+	Packet* packet = _tk_Cargo_next_slot(cargo);
 	if (packet == NULL)
 		return ERR_TOK_INVALID_PACKET;
 
-	if (cargo->front == NULL) {
-		cargo->front = packet;
-		cargo->back = packet;
-		cargo->size = 1;
+	_tk_Packet_init(packet, stuff, lno);
+	packet->destroy = _tk_destroy_crated_Packet;
+	return SUCCESS;
+}
 
-		return SUCCESS;
-	}
+static void _tk_Packet_set_span(Packet* packet, const LineSpan* span) {	/* Record where the line, its text and its comment sit  */
+	packet->offset = span->start;
+	packet->length = span->end - span->start;
+	packet->text = span->text - span->start;
+	packet->comment = span->comment - span->start;
+}
 
-	packet->prev = cargo->back;
-	cargo->back->next = packet;
-	cargo->back = packet;
-	cargo->size += 1;
+AErr tk_Cargo_load_span(Cargo* cargo, ASize lno, const LineSpan* span) {	/* Load a line as a span into the mapped source, the text is not copied  */
+	if (cargo == NULL)
+		return ERR_TOK_INVALID_CARGO;
+	if (span == NULL)
+		return ERR_TOK_INVALID_PACKET;
+
+	Packet* packet = _tk_Cargo_next_slot(cargo);
+	if (packet == NULL)
+		return ERR_TOK_INVALID_PACKET;
+
+	_tk_Packet_init(packet, NULL, lno);
+	packet->destroy = _tk_destroy_crated_Packet;
+	_tk_Packet_set_span(packet, span);
+	return SUCCESS;
+}
+
+static AErr _tk_Cargo_reserve_arenas(Cargo* cargo, ASize count) {	/* Make sure the first `count` worker arenas exist  */
+	ASize i;
+	for (i = 0; i<count; i++) {
+		if (cargo->arenas[i] == NULL) {
+			cargo->arenas[i] = ds_new_Arena(SZ_TOK_ARENA_CHUNK);
+			if (cargo->arenas[i] == NULL)
+				return ERR_DS_STRUCT_GEN_FAIL;
+		}
+	}
 
 	return SUCCESS;
 }
@@ -222,21 +391,10 @@ static Packet* _tk_Cargo_get_packet(const Cargo* cargo, ASize index) {
 	if (cargo == NULL)
 		return NULL;
 
-	if ((index>=cargo->size) || (index<0))
-		return NULL;
-	
-	if (cargo->front == NULL)
+	if (index>=cargo->size)
 		return NULL;
 
-	Packet* cur = cargo->front;
-	int i;
-	for (i = 0; i<index; i++) {
-		if (cur == NULL)
-			return NULL;
-		cur = cur->next;
-	}
-
-	return cur;
+	return &cargo->crates[index >> SZ_TOK_CARGO_CRATE_SHIFT][index & (cargo->crate_size - 1)];
 }
 
 void* tk_Cargo_get(const Cargo* cargo, ASize index) {
@@ -252,8 +410,26 @@ Cargo* tk_new_Cargo() {
 	if (cargo == NULL)
 		return NULL;
 
+	cargo->size = 0;
+	cargo->crate_num = 0;
+	cargo->crate_size = (ASize)1 << SZ_TOK_CARGO_CRATE_SHIFT;
+	cargo->crate_cap = 0;
+	cargo->crates = NULL;
+	cargo->jarified = 0;
+	cargo->mark = 0;
+	cargo->text = NULL;
+	cargo->text_len = 0;
+	cargo->text_cap = 0;
+	cargo->status = 0;
+
+	ASize i;
+	for (i = 0; i<SZ_TOK_IF_MAX_THREAD; i++)
+		cargo->arenas[i] = NULL;
+
 	cargo->destroy = tk_destroy_Cargo;
+	cargo->clear = tk_Cargo_clear;
 	cargo->load = tk_Cargo_load;
+	cargo->loadSpan = tk_Cargo_load_span;
 	cargo->get = tk_Cargo_get;
 
 	return cargo;
@@ -264,367 +440,1186 @@ Cargo* tk_new_Cargo() {
  * Functions for Tokenizer
  * ***************************************************/
 
-static ABool _tk_TokInterface_ignorable_check(AString line) {	/* Returns True if line is all just comments or Black line   */
+static void _tk_Tokenizer_remove_newlines(AString line) {
 	if (line == NULL)
-		return TRUE;
+		return;
 
 	ASize length = strlen(line);
 	ASize i;
-
-	/* Check for Black Lines  */
-	ABool white_space = TRUE;
 	for (i = 0; i<length; i++) {
-		if (!isspace(line[i]))
-			white_space = FALSE;
+		if ((line[i] == '\n') || (line[i] == '\r'))
+			line[i] = ' ';
 	}
+}
 
-	if (white_space)
-		return TRUE;
+/* Character classes of the lexer  */
+#define _TK_CC_WORD	0	/* Part of a token  */
+#define _TK_CC_BLNK	1	/* Whitespace, same set as `isspace`  */
+#define _TK_CC_COLN	2	/* `:` ends a label and separates tokens  */
+#define _TK_CC_COMA	3	/* `,` separates operands  */
+
+static const unsigned char _tk_char_class[256] = {
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x00  */
+	_TK_CC_WORD, _TK_CC_BLNK, _TK_CC_BLNK, _TK_CC_BLNK, _TK_CC_BLNK, _TK_CC_BLNK, _TK_CC_WORD, _TK_CC_WORD,	/* 0x08  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x10  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x18  */
+	_TK_CC_BLNK, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x20  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_COMA, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x28  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x30  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_COLN, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x38  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x40  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x48  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x50  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x58  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x60  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x68  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x70  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x78  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x80  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x88  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x90  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0x98  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0xA0  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0xA8  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0xB0  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0xB8  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0xC0  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0xC8  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0xD0  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0xD8  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0xE0  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0xE8  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD,	/* 0xF0  */
+	_TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD, _TK_CC_WORD	/* 0xF8  */
+};
+
+/* Label detection states of the lexer  */
+#define _TK_LBL_FIRST	0	/* Inside the first blank separated word  */
+#define _TK_LBL_AFTER	1	/* Past the first word, waiting for a `:`  */
+#define _TK_LBL_YES		2	/* The first token is a label  */
+#define _TK_LBL_NO		3	/* The first token is not a label  */
+
+static AType _tk_Tokenizer_token_type(char first) {	/* Type of a non-label token from its first character  */
+	if (first == '.')
+		return TYPE_TOK_DIRECTIVE;
+	if (isdigit((unsigned char)first) || (first == '-') || (first == '+'))
+		return TYPE_TOK_NUMBER;
+	return TYPE_TOK_WORD;
+}
 
-	/* Check for All Comment Line   */
-	ABool non_comment = FALSE;
+static AErr _tk_Tokenizer_put_tokens(Jar* jar, Arena* arena, Interner* interner, InternCache* cache, const char* line, ASize text, ASize end) {	/* Lex line[text, end) into typed tokens in a single walk   */
 
-	for (i = 0; i<length; i++) {
-		if (line[i] == SEPARATOR_COMMENT) {
-			if (non_comment == TRUE)
-				return FALSE;
-			else
-				return TRUE;
+	if (jar == NULL)
+		return ERR_TOK_INVALID_JAR;
+
+	if (line == NULL)
+		return ERR_STR_INVALID_STRING;
+
+	/* The first token is a label when the first word ends with `:`, or when
+	 * the next non-blank character after it is a `:`. Both are decided on
+	 * the way, the token is retyped once the answer is known.   */
+	AType label = _TK_LBL_FIRST;
+	Token* first = NULL;
+	ASize count = jar->size;
+
+	ASize i = text;
+	while (i<end) {
+		unsigned char cc = _tk_char_class[(unsigned char)line[i]];
+
+		if (cc == _TK_CC_WORD) {
+			ASize start = i;
+			while ((i<end) && (_tk_char_class[(unsigned char)line[i]] == _TK_CC_WORD))
+				i++;
+
+			/* Words (labels among them) are interned, so the parser and the tables
+			 * compare them by id; numbers and directives are copied as they are   */
+			AType type = _tk_Tokenizer_token_type(line[start]);
+			Token* tkn = (type == TYPE_TOK_WORD)?
+				_tk_Arena_new_Word(arena, interner, cache, type, line + start, i - start):
+				_tk_Arena_new_Token(arena, type, line + start, i - start);
+			if (tkn == NULL)
+				return ERR_DS_STRUCT_GEN_FAIL;
+			tkn->lno = jar->lno;
+			tkn->cno = start + 1;
+			if (jar->put(jar, tkn) != SUCCESS)
+				return ERR_DS_INSERT_FAIL;
+
+			if ((first == NULL) && (label == _TK_LBL_FIRST))
+				first = tkn;	/* Only a token of the first word can be a label  */
+			if (label == _TK_LBL_AFTER)
+				label = _TK_LBL_NO;
+			continue;
 		}
-		if (!((line[i] == ' ') || (line[i] == '\t')))
-			non_comment = TRUE;
+
+		if ((label == _TK_LBL_FIRST) && (cc == _TK_CC_BLNK))
+			label = (line[i-1] == ':')? _TK_LBL_YES: _TK_LBL_AFTER;
+		else if ((label == _TK_LBL_AFTER) && (cc != _TK_CC_BLNK))
+			label = (cc == _TK_CC_COLN)? _TK_LBL_YES: _TK_LBL_NO;
+		i++;
 	}
 
-	return FALSE;
-}
+	if ((label == _TK_LBL_FIRST) && (line[end-1] == ':'))	/* The first word runs to the end of the text   */
+		label = _TK_LBL_YES;
 
-static void _tk_Tokenizer_remove_newlines(AString line) {
-	if (line == NULL)
-		return;
+	if (jar->size == count)
+		return ERR_TOK_INVALID_TOKEN;
 
-	ASize length = strlen(line);
-	ASize i;
-	for (i = 0; i<length; i++) {
-		if (line[i] == '\n')
-			line[i] = ' ';
-	}
-}
+	if ((label == _TK_LBL_YES) && (first != NULL))
+		first->type = TYPE_TOK_LABEL;
 
-static void _tk_Tokenizer_remove_comment(AString line) {
-	if (line == NULL)
-		return;
+	return SUCCESS;
+}
 
-	ASize length = strlen(line);
-	ASize i;
-	for (i = 0; i<length; i++) {
-		if (line[i] == SEPARATOR_COMMENT) {
-			line[i] = '\0';
-			return;
-		}
+/* Conditional assembly is decided by the reader, before a line becomes a
+ * Packet. In a branch not taken only the first byte of a line is looked
+ * at, to find the `.if` and `.endif` lines that open and close blocks, so
+ * a disabled region costs the line scan and nothing else. The conditions
+ * see the `SET` constants of the lines read before them.  */
+
+#define _TK_KEY_IF			DS_PACK('.', 'i', 'f', 0, 0, 0, 0, 0)
+#define _TK_KEY_IFDEF		DS_PACK('.', 'i', 'f', 'd', 'e', 'f', 0, 0)
+#define _TK_KEY_ELSE		DS_PACK('.', 'e', 'l', 's', 'e', 0, 0, 0)
+#define _TK_KEY_ENDIF		DS_PACK('.', 'e', 'n', 'd', 'i', 'f', 0, 0)
+#define _TK_KEY_SET			DS_PACK('S', 'E', 'T', 0, 0, 0, 0, 0)
+
+/* What the reader does with a line  */
+#define _TK_LINE_KEEP		0	/* Loaded as a Packet  */
+#define _TK_LINE_DROP		1	/* A conditional line, counted but not loaded  */
+#define _TK_LINE_SKIP		2	/* A line of a branch not taken, neither counted nor loaded  */
+#define _TK_LINE_REJECT	3	/* Loaded with its first token marked, for the parser to report  */
+#define _TK_LINE_FAIL		4	/* Out of memory, the source is given up  */
+
+#define _TK_COND_ENABLED(ti)	(((ti)->skip_depth == 0) && (((ti)->cond_depth == 0) || (ti)->conds[(ti)->cond_depth - 1].active))
+
+static ASize _tk_Cond_words(const char* line, ASize pos, ASize end, ASize* start, ASize* length, ASize max) {	/* Split line[pos, end) at blanks into at most `max` words, returns the count  */
+	ASize count = 0;
+	while (pos<end) {
+		while ((pos<end) && (_tk_char_class[(unsigned char)line[pos]] == _TK_CC_BLNK))
+			pos++;
+		if (pos == end)
+			break;
+		if (count == max)
+			return max + 1;
+
+		start[count] = pos;
+		while ((pos<end) && (_tk_char_class[(unsigned char)line[pos]] != _TK_CC_BLNK))
+			pos++;
+		length[count] = pos - start[count];
+		count++;
 	}
+	return count;
 }
 
-static ABool _tk_Tokenizer_check_label(const AString line) {
-	if (line == NULL)
+static ABool _tk_Cond_number(const char* text, ASize length, AInt32* value) {	/* Read a number the way the parser does  */
+	char buffer[SZ_TOK_COND_OPERAND];
+	if ((length == 0) || (length >= SZ_TOK_COND_OPERAND))
 		return FALSE;
 
-	ASize buffSize = strlen(line);
-	buffSize = (buffSize+1 >= SZ_TOK_LINE_BUFF)? SZ_TOK_LINE_BUFF: buffSize+1;
-	AString buffer = (AString)malloc(buffSize);
-	/* Do something about this   */
-	if (buffer == NULL)
+	memcpy(buffer, text, length);
+	buffer[length] = '\0';
+	return (ds_operand_kind(buffer, value) == TYPE_DS_OPERAND_NUMBER)? TRUE: FALSE;
+}
+
+static ABool _tk_Cond_value(const TokInterface* ti, const char* text, ASize length, AInt32* value) {	/* A number, or a constant set before; FALSE otherwise  */
+	if (!isalpha((unsigned char)text[0]))
+		return _tk_Cond_number(text, length, value);
+
+	AInt32 id = ti->assembly->interner->lookup(ti->assembly->interner, text, length);
+	if ((id == UNSET_DS_INTERN) || (ti->constants->isConst(ti->constants, id) == FALSE))
 		return FALSE;
 
-	memcpy(buffer, line, buffSize-1);
-	buffer[buffSize - 1] = '\0';
+	*value = (AInt32)ti->constants->findId(ti->constants, id);
+	return TRUE;
+}
 
-	const AString delim = " \t\n";
-	AString token;
-	char* save_ptr;
-	token = strtok_r(buffer, delim, &save_ptr);
-	if (token == NULL) {
-		free(buffer);
+static ABool _tk_Cond_compare(AInt32 lhs, const char* op, ASize length, AInt32 rhs, ABool* result) {	/* Signed comparison, FALSE for an unknown operator  */
+	int a = (int)lhs, b = (int)rhs;
+	if ((length == 2) && (op[1] == '=')) {
+		switch (op[0]) {
+			case '=': *result = (a == b)? TRUE: FALSE; return TRUE;
+			case '!': *result = (a != b)? TRUE: FALSE; return TRUE;
+			case '<': *result = (a <= b)? TRUE: FALSE; return TRUE;
+			case '>': *result = (a >= b)? TRUE: FALSE; return TRUE;
+		}
 		return FALSE;
 	}
+	if ((length == 1) && (op[0] == '<')) {
+		*result = (a < b)? TRUE: FALSE;
+		return TRUE;
+	}
+	if ((length == 1) && (op[0] == '>')) {
+		*result = (a > b)? TRUE: FALSE;
+		return TRUE;
+	}
+	return FALSE;
+}
 
-	ASize length = strlen(token);
-	if (token[length - 1] == ':') {
-		free(buffer);
+static ABool _tk_Cond_test(const TokInterface* ti, APacked key, const char* line, const ASize* start, const ASize* length, ASize count, ABool* result) {	/* Decide `.ifdef name`, `.if value` or `.if value op value`  */
+	if (key == _TK_KEY_IFDEF) {
+		if (count != 2)
+			return FALSE;
+		AInt32 value;
+		*result = (isalpha((unsigned char)line[start[1]]) && _tk_Cond_value(ti, line + start[1], length[1], &value))? TRUE: FALSE;
 		return TRUE;
 	}
 
-	token = strtok_r(NULL, delim, &save_ptr);
-	if (token == NULL) {
-		free(buffer);
+	AInt32 lhs, rhs;
+	if ((count != 2) && (count != 4))
 		return FALSE;
-	}
-	
-	if (token[0] == ':') {
-		free(buffer);
+	if (_tk_Cond_value(ti, line + start[1], length[1], &lhs) == FALSE)
+		return FALSE;
+	if (count == 2) {
+		*result = (lhs != 0)? TRUE: FALSE;
 		return TRUE;
 	}
+	if (_tk_Cond_value(ti, line + start[3], length[3], &rhs) == FALSE)
+		return FALSE;
+	return _tk_Cond_compare(lhs, line + start[2], length[2], rhs, result);
+}
 
-	return FALSE;
+static AType _tk_TokInterface_cond_open(TokInterface* ti, APacked key, const char* line, const LineSpan* span, const ASize* start, const ASize* length, ASize count) {
+	ABool result = FALSE;
+	ABool valid = _tk_Cond_test(ti, key, line, start, length, count, &result);
+	if (ti->cond_depth == SZ_TOK_COND_DEPTH) {
+		ti->skip_depth++;	/* Too deep: reported, and read up to its `.endif`  */
+		return _TK_LINE_REJECT;
+	}
+
+	/* A condition that cannot be decided is reported and no branch of it is assembled  */
+	Cond* cond = &ti->conds[ti->cond_depth++];
+	cond->lno = ti->lno;
+	cond->active = result;
+	cond->taken = (valid == TRUE)? result: TRUE;
+	cond->in_else = FALSE;
+	cond->span = *span;
+	cond->text = NULL;
+	if (ti->mode != MODE_TOK_SRC_MMAP) {	/* The line buffer is reused, keep the line  */
+		cond->text = (AString)malloc(span->end - span->start + 1);
+		if (cond->text == NULL) {	/* The block could not be reported if left open  */
+			ti->cond_depth--;
+			ti->status = 1;
+			return _TK_LINE_FAIL;
+		}
+		memcpy(cond->text, line + span->start, span->end - span->start);
+		cond->text[span->end - span->start] = '\0';
+	}
+
+	return (valid == TRUE)? _TK_LINE_DROP: _TK_LINE_REJECT;
 }
 
-/* Remaining: To fix the edge case when line starts with `:`  */
-static AErr _tk_Tokenizer_put_tokens(Jar* jar, const AString line) {	/* Function to add non comments tokens into jar   */
+static AType _tk_TokInterface_filter(TokInterface* ti, const char* line, const LineSpan* span) {	/* Follow the conditional lines and tell what to do with a line  */
+	ABool enabled = _TK_COND_ENABLED(ti);
+	if (TK_LINE_IGNORABLE(span) || (line[span->text] != '.'))
+		return (enabled == TRUE)? _TK_LINE_KEEP: _TK_LINE_SKIP;
+
+	ASize start[4], length[4];
+	ASize count = _tk_Cond_words(line, span->text, span->comment, start, length, 4);
+	APacked key = ds_pack_key(line + start[0], length[0]);
+	ABool opens = ((key == _TK_KEY_IF) || (key == _TK_KEY_IFDEF))? TRUE: FALSE;
+	if ((opens == FALSE) && (key != _TK_KEY_ELSE) && (key != _TK_KEY_ENDIF))
+		return (enabled == TRUE)? _TK_LINE_KEEP: _TK_LINE_SKIP;
+
+	if (ti->skip_depth > 0) {	/* Only the nesting matters inside a block not read  */
+		if (opens == TRUE)
+			ti->skip_depth++;
+		else if (key == _TK_KEY_ENDIF)
+			ti->skip_depth--;
+		return _TK_LINE_SKIP;
+	}
 
-	if (jar == NULL)
-		return ERR_TOK_INVALID_JAR;
+	if (opens == TRUE) {
+		if (enabled == FALSE) {
+			ti->skip_depth++;
+			return _TK_LINE_SKIP;
+		}
+		return _tk_TokInterface_cond_open(ti, key, line, span, start, length, count);
+	}
 
-	if (line == NULL)
-		return ERR_STR_INVALID_STRING;
-	
-	ASize buffSize = strlen(line) + 1;
-	buffSize = (buffSize > SZ_TOK_LINE_BUFF)? SZ_TOK_LINE_BUFF: buffSize;
-	AString buff = (AString)malloc(buffSize);
-	/* Do something about this  repeated buffer allocations if possible */
-	if (buff == NULL)
-		return ERR_MEM_ALLOC_FAIL;
+	if (ti->cond_depth == 0)
+		return _TK_LINE_REJECT;	/* `.else` or `.endif` without `.if`  */
+
+	Cond* cond = &ti->conds[ti->cond_depth - 1];
+	if (key == _TK_KEY_ELSE) {
+		if (cond->in_else == TRUE)
+			return _TK_LINE_REJECT;
+		cond->in_else = TRUE;
+		cond->active = (cond->taken == TRUE)? FALSE: TRUE;
+		cond->taken = TRUE;
+	} else {
+		free(cond->text);
+		ti->cond_depth--;
+	}
 
-	memcpy(buff, line, buffSize);
-	buff[buffSize - 1] = '\0';
+	return (count == 1)? _TK_LINE_DROP: _TK_LINE_REJECT;
+}
 
-	/* Remove comments from the line   */
-	_tk_Tokenizer_remove_comment(buff);
+static void _tk_TokInterface_note_const(TokInterface* ti, const char* line, const LineSpan* span) {	/* Remember `name: SET value` for the conditions below it  */
+	ASize pos = span->text, end = span->comment;
+	ASize name = pos;
+	while ((pos<end) && (_tk_char_class[(unsigned char)line[pos]] == _TK_CC_WORD))
+		pos++;
+	ASize name_length = pos - name;
+	while ((pos<end) && (_tk_char_class[(unsigned char)line[pos]] == _TK_CC_BLNK))
+		pos++;
+	if ((name_length == 0) || (pos == end) || (line[pos] != ':'))
+		return;	/* Most lines stop here: no label  */
+
+	ASize start[3], length[3];
+	if (_tk_Cond_words(line, pos + 1, end, start, length, 2) != 2)
+		return;
+	if (ds_pack_key(line + start[0], length[0]) != _TK_KEY_SET)
+		return;
+
+	AInt32 value;
+	if (_tk_Cond_number(line + start[1], length[1], &value) == FALSE)
+		return;
+	AInt32 id = ti->assembly->interner->intern(ti->assembly->interner, NULL, line + name, name_length);
+	if ((id != UNSET_DS_INTERN) && (ti->constants->isConst(ti->constants, id) == FALSE))
+		ti->constants->insertConst(ti->constants, id, (AAddr)value);	/* The first value stays, as in the parser  */
+}
 
-	AString delim = "\t :\n,";
-	AString token;
-	AString save_ptr;
-	token = strtok_r(buff, delim, &save_ptr);
+static AType _tk_TokInterface_classify_line(TokInterface* ti, const char* line, const LineSpan* span) {	/* `_tk_TokInterface_filter`, with the constants noted on the way  */
+	AType fate = _tk_TokInterface_filter(ti, line, span);
+	if ((fate == _TK_LINE_KEEP) && (!TK_LINE_IGNORABLE(span)))
+		_tk_TokInterface_note_const(ti, line, span);
+	return fate;
+}
 
-	if (token == NULL)
-		return ERR_TOK_INVALID_TOKEN;
+static void _tk_Cargo_mark_last(Cargo* cargo, AType mark) {
+	_tk_Cargo_get_packet(cargo, cargo->size - 1)->mark = mark;
+}
 
-	ASize col = 1;
-	/* Label type token detected. Put it first into the jar   */
-	ABool result = _tk_Tokenizer_check_label(line);
-	if (result == TRUE) {
-		ASize length = strlen(token);
-		length = (length+1 >= SZ_TOK_TOKEN_LABEL)? SZ_TOK_TOKEN_LABEL: length+1;
-		AString label = (AString)malloc(length);
-		memcpy(label, token, length);
-		label[length-1] = '\0';	/* Pay careful attention here. Some bug fix might be needed   */
-
-		Token* tkn = tk_new_Token(TYPE_TOK_LABEL, label);
-		if (tkn == NULL) {
-			free(label);
-			return ERR_TOK_INVALID_TOKEN;
-		}
-		tkn->lno = jar->lno;
-		tkn->cno = col++;
-		tkn->token = label;
-		if (jar->put(jar, tkn) != SUCCESS) {
-			tkn->destroy(tkn);
-			return ERR_DS_INSERT_FAIL;
-		}
-		token = strtok_r(NULL, delim, &save_ptr);	/* Handle the case of double `:`   */
-	} 
-
-	ABool directive = TRUE;
-	/* Add other mnemonics into the jar   */
-	while (token != NULL) {
-		ASize length = strlen(token);
-		length = (length+1 >= SZ_TOK_TOKEN_MNEMONIC)? SZ_TOK_TOKEN_MNEMONIC: length+1;
-		AString mnemo = (AString)malloc(length);
-		memcpy(mnemo, token, length);
-		mnemo[length-1] = '\0';	/* Pay careful attention here. Some bug fix might be needed   */
-
-		Token* tkn = tk_new_Token(TYPE_TOK_WORD, mnemo);
-		if (tkn == NULL) {
-			free(mnemo);
-			return ERR_DS_STRUCT_GEN_FAIL;
-		}
-		tkn->lno = jar->lno;
-		tkn->cno = col++;
-		tkn->token = mnemo;
-		if (jar->put(jar, tkn) != SUCCESS) {
-			tkn->destroy(token);
-			return ERR_DS_INSERT_FAIL;
-		}
-		token = strtok_r(NULL, delim, &save_ptr);
+static AErr _tk_Cargo_put_line(Cargo* cargo, ASize lno, const char* line, LineSpan span) {	/* Copy a line into the text buffer of the Cargo and load it as a span  */
+	ASize length = span.end - span.start;
+	if (cargo->text_len + length > cargo->text_cap) {
+		ASize cap = (cargo->text_cap == 0)? SZ_TOK_WINDOW_BUFF: cargo->text_cap;
+		while (cap < cargo->text_len + length)
+			cap *= 2;
+		AString text = (AString)realloc(cargo->text, cap);
+		if (text == NULL)
+			return ERR_MEM_REALLOC_FAIL;
+		cargo->text = text;
+		cargo->text_cap = cap;
 	}
+	memcpy(cargo->text + cargo->text_len, line + span.start, length);
 
-	return SUCCESS;
+	span.text = span.text - span.start + cargo->text_len;	/* Rebase the span onto the text buffer   */
+	span.comment = span.comment - span.start + cargo->text_len;
+	span.end = span.end - span.start + cargo->text_len;
+	span.start = cargo->text_len;
+	cargo->text_len += length;
+
+	return cargo->loadSpan(cargo, lno, &span);
 }
 
-static AErr _tk_TokInterface_loadPackets(TokInterface* ti) {	/* Function to load Lines into Cargo as Packets. */
+static AErr _tk_TokInterface_close_conds(TokInterface* ti, Cargo* cargo) {	/* Report the blocks still open at the end of source at their `.if`  */
+	ASize i;
+	for (i = 0; i<ti->cond_depth; i++) {
+		Cond* cond = &ti->conds[i];
+		AErr status = SUCCESS;
+		if (ti->mode == MODE_TOK_SRC_MMAP) {
+			status = cargo->loadSpan(cargo, cond->lno, &cond->span);
+		} else if (cond->text != NULL) {
+			LineSpan span = cond->span;
+			span.text -= span.start;
+			span.comment -= span.start;
+			span.end -= span.start;
+			span.start = 0;
+			status = _tk_Cargo_put_line(cargo, cond->lno, cond->text, span);
+			free(cond->text);
+			cond->text = NULL;	/* Not freed again by `tk_destroy_TokInterface`  */
+		} else {
+			continue;
+		}
+		if (status != SUCCESS)
+			return ERR_TOK_CARGO_LOAD_FAIL;
+		_tk_Cargo_mark_last(cargo, TYPE_TOK_COND);
+	}
 
-	if (ti == NULL)
-		return ERR_INVALID_INTERFACE;
+	ti->cond_depth = 0;
+	ti->skip_depth = 0;
+	return SUCCESS;
+}
 
+static AErr _tk_TokInterface_loadLines(TokInterface* ti, Cargo* cargo) {	/* Load Lines into the text buffer of the Cargo and index them as spans (stream mode). */
 	FILE* file = ti->file;
 	if (file == NULL)
 		return ERR_FILE_INVALID_FILE;
-	
+
+	/* Lines are read whole with `getline` into one reused buffer, and only the
+	 * ones carrying text are appended to the text buffer of the Cargo; both only
+	 * grow to the longest line/window seen, so a line costs what it is long.   */
+	if (cargo->jarified == cargo->size)
+		cargo->text_len = 0;	/* No packet still needs the previous text  */
 	ASize lines_read = 0;
-	ASize cargo_size = 0;
-	AString buff = NULL;
 	while (lines_read<SZ_TOK_CARGO_PKT_WIN) {
-
-		if (ti->cargo->size != SZ_TOK_CARGO_PKT_WIN) {
-			buff = (AString)malloc(SZ_TOK_LINE_BUFF);
-		} else {
-			buff = ti->cargo->get(ti->cargo, lines_read);
-			if (buff == NULL)
-				buff = (AString)malloc(SZ_TOK_LINE_BUFF);
+		ssize_t read = getline(&ti->line, &ti->line_cap, file);
+		if (read < 0) {	/* If file ends and no content is read.  */
+			ti->status = 1;
+			break;
 		}
 
-		if (buff == NULL)
+		ti->lno++;
+		LineSpan span;
+		if (tk_scan_lines(ti->line, (ASize)read, 0, &span, 1) == 0)
+			continue;
+		AType fate = _tk_TokInterface_classify_line(ti, ti->line, &span);
+		if (fate == _TK_LINE_FAIL)
 			return ERR_MEM_ALLOC_FAIL;
+		if (fate == _TK_LINE_SKIP)
+			continue;	/* Lines of a branch not taken do not fill the window  */
 
-		if (fgets(buff, SZ_TOK_LINE_BUFF, file) == NULL) {	/* If file ends and no content is read.  */
-			free(buff);
-			buff = NULL;
-			break;
-		}
-		
-		if (_tk_TokInterface_ignorable_check(buff) == TRUE) {
-			lines_read++;
+		lines_read++;
+		if ((fate == _TK_LINE_DROP) || TK_LINE_IGNORABLE(&span))
 			continue;
-		}
-		if (ti->cargo->load(ti->cargo, lines_read + 1, (void*)buff) != SUCCESS)
-			return ERR_TOK_CARGO_LOAD_FAIL;
 
-		cargo_size++;
-		lines_read++;
+		if (_tk_Cargo_put_line(cargo, ti->lno, ti->line, span) != SUCCESS)
+			return ERR_TOK_CARGO_LOAD_FAIL;
+		if (fate == _TK_LINE_REJECT)
+			_tk_Cargo_mark_last(cargo, TYPE_TOK_COND);
 	}
 
-	ti->current_pos = ftell(file);
-	if (ti->current_pos == ti->file_size)
-		ti->status = 1;
-	else ti->status = 0;
-
-	ti->cargo->size = cargo_size;
-
+	long pos = ftell(file);
+	if (pos >= 0)
+		ti->current_pos = (ASize)pos;
 	return SUCCESS;
 }
 
-static AString _tk_TokInterface_token_comment(const AString line) {
-	if (line == NULL)
-		return NULL;
+static void _tk_TokInterface_release_source(TokInterface* ti, ASize mark) {	/* Hand the pages below `mark` back to the kernel once they are jarified   */
+	ASize page = (ASize)sysconf(_SC_PAGESIZE);
+	ASize upto = (mark / page) * page;
+	if (upto <= ti->released_pos)
+		return;
 
-	ASize length = strlen(line);
-	int i;
-	ABool comment = FALSE;
-	char* cur = line;
-	for (i = 0; i<length; i++) {
-		if (line[i] == SEPARATOR_COMMENT) {
-			comment = TRUE;
+	madvise(ti->source + ti->released_pos, upto - ti->released_pos, MADV_DONTNEED);
+	ti->released_pos = upto;
+}
+
+static AErr _tk_TokInterface_loadSpans(TokInterface* ti, Cargo* cargo) {	/* Load Lines into Cargo as spans into the mapped source (mmap mode). */
+	/* One pass over the window builds the line index; blank and comment-only
+	 * lines are dropped here and never reach a Packet. The lines of a branch
+	 * not taken are not counted, so the index is refilled until the window
+	 * has its lines or the source ends.   */
+	ASize budget = SZ_TOK_CARGO_PKT_WIN;
+	while ((budget > 0) && (ti->current_pos < ti->file_size)) {
+		ASize lines = tk_scan_lines(ti->source, ti->file_size, ti->current_pos, ti->index, budget);
+		if (lines == 0)
 			break;
+
+		ASize i;
+		for (i = 0; i<lines; i++) {
+			ti->lno++;
+			AType fate = _tk_TokInterface_classify_line(ti, ti->source, &ti->index[i]);
+			if (fate == _TK_LINE_SKIP)
+				continue;
+
+			budget--;
+			if ((fate == _TK_LINE_DROP) || TK_LINE_IGNORABLE(&ti->index[i]))
+				continue;
+			if (cargo->loadSpan(cargo, ti->lno, &ti->index[i]) != SUCCESS)
+				return ERR_TOK_CARGO_LOAD_FAIL;
+			if (fate == _TK_LINE_REJECT)
+				_tk_Cargo_mark_last(cargo, TYPE_TOK_COND);
 		}
-		cur = cur+1;
+		ti->current_pos = ti->index[lines - 1].end;
 	}
-	if (*cur != SEPARATOR_COMMENT)
-		return NULL;
-	
-	length = strlen(cur);
-	length = (length >= SZ_TOK_TOKEN_COMMENT)? SZ_TOK_TOKEN_COMMENT-1: length;
-	if (comment = FALSE)
-		return NULL;
-
-	AString buff = (AString)malloc(SZ_TOK_TOKEN_COMMENT);
-	if (buff == NULL)
-		return NULL;
 
-	memcpy(buff, cur, length);
-	buff[length] = '\0';
-	_tk_Tokenizer_remove_newlines(buff);
-	return buff;
+	if (ti->current_pos >= ti->file_size)
+		ti->status = 1;
+	return SUCCESS;
 }
 
-static void* _tk_TokInterface_jar_maker(void* line_ptr, ASize lno) {	/* Function to convert a string buffer to token Returns `NULL` on error  */
-	if (line_ptr == NULL)
-		return NULL;
-	
-	AString line = line_ptr;
+static AErr _tk_TokInterface_loadPackets(TokInterface* ti, Cargo* cargo) {	/* Function to load the next window of Lines into Cargo as Packets. */
 
+	if (ti->status != 0)
+		return SUCCESS;	/* Source is exhausted, the window stays empty   */
 
-	/* To be removed   */
-	ABool label = _tk_Tokenizer_check_label(line);
+	AErr status = (ti->mode == MODE_TOK_SRC_MMAP)? _tk_TokInterface_loadSpans(ti, cargo): _tk_TokInterface_loadLines(ti, cargo);
+	if ((status == SUCCESS) && (ti->status != 0))
+		status = _tk_TokInterface_close_conds(ti, cargo);
+	return status;
+}
 
-	Jar* jar = tk_new_Jar(lno);
-	if (jar == NULL)
+static Token* _tk_TokInterface_token_comment(Arena* arena, const char* line, ASize length, ASize comment) {	/* Comment token from `comment` to the end of the line  */
+	Token* token = _tk_Arena_new_Token(arena, TYPE_TOK_COMMENT, line + comment, length - comment);
+	if (token == NULL)
 		return NULL;
+	token->cno = comment + 1;
 
-	AString string = line;
-	/* Find comments and filter out comments   */
-	ASize length = strlen(line);
+	_tk_Tokenizer_remove_newlines(token->token);
+	return token;
+}
 
-	AString comment = _tk_TokInterface_token_comment(line);
-	if (comment != NULL) {
+static void* _tk_TokInterface_jar_maker(Arena* arena, Interner* interner, InternCache* cache, const char* line, const Packet* packet) {	/* Function to convert an indexed line to token Returns `NULL` on error  */
+	if (line == NULL)
+		return NULL;
 
-		Token* token = tk_new_Token(TYPE_TOK_COMMENT, comment);	/* Always put token->token = value to since pointer is deallocated from stack   */
-		token->token = comment;
+	Jar* jar = _tk_Arena_new_Jar(arena, packet->lno);
+	if (jar == NULL)
+		return NULL;
 
+	/* The comment position is already known from the line index   */
+	if (packet->comment < packet->length) {
+		Token* token = _tk_TokInterface_token_comment(arena, line, packet->length, packet->comment);
 		if (token == NULL)
 			return NULL;
+		token->lno = packet->lno;
 		if (jar->put(jar, token) != SUCCESS)
 			return NULL;
 	}
 
-	if (_tk_Tokenizer_put_tokens(jar, line) != SUCCESS)
+	/* Only the text between the first non-blank byte and the comment is tokenized   */
+	if (_tk_Tokenizer_put_tokens(jar, arena, interner, cache, line, packet->text, packet->comment) != SUCCESS)
 		return NULL;
 
+	if (packet->mark != 0) {	/* The reader refused the line, the parser reports it at its first token   */
+		Token* head = jar->get(jar, (jar->get(jar, 0)->type == TYPE_TOK_COMMENT)? 1: 0);
+		head->type = packet->mark;
+	}
+
 	return (void*)jar;
 }
 
-static AErr _tk_TokInterface_jarify(TokInterface* ti) {	/* The function to convert the Line Packets into Packets of Jars of Tokens   */
+static AErr _tk_TokInterface_jarify_range(const TokInterface* ti, const Cargo* cargo, Arena* arena, InternCache* cache, ASize lo, ASize hi) {	/* Convert the packets [lo, hi) into Jars; failed packets are left empty   */
+	AErr status = SUCCESS;
+	const char* base = (ti->mode == MODE_TOK_SRC_MMAP)? ti->source: cargo->text;
 
-	if (ti == NULL)
+	ASize i;
+	for (i = lo; i<hi; i++) {
+		Packet* packet = _tk_Cargo_get_packet(cargo, i);
+		const char* line = base + packet->offset;
+
+		Jar* jar = _tk_TokInterface_jar_maker(arena, ti->assembly->interner, cache, line, packet);
+		if (jar == NULL)
+			status = ERR_DS_STRUCT_GEN_FAIL;
+		packet->content = (void*)jar;
+		packet->owned = FALSE;	/* The Jar lives in the Cargo arena of the worker   */
+	}
+
+	return status;
+}
+
+static void _tk_WorkerPool_run(WorkerPool* pool, struct tk_worker* worker) {	/* Jarify the share of the current job that belongs to `worker`   */
+	if (worker->index >= pool->active)
+		return;
+
+	ASize lo = pool->first + (pool->count * worker->index)/pool->active;
+	ASize hi = pool->first + (pool->count * (worker->index + 1))/pool->active;
+	AErr status = _tk_TokInterface_jarify_range(pool->ti, pool->cargo, pool->cargo->arenas[worker->index], &worker->cache, lo, hi);
+	if (status != SUCCESS) {
+		pthread_mutex_lock(&pool->lock);
+		pool->status = status;
+		pthread_mutex_unlock(&pool->lock);
+	}
+}
+
+static void* _tk_WorkerPool_main(void* arg) {	/* The loop of a pool thread: wait for a job, run its share, report back   */
+	struct tk_worker* worker = (struct tk_worker*)arg;
+	WorkerPool* pool = worker->pool;
+	ASize seen = 0;
+
+	pthread_mutex_lock(&pool->lock);
+	while (1) {
+		while ((pool->generation == seen) && (!pool->shutdown))
+			pthread_cond_wait(&pool->start, &pool->lock);
+		if (pool->shutdown)
+			break;
+		seen = pool->generation;
+		pthread_mutex_unlock(&pool->lock);
+
+		_tk_WorkerPool_run(pool, worker);
+
+		pthread_mutex_lock(&pool->lock);
+		pool->pending--;
+		if (pool->pending == 0)
+			pthread_cond_signal(&pool->done);
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	return NULL;
+}
+
+static void _tk_destroy_WorkerPool(WorkerPool* pool) {	/* Stop and join the pool threads, then release the pool   */
+	if (pool == NULL)
+		return;
+
+	pthread_mutex_lock(&pool->lock);
+	pool->shutdown = TRUE;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+
+	ASize i;
+	for (i = 1; i<pool->size; i++)
+		pthread_join(pool->workers[i].thread, NULL);
+
+	pthread_cond_destroy(&pool->done);
+	pthread_cond_destroy(&pool->start);
+	pthread_mutex_destroy(&pool->lock);
+	free(pool);
+}
+
+static WorkerPool* _tk_new_WorkerPool(ASize size) {	/* Start `size - 1` threads; the calling thread acts as worker 0   */
+	WorkerPool* pool = (WorkerPool*)malloc(sizeof(WorkerPool));
+	if (pool == NULL)
+		return NULL;
+
+	pool->size = 1;
+	pool->active = 0;
+	pool->generation = 0;
+	pool->pending = 0;
+	pool->shutdown = FALSE;
+	pool->ti = NULL;
+	pool->cargo = NULL;
+	pool->first = 0;
+	pool->count = 0;
+	pool->status = SUCCESS;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->start, NULL);
+	pthread_cond_init(&pool->done, NULL);
+
+	ASize i;
+	for (i = 0; i<size; i++) {
+		pool->workers[i].pool = pool;
+		pool->workers[i].index = i;
+		ds_init_InternCache(&pool->workers[i].cache);
+	}
+
+	for (i = 1; i<size; i++) {
+		if (pthread_create(&pool->workers[i].thread, NULL, _tk_WorkerPool_main, &pool->workers[i]) != 0)
+			break;	/* Carry on with the threads we managed to start   */
+		pool->size++;
+	}
+
+	return pool;
+}
+
+static AErr _tk_TokInterface_jarify(TokInterface* ti, Cargo* cargo, ASize first) {	/* The function to convert the Line Packets from `first` into Packets of Jars of Tokens   */
+
+	if ((ti == NULL) || (ti->pool == NULL))
 		return ERR_INVALID_INTERFACE;
 
-	if (ti->cargo == NULL)
+	if (cargo == NULL)
 		return ERR_TOK_INVALID_CARGO;
 
-	Cargo* cargo = ti->cargo;
+	WorkerPool* pool = ti->pool;
+	if (first >= cargo->size)
+		return SUCCESS;
 
-	int i;
-	for (i = 0; i<cargo->size; i++) {
-		Packet* packet = _tk_Cargo_get_packet(cargo, i);
-		if (packet == NULL)
-			return ERR_DS_STRUCT_GEN_FAIL;
-	
-		Jar* jar = _tk_TokInterface_jar_maker(cargo->get(cargo, i), packet->lno);
-		if (jar == NULL) {
+	ASize count = cargo->size - first;
+
+	/* Every worker takes a disjoint, contiguous range and writes the Jars back into
+	 * its own packets, so the Cargo order does not depend on the scheduling.   */
+	ASize active = (count + SZ_TOK_JAR_MIN_BATCH - 1)/SZ_TOK_JAR_MIN_BATCH;
+	if (active > pool->size)
+		active = pool->size;
+
+	if (_tk_Cargo_reserve_arenas(cargo, active) != SUCCESS)
+		return ERR_DS_STRUCT_GEN_FAIL;
+
+	pool->ti = ti;
+	pool->cargo = cargo;
+	pool->first = first;
+	pool->count = count;
+	pool->status = SUCCESS;
+	pool->active = active;
+
+	if (active == 1) {
+		_tk_WorkerPool_run(pool, &pool->workers[0]);
+		return pool->status;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	pool->pending = pool->size - 1;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+
+	_tk_WorkerPool_run(pool, &pool->workers[0]);
+
+	pthread_mutex_lock(&pool->lock);
+	while (pool->pending != 0)
+		pthread_cond_wait(&pool->done, &pool->lock);
+	AErr status = pool->status;
+	pthread_mutex_unlock(&pool->lock);
+
+	return status;
+}
+
+/* ***************************************************
+ * Functions for Macros
+ * ***************************************************/
+
+/* A macro body is tokenized once, when it is defined, and kept as Jar
+ * templates. A call is replaced by copies of the templates that share the
+ * template tokens and only take the argument tokens from the call line, so
+ * nothing is lexed twice. Calls inside a body are expanded right there, so
+ * every template is flat by the time it is called.  */
+
+#define _TK_KEY_MACRO	DS_PACK('.', 'm', 'a', 'c', 'r', 'o', 0, 0)
+#define _TK_KEY_ENDM	DS_PACK('.', 'e', 'n', 'd', 'm', 0, 0, 0)
+
+#define _TK_MACRO_SLOT(id, cap)	(((ASize)(id)*2654435761u) & ((cap) - 1))	/* Fibonacci hash of a name id  */
+
+static void _tk_destroy_MacroTable(MacroTable* mt) {
+	if (mt == NULL)
+		return;
+
+	if (mt->arena != NULL)
+		mt->arena->destroy(mt->arena);
+	free(mt->slots);
+	free(mt->out);
+	free(mt);
+}
+
+static MacroTable* _tk_new_MacroTable() {
+	MacroTable* mt = (MacroTable*)malloc(sizeof(MacroTable));
+	if (mt == NULL)
+		return NULL;
+
+	mt->arena = ds_new_Arena(SZ_TOK_ARENA_CHUNK);
+	mt->slots = (Macro**)calloc(SZ_TOK_MACRO_TABLE, sizeof(Macro*));
+	mt->cap = SZ_TOK_MACRO_TABLE;
+	mt->count = 0;
+	mt->recording = NULL;
+	mt->broken = FALSE;
+	mt->opening = NULL;
+	mt->opening_lno = UNSET_TOK_LINE;
+	mt->out = NULL;
+	mt->out_size = 0;
+	mt->out_cap = 0;
+
+	if ((mt->arena == NULL) || (mt->slots == NULL)) {
+		_tk_destroy_MacroTable(mt);
+		return NULL;
+	}
+	return mt;
+}
+
+static Macro* _tk_MacroTable_find(const MacroTable* mt, AInt32 id) {
+	if ((mt->count == 0) || (id == UNSET_DS_INTERN))
+		return NULL;
+
+	ASize slot = _TK_MACRO_SLOT(id, mt->cap);
+	while (mt->slots[slot] != NULL) {
+		if (mt->slots[slot]->id == id)
+			return mt->slots[slot];
+		slot = (slot + 1) & (mt->cap - 1);
+	}
+	return NULL;
+}
+
+static void _tk_MacroTable_place(Macro** slots, ASize cap, Macro* macro) {	/* Put `macro` in its slot, or over a macro of the same name  */
+	ASize slot = _TK_MACRO_SLOT(macro->id, cap);
+	while ((slots[slot] != NULL) && (slots[slot]->id != macro->id))
+		slot = (slot + 1) & (cap - 1);
+	slots[slot] = macro;
+}
+
+static AErr _tk_MacroTable_insert(MacroTable* mt, Macro* macro) {	/* A macro defined again replaces the previous one  */
+	if (2*(mt->count + 1) > mt->cap) {
+		ASize cap = 2*mt->cap;
+		Macro** slots = (Macro**)calloc(cap, sizeof(Macro*));
+		if (slots == NULL)
+			return ERR_MEM_ALLOC_FAIL;
+
+		ASize i;
+		for (i = 0; i<mt->cap; i++) {
+			if (mt->slots[i] != NULL)
+				_tk_MacroTable_place(slots, cap, mt->slots[i]);
+		}
+		free(mt->slots);
+		mt->slots = slots;
+		mt->cap = cap;
+	}
+
+	if (_tk_MacroTable_find(mt, macro->id) == NULL)
+		mt->count++;
+	_tk_MacroTable_place(mt->slots, mt->cap, macro);
+	return SUCCESS;
+}
+
+static Token* _tk_MacroTable_keep(MacroTable* mt, const Token* token) {	/* Copy of a token that outlives its window  */
+	Token* tk = (Token*)mt->arena->alloc(mt->arena, sizeof(Token));
+	if (tk == NULL)
+		return NULL;
+
+	*tk = *token;
+	if (token->id == UNSET_DS_INTERN) {	/* Interned text already outlives the window  */
+		tk->token = mt->arena->strndup(mt->arena, token->token, token->length);
+		if (tk->token == NULL)
+			return NULL;
+	}
+	return tk;
+}
+
+static AErr _tk_MacroTable_out(MacroTable* mt, Jar* jar) {	/* Jar of the expanded window  */
+	if (mt->out_size == mt->out_cap) {
+		ASize cap = (mt->out_cap == 0)? SZ_TOK_CARGO_PKT_WIN: 2*mt->out_cap;
+		Jar** out = (Jar**)realloc(mt->out, cap*sizeof(Jar*));
+		if (out == NULL)
+			return ERR_MEM_REALLOC_FAIL;
+		mt->out = out;
+		mt->out_cap = cap;
+	}
+
+	mt->out[mt->out_size++] = jar;
+	return SUCCESS;
+}
+
+static AErr _tk_MacroTable_emit(MacroTable* mt, Jar* jar) {	/* Jar of the body being read, or of the window outside a body  */
+	Macro* macro = mt->recording;
+	if (macro == NULL)
+		return _tk_MacroTable_out(mt, jar);
+
+	if (macro->size == macro->cap) {	/* The old body stays in the arena  */
+		ASize cap = (macro->cap == 0)? 8: 2*macro->cap;
+		Jar** body = (Jar**)mt->arena->alloc(mt->arena, cap*sizeof(Jar*));
+		if (body == NULL)
+			return ERR_MEM_ALLOC_FAIL;
+		if (macro->size > 0)
+			memcpy(body, macro->body, macro->size*sizeof(Jar*));
+		macro->body = body;
+		macro->cap = cap;
+	}
+
+	macro->body[macro->size++] = jar;
+	return SUCCESS;
+}
+
+static AErr _tk_MacroTable_reject(MacroTable* mt, Jar* jar, Token* head) {	/* The parser reports the line at the token  */
+	head->type = TYPE_TOK_MACRO;
+	return _tk_MacroTable_out(mt, jar);
+}
+
+static AErr _tk_MacroTable_record(MacroTable* mt, const Jar* jar) {	/* Keep a body line as a template, comments left out  */
+	Jar* copy = _tk_Arena_new_Jar(mt->arena, jar->lno);
+	if (copy == NULL)
+		return ERR_DS_STRUCT_GEN_FAIL;
+
+	ASize i;
+	for (i = 0; i<jar->size; i++) {
+		Token* token = jar->get(jar, i);
+		if (token->type == TYPE_TOK_COMMENT)
+			continue;
+		Token* tk = _tk_MacroTable_keep(mt, token);
+		if ((tk == NULL) || (copy->put(copy, tk) != SUCCESS))
+			return ERR_DS_INSERT_FAIL;
+	}
+
+	return _tk_MacroTable_emit(mt, copy);
+}
+
+static Token* _tk_MacroTable_argument(MacroTable* mt, Arena* arena, Token* arg, AType type) {	/* The argument in place of a parameter of type `type`  */
+	if (mt->recording != NULL) {
+		Token* tk = _tk_MacroTable_keep(mt, arg);
+		if (tk != NULL)
+			tk->type = type;
+		return tk;
+	}
+	if (arg->type == type)
+		return arg;
+
+	Token* tk = (Token*)arena->alloc(arena, sizeof(Token));	/* A label parameter keeps the label type  */
+	if (tk == NULL)
+		return NULL;
+	*tk = *arg;
+	tk->type = type;
+	return tk;
+}
+
+static AErr _tk_MacroTable_expand(MacroTable* mt, const Macro* macro, Arena* arena, const Jar* call, ASize at, Token* label) {	/* Copies of the templates with the tokens of `call` from `at` as arguments  */
+	Arena* target = (mt->recording != NULL)? mt->arena: arena;
+
+	if (label != NULL) {	/* The label of the call line marks the first expanded line  */
+		Jar* jar = _tk_Arena_new_Jar(target, call->lno);
+		Token* tk = (mt->recording != NULL)? _tk_MacroTable_keep(mt, label): label;
+		if ((jar == NULL) || (tk == NULL) || (jar->put(jar, tk) != SUCCESS))
+			return ERR_DS_INSERT_FAIL;
+		if (_tk_MacroTable_emit(mt, jar) != SUCCESS)
+			return ERR_DS_INSERT_FAIL;
+	}
+
+	ASize b;
+	for (b = 0; b<macro->size; b++) {
+		const Jar* tpl = macro->body[b];
+		Jar* jar = _tk_Arena_new_Jar(target, call->lno);
+		if (jar == NULL)
 			return ERR_DS_STRUCT_GEN_FAIL;
+
+		ASize k;
+		for (k = 0; k<tpl->size; k++) {
+			Token* tk = tpl->get(tpl, k);
+			if ((tk->id != UNSET_DS_INTERN) && (macro->n_params > 0)) {
+				ASize p = 0;
+				while ((p < macro->n_params) && (macro->params[p] != tk->id))
+					p++;
+				if (p < macro->n_params)
+					tk = _tk_MacroTable_argument(mt, target, call->get(call, at + p), tk->type);
+			}
+			if ((tk == NULL) || (jar->put(jar, tk) != SUCCESS))
+				return ERR_DS_INSERT_FAIL;
+		}
+
+		if (_tk_MacroTable_emit(mt, jar) != SUCCESS)
+			return ERR_DS_INSERT_FAIL;
+	}
+
+	return SUCCESS;
+}
+
+static AErr _tk_MacroTable_open(MacroTable* mt, Jar* jar, ASize at, Token* label) {	/* `.macro name p1, p2` starts a body  */
+	Token* head = jar->get(jar, at);
+	if (mt->recording != NULL)
+		return _tk_MacroTable_reject(mt, jar, head);	/* Definitions do not nest  */
+
+	Macro* macro = (Macro*)mt->arena->alloc(mt->arena, sizeof(Macro));
+	Token* opening = _tk_MacroTable_keep(mt, head);
+	if ((macro == NULL) || (opening == NULL))
+		return ERR_MEM_ALLOC_FAIL;
+
+	Token* name = jar->get(jar, at + 1);
+	ASize n_params = (jar->size > at + 1)? jar->size - at - 2: 0;
+	ABool broken = ((label != NULL) || (name == NULL) || (name->type != TYPE_TOK_WORD) || (n_params > SZ_TOK_MACRO_PARAMS))? TRUE: FALSE;
+
+	macro->id = (name == NULL)? UNSET_DS_INTERN: name->id;
+	macro->n_params = 0;
+	macro->body = NULL;
+	macro->size = 0;
+	macro->cap = 0;
+	ASize i;
+	for (i = 0; (broken == FALSE) && (i<n_params); i++) {
+		Token* param = jar->get(jar, at + 2 + i);
+		if (param->type != TYPE_TOK_WORD)
+			broken = TRUE;
+		macro->params[macro->n_params++] = param->id;
+	}
+
+	/* A malformed body is still read to its `.endm`, then dropped  */
+	mt->recording = macro;
+	mt->broken = broken;
+	mt->opening = opening;
+	mt->opening_lno = jar->lno;
+	if (broken == TRUE)
+		return _tk_MacroTable_reject(mt, jar, head);
+	return SUCCESS;
+}
+
+static AErr _tk_MacroTable_close(MacroTable* mt, Jar* jar, ASize at, Token* label) {	/* `.endm` ends the body being read  */
+	Token* head = jar->get(jar, at);
+	Macro* macro = mt->recording;
+	if (macro == NULL)
+		return _tk_MacroTable_reject(mt, jar, head);
+
+	mt->recording = NULL;
+	if ((label != NULL) || (jar->size > at + 1))
+		return _tk_MacroTable_reject(mt, jar, head);
+	if (mt->broken == TRUE)
+		return SUCCESS;
+	return _tk_MacroTable_insert(mt, macro);
+}
+
+static AErr _tk_MacroTable_line(MacroTable* mt, Arena* arena, Jar* jar) {	/* Define, record, expand or pass on one Jar of the window  */
+	if ((jar == NULL) || (jar->size == 0))
+		return _tk_MacroTable_out(mt, jar);
+
+	ASize at = 0;
+	Token* head = jar->get(jar, at);
+	if (head->type == TYPE_TOK_COMMENT)
+		head = jar->get(jar, ++at);
+	Token* label = NULL;
+	if ((head != NULL) && (head->type == TYPE_TOK_LABEL)) {
+		label = head;
+		head = jar->get(jar, ++at);
+	}
+
+	if (head != NULL) {
+		if (head->packed == _TK_KEY_MACRO)
+			return _tk_MacroTable_open(mt, jar, at, label);
+		if (head->packed == _TK_KEY_ENDM)
+			return _tk_MacroTable_close(mt, jar, at, label);
+
+		Macro* macro = (head->type == TYPE_TOK_WORD)? _tk_MacroTable_find(mt, head->id): NULL;
+		if (macro != NULL) {
+			if (jar->size - at - 1 != macro->n_params)
+				return _tk_MacroTable_reject(mt, jar, head);
+			return _tk_MacroTable_expand(mt, macro, arena, jar, at + 1, label);
 		}
+	}
+
+	if (mt->recording != NULL)
+		return _tk_MacroTable_record(mt, jar);
+	return _tk_MacroTable_out(mt, jar);
+}
+
+static ABool _tk_Cargo_has_macro(const Cargo* cargo, ASize first) {	/* Any `.macro` or `.endm` line among the packets from `first`  */
+	ASize i;
+	for (i = first; i<cargo->size; i++) {
+		const Jar* jar = (const Jar*)_tk_Cargo_get_packet(cargo, i)->content;
+		if (jar == NULL)
+			continue;
+
+		ASize at = 0;
+		Token* head = jar->get(jar, at);
+		if ((head != NULL) && (head->type == TYPE_TOK_COMMENT))
+			head = jar->get(jar, ++at);
+		if ((head != NULL) && (head->type == TYPE_TOK_LABEL))
+			head = jar->get(jar, ++at);
+		if ((head != NULL) && ((head->packed == _TK_KEY_MACRO) || (head->packed == _TK_KEY_ENDM)))
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static AErr _tk_TokInterface_expand(TokInterface* ti, Cargo* cargo, ASize first) {	/* Replace the macro lines among the Jars from `first` by what they stand for  */
+	MacroTable* mt = ti->macros;
+	if ((mt->count == 0) && (mt->recording == NULL) && (_tk_Cargo_has_macro(cargo, first) == FALSE))
+		return SUCCESS;	/* Sources without macros are left as they are  */
+
+	if (_tk_Cargo_reserve_arenas(cargo, 1) != SUCCESS)
+		return ERR_DS_STRUCT_GEN_FAIL;
+	Arena* arena = cargo->arenas[0];	/* Expanded Jars go with the window  */
+
+	mt->out_size = 0;
+	ASize count = cargo->size - first;
+	ASize i;
+	for (i = first; i<cargo->size; i++) {
+		if (_tk_MacroTable_line(mt, arena, (Jar*)_tk_Cargo_get_packet(cargo, i)->content) != SUCCESS)
+			return ERR_TOK_JARIFICATION_FAIL;
+	}
+
+	if ((cargo->status != 0) && (mt->recording != NULL)) {	/* A body still open at the end of source is reported at its `.macro`  */
+		mt->recording = NULL;
+		if (mt->broken == FALSE) {
+			Jar* jar = _tk_Arena_new_Jar(arena, mt->opening_lno);
+			if ((jar == NULL) || (jar->put(jar, mt->opening) != SUCCESS))
+				return ERR_DS_INSERT_FAIL;
+			if (_tk_MacroTable_reject(mt, jar, mt->opening) != SUCCESS)
+				return ERR_DS_INSERT_FAIL;
+		}
+	}
+
+	/* The Jars are written back over the packets of the window, which grows or
+	 * shrinks to fit them; the packets past the old end are new slots.   */
+	for (i = 0; i<mt->out_size; i++) {
+		Packet* packet = NULL;
+		if (i < count) {
+			packet = _tk_Cargo_get_packet(cargo, first + i);
+		} else {
+			packet = _tk_Cargo_next_slot(cargo);
+			if (packet == NULL)
+				return ERR_TOK_INVALID_PACKET;
+			_tk_Packet_init(packet, NULL, UNSET_TOK_LINE);
+			packet->destroy = _tk_destroy_crated_Packet;
+		}
+
+		Jar* jar = mt->out[i];
 		packet->content = (void*)jar;
+		packet->owned = FALSE;
+		if (jar != NULL)
+			packet->lno = jar->lno;
 	}
+	if (mt->out_size < count)
+		cargo->size = first + mt->out_size;
 
 	return SUCCESS;
 }
 
-AErr tk_TokInterface_fillCargo(TokInterface* ti, Cargo* cargo) {
-	ti->cargo = cargo;
+/* `fillCargo` is `loadCargo` followed by `jarifyCargo`. The two halves only
+ * share the Cargo, so a reader thread may load the next window into another
+ * Cargo while a tokenizer thread jarifies this one; each half must stay on
+ * one thread, as the reading position and the released pages are not shared.  */
 
-	if (_tk_TokInterface_loadPackets(ti) != SUCCESS)
+AErr tk_TokInterface_loadCargo(TokInterface* ti, Cargo* cargo) {	/* Append the next window of Line Packets to the Cargo; `status` turns 1 at the end of source  */
+	if ((ti == NULL) || (cargo == NULL))
+		return ERR_INVALID_INTERFACE;
+
+	ti->cargo = cargo;
+	if (_tk_TokInterface_loadPackets(ti, cargo) != SUCCESS)
 		return ERR_TOK_CARGO_LOAD_FAIL;
 
-	if (_tk_TokInterface_jarify(ti) != SUCCESS)
+	cargo->mark = ti->current_pos;
+	cargo->status = ti->status;
+	return SUCCESS;
+}
+
+AErr tk_TokInterface_jarifyCargo(TokInterface* ti, Cargo* cargo) {	/* Turn the Packets loaded since the last call into Jars  */
+	if ((ti == NULL) || (cargo == NULL))
+		return ERR_INVALID_INTERFACE;
+
+	ASize first = cargo->jarified;
+	cargo->jarified = cargo->size;
+	if (_tk_TokInterface_jarify(ti, cargo, first) != SUCCESS)
 		return ERR_TOK_JARIFICATION_FAIL;
+	if (_tk_TokInterface_expand(ti, cargo, first) != SUCCESS)
+		return ERR_TOK_JARIFICATION_FAIL;
+	cargo->jarified = cargo->size;
 
+	if (ti->mode == MODE_TOK_SRC_MMAP)
+		_tk_TokInterface_release_source(ti, cargo->mark);
 	return SUCCESS;
 }
 
+AErr tk_TokInterface_fillCargo(TokInterface* ti, Cargo* cargo) {	/* Append the next window of Jars to the Cargo; `status` turns 1 at the end of source  */
+	AErr status = tk_TokInterface_loadCargo(ti, cargo);
+	if (status != SUCCESS)
+		return status;
+
+	return tk_TokInterface_jarifyCargo(ti, cargo);
+}
+
 AInt tk_TokInterface_pwDone(TokInterface* ti) {		/* Function to calculate the percentage of work done by the tokenizer   */
 	if (ti == NULL)
 		return -1;
 
+	if (ti->status != 0)
+		return 100;
+	if (ti->file_size == 0)
+		return 0;
+
 	return (AInt)((ti->current_pos * 100)/ti->file_size);
 }
 
+static void _tk_TokInterface_map_source(TokInterface* ti) {	/* Map regular files into memory; anything else is streamed with `fgets`   */
+	struct stat st;
+	int fd = fileno(ti->file);
+	if ((fd < 0) || (fstat(fd, &st) != 0))
+		return;
+
+	if ((!S_ISREG(st.st_mode)) || (st.st_size <= 0))
+		return;
+
+	void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED)
+		return;
+
+	posix_madvise(map, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+	ti->source = (AString)map;
+	ti->file_size = (ASize)st.st_size;
+	ti->mode = MODE_TOK_SRC_MMAP;
+}
+
 void tk_destroy_TokInterface(TokInterface* ti) {	/* Function to destroy the Tokenizer Interface   */
 	if (ti == NULL)
 		return;
 
+	_tk_destroy_WorkerPool(ti->pool);
+	_tk_destroy_MacroTable(ti->macros);
+	ti->constants->destroy(ti->constants);
+	ASize i;
+	for (i = 0; i<ti->cond_depth; i++)
+		free(ti->conds[i].text);
+	free(ti->index);
+	free(ti->line);
+
+	if (ti->mode == MODE_TOK_SRC_MMAP)
+		munmap(ti->source, ti->file_size);
+
 	free(ti);
 	ti = NULL;
 }
 
-TokInterface* tk_new_TokInterface(FILE* file, ASize num_workers) {
-	if (file == NULL)
+TokInterface* tk_new_TokInterface(FILE* file, ASize num_workers, Assembly* assembly) {	/* Words are interned into the interner of `assembly`, which outlives the Jars  */
+	if ((file == NULL) || (assembly == NULL))
 		return NULL;
 
 	TokInterface* ti = (TokInterface*)malloc(sizeof(TokInterface));
@@ -632,15 +1627,67 @@ TokInterface* tk_new_TokInterface(FILE* file, ASize num_workers) {
 		return NULL;
 
 	ti->file = file;
+	ti->assembly = assembly;
+	ti->cargo = NULL;
+	ti->source = NULL;
+	ti->line = NULL;
+	ti->line_cap = 0;
+	ti->mode = MODE_TOK_SRC_STREAM;
 	fseek(file, 0, SEEK_END);
-	ti->file_size = ftell(file);
+	long size = ftell(file);
+	ti->file_size = (size < 0)? 0: (ASize)size;	/* Unknown for pipes   */
 	fseek(file, 0, SEEK_SET);
 	ti->current_pos = 0;
-	ti->num_workers = num_workers;
+	ti->released_pos = 0;
+	ti->lno = 0;
 	ti->status = 0;
 
+	if (num_workers == SZ_TOK_IF_AUTO_THREAD) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		num_workers = (online > 0)? (ASize)online: 1;
+	}
+	if (num_workers > SZ_TOK_IF_MAX_THREAD)
+		num_workers = SZ_TOK_IF_MAX_THREAD;
+
+	ti->index = (LineSpan*)malloc(SZ_TOK_CARGO_PKT_WIN*sizeof(LineSpan));
+	if (ti->index == NULL) {
+		free(ti);
+		return NULL;
+	}
+
+	ti->macros = _tk_new_MacroTable();
+	if (ti->macros == NULL) {
+		free(ti->index);
+		free(ti);
+		return NULL;
+	}
+
+	ti->constants = ds_new_SymTable(assembly);
+	ti->cond_depth = 0;
+	ti->skip_depth = 0;
+	if (ti->constants == NULL) {
+		_tk_destroy_MacroTable(ti->macros);
+		free(ti->index);
+		free(ti);
+		return NULL;
+	}
+
+	ti->pool = _tk_new_WorkerPool(num_workers);
+	if (ti->pool == NULL) {
+		ti->constants->destroy(ti->constants);
+		_tk_destroy_MacroTable(ti->macros);
+		free(ti->index);
+		free(ti);
+		return NULL;
+	}
+	ti->num_workers = ti->pool->size;
+
+	_tk_TokInterface_map_source(ti);
+
 	ti->destroy = tk_destroy_TokInterface;
 	ti->fillCargo = tk_TokInterface_fillCargo;
+	ti->loadCargo = tk_TokInterface_loadCargo;
+	ti->jarifyCargo = tk_TokInterface_jarifyCargo;
 	ti->percentageWorkDone = tk_TokInterface_pwDone;
 
 	return ti;
@@ -0,0 +1,212 @@
+#include <tokenizer/tokenizer.h>
+#include <parser/parser.h>
+#include <isa.h>
+#include <string.h>
+#include <time.h>
+
+#define SUCCESS 0
+#define FAILURE 1
+
+static Assembly* assembly = NULL;    /* The identifiers of every Jar of the run  */
+
+/* Timings of the data structures, built with the tests but not run by ctest  */
+
+int bench_cargo_scaling() {
+    /* Indexed access must cost the same per packet whatever the Cargo size.  */
+    ASize sizes[] = {1 << 12, 1 << 14, 1 << 16, 1 << 18};
+    double per_get[4];
+    int k;
+    for (k = 0; k<4; k++) {
+        Cargo* cargo = tk_new_Cargo();
+        if (cargo == NULL)
+            return FAILURE;
+
+        ASize n = sizes[k];
+        ASize i;
+        for (i = 0; i<n; i++) {
+            if (cargo->load(cargo, i + 1, "x") != SUCCESS)
+                return FAILURE;
+        }
+
+        ASize rounds = ((ASize)1 << 23)/n;
+        ASize r;
+        ASize sink = 0;
+        clock_t start = clock();
+        for (r = 0; r<rounds; r++) {
+            for (i = 0; i<n; i++) {
+                if (cargo->get(cargo, i) != NULL)
+                    sink++;
+            }
+        }
+        clock_t end = clock();
+
+        per_get[k] = ((double)(end - start)*1e9)/CLOCKS_PER_SEC/(double)(rounds*n);
+        printf("Cargo of %lu packets: %.2f ns per get (%lu)\n", n, per_get[k], sink);
+        cargo->destroy(cargo, FALSE);
+    }
+
+    printf("Cargo of %lu packets costs %.2fx the smallest per get\n", sizes[3], per_get[3]/per_get[0]);
+    return SUCCESS;
+}
+
+int bench_lexer() {
+    /* Per line cost of scanning and lexing a window on one worker  */
+    FILE* file = tmpfile();
+    if (file == NULL)
+        return FAILURE;
+
+    ASize lines = 200000;
+    ASize i;
+    for (i = 0; i<lines; i++) {
+        if (i%4 == 0)
+            fprintf(file, "label%lu: ldc %lu ; load the constant\n", i, i);
+        else if (i%4 == 1)
+            fprintf(file, "\tadd\n");
+        else if (i%4 == 2)
+            fprintf(file, "\tbrz label%lu\n", i - 2);
+        else
+            fprintf(file, "    ; a comment only line\n");
+    }
+    rewind(file);
+
+    TokInterface* ti = tk_new_TokInterface(file, 1, assembly);
+    Cargo* cargo = tk_new_Cargo();
+    if ((ti == NULL) || (cargo == NULL))
+        return FAILURE;
+
+    ASize tokens = 0;
+    clock_t start = clock();
+    while (ti->status == 0) {
+        if (ti->fillCargo(ti, cargo) != SUCCESS)
+            return FAILURE;
+        for (i = 0; i<cargo->size; i++)
+            tokens += ((Jar*)cargo->get(cargo, i))->size;
+        cargo->clear(cargo, FALSE);
+    }
+    clock_t end = clock();
+
+    printf("Lexed %lu lines into %lu tokens: %.1f ns per line\n", lines, tokens,
+        ((double)(end - start)*1e9)/CLOCKS_PER_SEC/(double)lines);
+
+    ti->destroy(ti);
+    cargo->destroy(cargo, FALSE);
+    fclose(file);
+    return (tokens == (lines/4)*(4 + 1 + 2))? SUCCESS: FAILURE;
+}
+
+int bench_parser() {
+    /* Lines per second of a whole parse with 1, 2, 4 and 8 workers; the rows must not change  */
+    FILE* file = tmpfile();
+    if (file == NULL)
+        return FAILURE;
+
+    ASize lines = 200000;
+    ASize i;
+    for (i = 0; i<lines; i++) {
+        if (i%4 == 0)
+            fprintf(file, "label%lu: ldc %lu ; load the constant\n", i, i);
+        else if (i%4 == 1)
+            fprintf(file, "\tadd\n");
+        else if (i%4 == 2)
+            fprintf(file, "\tbrz label%lu\n", i - 2);
+        else
+            fprintf(file, "    ; a comment only line\n");
+    }
+
+    ASize workers;
+    for (workers = 1; workers<=8; workers *= 2) {
+        Assembly* job = ds_new_Assembly(SZ_DS_ASM_ARENA);
+        if (job == NULL)
+            return FAILURE;
+        IList* ilist = ds_new_IList(job);
+        DList* dlist = ds_new_DList(job);
+        SymTable* stable = ds_new_SymTable(job);
+        MnMap* map = ds_new_MnMap(job);
+        EWList* elist = ds_new_EWList(job);
+        RegMap* regmap = ds_new_RegMap(job);
+        if (isa_load_MnMap(map) != SUCCESS)
+            return FAILURE;
+
+        rewind(file);
+        ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file, job);
+        if (pi == NULL)
+            return FAILURE;
+        pi->workers = workers;
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (pi->parse(pi, file) != SUCCESS)
+            return FAILURE;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec)/1e9;
+        printf("Parsed %lu lines with %lu workers: %.0f lines per second\n", lines, workers, (double)lines/seconds);
+        if ((ilist->size(ilist) != (lines/4)*3) || (!elist->empty(elist)))
+            return FAILURE;
+
+        pi->destroy(pi);
+        ilist->destroy(ilist);
+        dlist->destroy(dlist);
+        stable->destroy(stable);
+        map->destroy(map);
+        elist->destroy(elist);
+        regmap->destroy(regmap);
+        job->destroy(job);
+    }
+
+    fclose(file);
+    return SUCCESS;
+}
+
+int bench_RegMap() {
+    /* Insert and find throughput of the string hashmap at 10^6 symbols; a miss finds 0  */
+    ASize n = 1000000;
+    char* names = (char*)malloc(n*16);
+    RegMap* map = ds_new_RegMap(NULL);
+    if ((names == NULL) || (map == NULL))
+        return FAILURE;
+
+    ASize i;
+    for (i = 0; i<n; i++)
+        sprintf(names + 16*i, "sym_%lu", i);
+
+    clock_t start = clock();
+    for (i = 0; i<n; i++) {
+        if (map->insert(map, names + 16*i, (AAddr)i + 1) != SUCCESS)
+            return FAILURE;
+    }
+    clock_t mid = clock();
+    ASize found = 0;
+    for (i = 0; i<n; i++) {
+        if (map->find(map, names + 16*((i*7919) % n)) == (AAddr)((i*7919) % n) + 1)
+            found++;
+    }
+    clock_t end = clock();
+
+    printf("RegMap of %lu symbols: %.1f ns per insert, %.1f ns per find (%lu)\n", n,
+        ((double)(mid - start)*1e9)/CLOCKS_PER_SEC/(double)n,
+        ((double)(end - mid)*1e9)/CLOCKS_PER_SEC/(double)n, found);
+
+    if ((found != n) || (map->size(map) != n) || (map->find(map, "sym_x") != 0))
+        return FAILURE;
+
+    map->destroy(map);
+    free(names);
+    return SUCCESS;
+}
+
+int main() {
+    assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    if (assembly == NULL)
+        return FAILURE;
+    if (bench_cargo_scaling() != SUCCESS)
+        return FAILURE;
+    if (bench_lexer() != SUCCESS)
+        return FAILURE;
+    if (bench_parser() != SUCCESS)
+        return FAILURE;
+    if (bench_RegMap() != SUCCESS)
+        return FAILURE;
+    assembly->destroy(assembly);
+    return SUCCESS;
+}
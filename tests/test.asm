@@ -0,0 +1,13 @@
+; Decoder fixture: labels, SET constants and data words
+start:  ldc 5           ; load
+        adc 3
+loop:   brz done
+        adj -1
+        br loop
+done:   HALT
+val:    data 42
+N:      SET 10
+        ldc N
+        ldc val
+        call sub
+sub:    return
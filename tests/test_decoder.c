@@ -1,84 +1,34 @@
 #include <parser/parser.h>
 #include <common_ds.h>
+#include <isa.h>
 #include <decoder/decoder.h>
 #include <logger/logger.h>
+#include <string.h>
 
 #define SUCCESS 0
 #define FAILURE 1
 
-typedef struct {
-    AString mnemonic;
-    AAddr encoding;
-    ASize n_operand;
-    AType operand_type;
-} Rule;
-
-typedef struct {
-    AString key;
-    AAddr encoding;
-} Register;
-
 int test_logger_interface() {
-    IList* ilist = ds_new_IList();
-    DList* dlist = ds_new_DList();
-    SymTable* stable = ds_new_SymTable();
-    MnMap* map = ds_new_MnMap();
-    EWList* elist = ds_new_EWList();
-    RegMap* regmap = ds_new_RegMap();
-    
-    /* Add Instuctions  */
-    Rule rules[19] = {
-        {"ldc", 0, 1, TYPE_MNE_OPERAND_VALUE},
-        {"adc", 1, 1, TYPE_MNE_OPERAND_VALUE},
-        {"ldl", 2, 1, TYPE_MNE_OPERAND_VALUE},
-        {"stl", 3, 1, TYPE_MNE_OPERAND_VALUE},
-        {"ldnl", 4, 1, TYPE_MNE_OPERAND_VALUE},
-        {"stnl", 5, 1, TYPE_MNE_OPERAND_VALUE},
-        {"add", 6, 0, TYPE_MNE_OPERAND_NONE},
-        {"sub", 7, 0, TYPE_MNE_OPERAND_NONE},
-        {"shl", 8, 0, TYPE_MNE_OPERAND_NONE},
-        {"shr", 9, 0, TYPE_MNE_OPERAND_NONE},
-        {"adj", 10, 1, TYPE_MNE_OPERAND_VALUE},
-        {"a2sp", 11, 0, TYPE_MNE_OPERAND_NONE},
-        {"sp2a", 12, 0, TYPE_MNE_OPERAND_NONE},
-        {"call", 13, 1, TYPE_MNE_OPERAND_OFFSET},
-        {"return", 14, 0, TYPE_MNE_OPERAND_NONE},
-        {"brz", 15, 1, TYPE_MNE_OPERAND_OFFSET},
-        {"brlz", 16, 1, TYPE_MNE_OPERAND_OFFSET},
-        {"br", 17, 1, TYPE_MNE_OPERAND_OFFSET},
-        {"HALT", 18, 0}
-    };
-
-    Register registers[10] = {
-        {"$s0", 0},
-        {"$s1", 1},
-        {"$s2", 2},
-        {"$s3", 3},
-        {"$s4", 4},
-        {"$s5", 5},
-        {"$s6", 6},
-        {"$s7", 7},
-        {"$s8", 8},
-        {"$s9", 9},
-    };
-
-    AInt j;
-    for (j = 0; j<19; j++) {
-        if (map->insert(map, rules[j].mnemonic, rules[j].encoding, rules[j].n_operand, rules[j].operand_type) != SUCCESS)
-            return FAILURE;
-    }
-
-    for (j = 0; j<10; j++) {
-        if (regmap->insert(regmap, registers[j].key, registers[j].encoding) != SUCCESS)
+    Assembly* assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    IList* ilist = ds_new_IList(assembly);
+    DList* dlist = ds_new_DList(assembly);
+    SymTable* stable = ds_new_SymTable(assembly);
+    MnMap* map = ds_new_MnMap(assembly);
+    EWList* elist = ds_new_EWList(assembly);
+    RegMap* regmap = ds_new_RegMap(assembly);
+
+    if (isa_load_MnMap(map) != SUCCESS)
+        return FAILURE;
+
+    if (isa_load_RegMap(regmap) != SUCCESS)
         return FAILURE;
-    }
 
     FILE* file = fopen("test.asm", "r");
 
     if ((file == NULL) || (ilist == NULL) || (dlist == NULL) || (stable == NULL) || (map == NULL) || (elist == NULL) || (regmap == NULL))
         return FAILURE;
 
-    ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file);
+    ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file, assembly);
     if (pi == NULL)
         return FAILURE;
 
@@ -111,9 +61,46 @@ int test_logger_interface() {
     return SUCCESS;
 }
 
+int test_single_pass_hand_made() {
+    /* An item built by hand has no mnemonic id, its forward reference is patched all the same */
+    Assembly* assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    DList* dlist = ds_new_DList(assembly);
+    SymTable* stable = ds_new_SymTable(assembly);
+    MnMap* map = ds_new_MnMap(assembly);
+    EWList* elist = ds_new_EWList(assembly);
+    if ((stable == NULL) || (map == NULL) || (elist == NULL) || (isa_load_MnMap(map) != SUCCESS))
+        return FAILURE;
+
+    SinglePass* sp = dc_new_SinglePass(stable, dlist, map, elist);
+    if (sp == NULL)
+        return FAILURE;
+
+    IItem item;
+    ds_init_IItem(&item, 0);
+    item.opcode = "br";
+    item.operand_1 = "ahead";
+    item.operand_1_id = assembly->interner->intern(assembly->interner, NULL, "ahead", 5);
+    if (sp->emit(sp, &item) != SUCCESS)
+        return FAILURE;
+
+    if ((stable->insertId(stable, item.operand_1_id, 1) != SUCCESS) || (sp->define(sp, item.operand_1_id) != SUCCESS))
+        return FAILURE;
+
+    /* The patched word is the one of a backward reference */
+    if (sp->emit(sp, &item) != SUCCESS)
+        return FAILURE;
+    if ((sp->bytepos != 8) || (memcmp(sp->buffer, sp->buffer + 4, 4) != 0))
+        return FAILURE;
+
+    sp->destroy(sp);
+    return SUCCESS;
+}
+
 int main() {
     if (test_logger_interface() == FAILURE)
         return FAILURE;
+    if (test_single_pass_hand_made() == FAILURE)
+        return FAILURE;
     return SUCCESS;
 }
 
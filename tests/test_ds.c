@@ -1,10 +1,19 @@
+#include <stdio.h>
 #include <common_ds.h>
+#include <err_codes.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
 
 #define SUCCESS 0
 #define FAILURE 1
 
+static Assembly* assembly = NULL;    /* One per run, as main.c keeps one per job  */
+static Interner* interner = NULL;    /* The interner of `assembly`  */
+
 int test_SymTable() {
-    SymTable *table = ds_new_SymTable();
+    SymTable *table = ds_new_SymTable(assembly);
     if (table == NULL)
         return FAILURE;
     
@@ -33,35 +42,47 @@ int test_SymTable() {
             return FAILURE;
         item = table->get(NULL);
     }
+
+    /* `SET` constants are symbols that know their value is not an address */
+    AInt32 id = interner->intern(interner, NULL, "limit", 5);
+    if (table->insertConst(table, id, 0x20) != SUCCESS)
+        return FAILURE;
+    if ((table->isConst(table, id) != TRUE) || (table->findId(table, id) != 0x20))
+        return FAILURE;
+    if (table->isConst(table, interner->lookup(interner, "Raj", 3)) != FALSE)
+        return FAILURE;
     table->destroy(table);
     return SUCCESS;
 }
 
 int test_DList() {
-    DList* dlist = ds_new_DList();
+    DList* dlist = ds_new_DList(NULL);
     if (dlist == NULL)
         return FAILURE;
 
-    AAddr addrs[] = {0, 4, 8, 12};
+    AAddr addrs[4];
     AInt32 datas[] = {100, 200, 300, 400};
 
     int i;
-    int result_address;
     for (i = 0; i<4; i++) {
-        if (dlist->insert(dlist, datas[i], &result_address) != SUCCESS) {
+        if (dlist->insert(dlist, datas[i], &addrs[i]) != SUCCESS) {
             return FAILURE;
         }
         if (dlist->size(dlist) != (i+1))
             return FAILURE;
+        if ((i > 0) && (addrs[i] != addrs[i-1] + 1))
+            return FAILURE;     /* Data words are word addressed like instructions */
     }
 
     for (i = 0; i<4; i++) {
-        DItem *item = dlist->find(dlist, addrs[i]);
-        if (item == NULL)
+        AInt32 *word = dlist->find(dlist, addrs[i]);
+        if (word == NULL)
             return FAILURE;
-        if (datas[i] != item->data)
+        if (datas[i] != *word)
             return FAILURE;
     }
+    if ((dlist->find(dlist, addrs[3] + 1) != NULL) || (dlist->words[addrs[2] - dlist->base] != datas[2]))
+        return FAILURE;
 
     DItem* item = dlist->get(dlist);
     for (i = 0; i<4; i++) {
@@ -76,7 +97,7 @@ int test_DList() {
 }
 
 int test_IList() {
-    IList* ilist = ds_new_IList();
+    IList* ilist = ds_new_IList(assembly);
     if (ilist == NULL)
         return FAILURE;
 
@@ -96,12 +117,56 @@ int test_IList() {
     }   
     ilist->get(NULL);
 
+    /* Rows are copies: a stack item can be put and reused */
+    IItem row;
+    ds_init_IItem(&row, 20);
+    row.opcode = "ldc";
+    row.n_op = 1;
+    row.operand_1 = "0x10";
+    if (ilist->put(ilist, &row) != SUCCESS)
+        return FAILURE;
+    row.address = 21;
+    row.operand_1 = "loop";
+    if (ilist->put(ilist, &row) != SUCCESS)
+        return FAILURE;
+    row.address = 22;
+    row.operand_1 = "#1";
+    if (ilist->put(ilist, &row) != SUCCESS)
+        return FAILURE;
+    if (ilist->size(ilist) != 7)
+        return FAILURE;
+
+    ICursor cursor;
+    ilist->begin(ilist, &cursor);
+    for (i = 0; i<7; i++) {
+        if (ilist->next(ilist, &cursor) == FALSE)
+            return FAILURE;
+        if (cursor.item.address != ((i<4)? (AAddr)(i*5): (AAddr)(16 + i)))
+            return FAILURE;
+    }
+    if (ilist->next(ilist, &cursor) == TRUE)
+        return FAILURE;
+
+    ilist->begin(ilist, &cursor);
+    for (i = 0; i<5; i++)
+        ilist->next(ilist, &cursor);
+    if ((cursor.item.opcode == NULL) || (strcmp(cursor.item.opcode, "ldc") != 0))
+        return FAILURE;
+    if ((cursor.item.operand_kind != TYPE_DS_OPERAND_NUMBER) || (cursor.item.operand_value != 16))
+        return FAILURE;
+    ilist->next(ilist, &cursor);
+    if ((cursor.item.operand_kind != TYPE_DS_OPERAND_SYMBOL) || (strcmp(cursor.item.operand_1, "loop") != 0))
+        return FAILURE;
+    ilist->next(ilist, &cursor);
+    if (cursor.item.operand_kind != TYPE_DS_OPERAND_BAD)
+        return FAILURE;
+
     ilist->destroy(ilist);
     return SUCCESS;
 }
 
 int test_EWList() {
-    EWList* elist = ds_new_EWList();
+    EWList* elist = ds_new_EWList(NULL);
     if (elist == NULL)
         return FAILURE;
 
@@ -121,12 +186,24 @@ int test_EWList() {
     }
     elist->get(NULL);
 
+    /* Only error codes count against the budget  */
+    if ((elist->errors != 0) || (elist->exhausted(elist) == TRUE))
+        return FAILURE;
+    elist->budget = 2;
+    elist->insert(elist, ds_new_EWItem(5, 1, WARN_ASM_INFINITE_LOOP));
+    elist->insert(elist, ds_new_EWItem(6, 1, PSR_ERR_INV_MNEMO));
+    if (elist->exhausted(elist) == TRUE)
+        return FAILURE;
+    elist->insert(elist, ds_new_EWItem(7, 1, DEC_ERR_LBL_UNDEF));
+    if ((elist->errors != 2) || (elist->exhausted(elist) == FALSE))
+        return FAILURE;
+
     elist->destroy(elist);
     return SUCCESS;
 }
 
 int test_MnMap() {
-    MnMap* map = ds_new_MnMap();
+    MnMap* map = ds_new_MnMap(NULL);
     if (map == NULL)
         return FAILURE;
 
@@ -153,11 +230,39 @@ int test_MnMap() {
             return FAILURE;
         mitem = map->get(NULL);
     }
+
+    /* Packed keys and ids lead to the same items as the strings */
+    for (i = 0; i<4; i++) {
+        mitem = map->match(map, ds_pack_key(mnemo[i], strlen(mnemo[i])));
+        if ((mitem == NULL) || (mitem->id != i) || (map->at(map, i) != mitem))
+            return FAILURE;
+    }
+    if ((map->match(map, DS_PACK('a', 'd', 'd', 0, 0, 0, 0, 0)) != map->at(map, 0)) || (map->at(map, 4) != NULL))
+        return FAILURE;
+    if ((map->find(map, "mul") != NULL) || (map->match(map, ds_pack_key("addd", 4)) != NULL))
+        return FAILURE;
+
+    /* A key too long to pack is still found by string  */
+    if (map->insert(map, "longmnemonic", 9, 0, TYPE_MNE_OPERAND_NONE) != SUCCESS)
+        return FAILURE;
+    mitem = map->find(map, "longmnemonic");
+    if ((mitem == NULL) || (mitem->id != 4) || (mitem->packed != UNSET_DS_PACKED))
+        return FAILURE;
+
+    /* A repeated key updates its item, packed or not, the last insert wins  */
+    if ((map->insert(map, "sub", 7, 1, TYPE_MNE_OPERAND_NONE) != SUCCESS) || (map->insert(map, "longmnemonic", 10, 1, TYPE_MNE_OPERAND_NONE) != SUCCESS))
+        return FAILURE;
+    if ((map->find(map, "sub") != map->at(map, 1)) || (map->at(map, 1)->encoding != 7) || (map->at(map, 1)->n_operand != 1))
+        return FAILURE;
+    if ((map->find(map, "longmnemonic") != mitem) || (mitem->encoding != 10) || (map->size(map) != 5) || (map->at(map, 5) != NULL))
+        return FAILURE;
+
+    map->destroy(map);
     return SUCCESS;
 }
 
 int test_RegMap() { 
-    RegMap *map = ds_new_RegMap();
+    RegMap *map = ds_new_RegMap(NULL);
     if (map == NULL)
         return FAILURE;
     
@@ -189,7 +294,439 @@ int test_RegMap() {
     map->destroy(map);
     return SUCCESS;
 }
+
+int test_RegMap_probing() {
+    /* Enough keys to grow the table a few times and build long probe runs  */
+    RegMap* map = ds_new_RegMap(NULL);
+    if (map == NULL)
+        return FAILURE;
+
+    char names[300][16];
+    ASize i;
+    for (i = 0; i<300; i++) {
+        sprintf(names[i], "r%lu", i);
+        if (map->insert(map, names[i], (AAddr)i + 1) != SUCCESS)
+            return FAILURE;
+    }
+    for (i = 0; i<300; i++) {
+        if (map->find(map, names[i]) != (AAddr)i + 1)
+            return FAILURE;
+    }
+
+    /* A repeated key takes its last value without a second entry, a miss finds 0  */
+    if ((map->insert(map, names[17], 999) != SUCCESS) || (map->find(map, names[17]) != 999))
+        return FAILURE;
+    if ((map->find(map, "r300") != 0) || (map->find(map, "") != 0) || (map->size(map) != 300))
+        return FAILURE;
+
+    map->destroy(map);
+    return SUCCESS;
+}
+
+int test_Arena() {
+    Arena* arena = ds_new_Arena(64);
+    if (arena == NULL)
+        return FAILURE;
+
+    AString first = arena->strndup(arena, "Hello World", 5);
+    if ((first == NULL) || (first[5] != '\0') || (first[0] != 'H'))
+        return FAILURE;
+
+    char* big = (char*)arena->alloc(arena, 1000);   /* Larger than a chunk  */
+    if ((big == NULL) || (((unsigned long)big) % 16 != 0))
+        return FAILURE;
+    big[999] = 'x';
+
+    arena->reset(arena);
+    AString again = arena->strndup(arena, "Hello", 5);
+    if (again != first)     /* Reset hands the same memory out again  */
+        return FAILURE;
+
+    arena->destroy(arena);
+    return SUCCESS;
+}
+
+int test_Arena_containers() {
+    Assembly* job = ds_new_Assembly(256);
+    if (job == NULL)
+        return FAILURE;
+    MnMap* map = ds_new_MnMap(job);
+    EWList* elist = ds_new_EWList(job);
+    RegMap* regmap = ds_new_RegMap(job);
+    DList* dlist = ds_new_DList(job);
+    if ((map == NULL) || (elist == NULL) || (regmap == NULL) || (dlist == NULL))
+        return FAILURE;
+
+    /* More items than one chunk holds  */
+    int i;
+    for (i = 0; i<100; i++) {
+        EWItem eitem;
+        eitem.line = i;
+        eitem.col = 1;
+        eitem.code = PSR_ERR_INV_MNEMO;
+        if (elist->put(elist, &eitem) != SUCCESS)
+            return FAILURE;
+    }
+    if (elist->insert(elist, ds_new_EWItem(100, 1, WARN_ASM_INFINITE_LOOP)) != SUCCESS)
+        return FAILURE;
+    if ((elist->size(elist) != 101) || (elist->errors != 100))
+        return FAILURE;
+
+    EWCursor cursor;
+    elist->begin(elist, &cursor);
+    for (i = 0; elist->next(elist, &cursor) == TRUE; i++) {
+        if (cursor.item->line != i)
+            return FAILURE;
+    }
+    if (i != 101)
+        return FAILURE;
+
+    if ((map->insert(map, "add", 5, 0, TYPE_MNE_OPERAND_NONE) != SUCCESS) || (regmap->insert(regmap, "$s0", 7) != SUCCESS))
+        return FAILURE;
+    MnItem* mitem = map->find(map, "add");
+    if ((mitem == NULL) || (mitem->encoding != 5) || (regmap->find(regmap, "$s0") != 7))
+        return FAILURE;
+
+    /* The words move to a bigger block of the arena as the list grows  */
+    AAddr address;
+    for (i = 0; i<3000; i++) {
+        if ((dlist->insert(dlist, i*7, &address) != SUCCESS) || (address != i))
+            return FAILURE;
+    }
+    for (i = 0; i<3000; i++) {
+        if (*dlist->find(dlist, i) != i*7)
+            return FAILURE;
+    }
+
+    /* The containers let go of their items, the assembly frees them all  */
+    map->destroy(map);
+    elist->destroy(elist);
+    regmap->destroy(regmap);
+    dlist->destroy(dlist);
+    job->destroy(job);
+    return SUCCESS;
+}
+
+#define RING_ITEMS 100000
+
+static void* ring_producer(void* arg) {
+    Ring* ring = (Ring*)arg;
+    unsigned long i;
+    for (i = 1; i<=RING_ITEMS; i++) {
+        while (ring->push(ring, (void*)i) == FALSE)
+            sched_yield();
+    }
+    return NULL;
+}
+
+int test_Ring() {
+    Ring* ring = ds_new_Ring(3);    /* Rounded up to 4 slots  */
+    if (ring == NULL)
+        return FAILURE;
+
+    void* item;
+    if (ring->pop(ring, &item) != FALSE)
+        return FAILURE;
+
+    unsigned long i;
+    for (i = 1; i<=4; i++) {
+        if (ring->push(ring, (void*)i) != TRUE)
+            return FAILURE;
+    }
+    if ((ring->push(ring, (void*)5) != FALSE) || (ring->size(ring) != 4))
+        return FAILURE;
+    for (i = 1; i<=4; i++) {
+        if ((ring->pop(ring, &item) != TRUE) || ((unsigned long)item != i))
+            return FAILURE;
+    }
+
+    /* A producer thread against this one: every item arrives once, in order  */
+    pthread_t producer;
+    if (pthread_create(&producer, NULL, ring_producer, (void*)ring) != 0)
+        return FAILURE;
+
+    unsigned long expected = 1;
+    while (expected <= RING_ITEMS) {
+        if (ring->pop(ring, &item) == FALSE) {
+            sched_yield();
+            continue;
+        }
+        if ((unsigned long)item != expected)
+            break;
+        expected++;
+    }
+    pthread_join(producer, NULL);
+
+    if ((expected != RING_ITEMS + 1) || (ring->size(ring) != 0))
+        return FAILURE;
+
+    ring->destroy(ring);
+    return SUCCESS;
+}
+
+#define INTERN_THREADS 4
+#define INTERN_WORDS 2000
+
+static AInt32 intern_ids[INTERN_THREADS][INTERN_WORDS];
+
+static void* intern_worker(void* arg) {
+    unsigned long t = (unsigned long)arg;
+    InternCache cache;
+    ds_init_InternCache(&cache);
+
+    char word[32];
+    int i;
+    for (i = 0; i<INTERN_WORDS; i++) {
+        int w = (t % 2 == 0)? i: INTERN_WORDS - 1 - i;    /* Threads race on the same words from both ends */
+        sprintf(word, (w % 3 == 0)? "w%d": "long_identifier_%d", w);
+        intern_ids[t][w] = interner->intern(interner, &cache, word, strlen(word));
+    }
+    return NULL;
+}
+
+int test_Interner() {
+    Interner* own = ds_new_Interner();
+    if (own == NULL)
+        return FAILURE;
+
+    AInt32 a = own->intern(own, NULL, "loop:", 4);
+    AInt32 b = own->intern(own, NULL, "loop", 4);
+    if ((a != b) || (a == UNSET_DS_INTERN) || (strcmp(own->string(own, a), "loop") != 0))
+        return FAILURE;
+    if ((own->lookup(own, "done", 4) != UNSET_DS_INTERN) || (own->size(own) != 1))
+        return FAILURE;
+    if ((own->intern(own, NULL, "done", 4) != a + 1) || (own->string(own, a + 2) != NULL))
+        return FAILURE;
+    if (interner->lookup(interner, "done", 4) != UNSET_DS_INTERN)    /* Interners do not share words  */
+        return FAILURE;
+    own->destroy(own);
+
+    /* Every thread must get the same id for a word, and ids stay distinct */
+    pthread_t threads[INTERN_THREADS];
+    unsigned long t;
+    for (t = 0; t<INTERN_THREADS; t++) {
+        if (pthread_create(&threads[t], NULL, intern_worker, (void*)t) != 0)
+            return FAILURE;
+    }
+    for (t = 0; t<INTERN_THREADS; t++)
+        pthread_join(threads[t], NULL);
+
+    int i;
+    char word[32];
+    for (i = 0; i<INTERN_WORDS; i++) {
+        for (t = 1; t<INTERN_THREADS; t++) {
+            if (intern_ids[t][i] != intern_ids[0][i])
+                return FAILURE;
+        }
+        sprintf(word, (i % 3 == 0)? "w%d": "long_identifier_%d", i);
+        if (strcmp(interner->string(interner, intern_ids[0][i]), word) != 0)
+            return FAILURE;
+        if ((i > 0) && (intern_ids[0][i] == intern_ids[0][i-1]))
+            return FAILURE;
+    }
+
+    /* The Symbol Table by id and by string are the same table */
+    SymTable* table = ds_new_SymTable(assembly);
+    if (table == NULL)
+        return FAILURE;
+    if (table->insertId(table, intern_ids[0][7], 42) != SUCCESS)
+        return FAILURE;
+    if ((table->find(table, "long_identifier_7") != 42) || (table->findId(table, intern_ids[0][8]) != ERR_MAP_FIND_ADDRESS))
+        return FAILURE;
+    if ((table->insert(table, "long_identifier_7", 43) != SUCCESS) || (table->size(table) != 1) || (table->findId(table, intern_ids[0][7]) != 43))
+        return FAILURE;
+    table->destroy(table);
+
+    return SUCCESS;
+}
+
+#define CSYM_THREADS 8
+#define CSYM_LABELS 2000
+
+static AInt32 csym_ids[CSYM_LABELS];
+
+static void* csym_worker(void* arg) {
+    CSymTable* table = (CSymTable*)arg;
+    static unsigned long next = 0;
+    unsigned long t = __atomic_fetch_add(&next, 1, __ATOMIC_RELAXED);
+    int i;
+    for (i = 0; i<CSYM_LABELS; i++) {
+        int k = (t % 2 == 0)? i: CSYM_LABELS - 1 - i;    /* Half the threads go backwards, to race  */
+        table->define(table, csym_ids[k], t*100000 + k, k*CSYM_THREADS + (CSYM_THREADS - t), 1);
+    }
+    return NULL;
+}
+
+int test_CSymTable() {
+    CSymTable* table = ds_new_CSymTable(assembly);
+    EWList* elist = ds_new_EWList(NULL);
+    if ((table == NULL) || (elist == NULL))
+        return FAILURE;
+
+    char word[32];
+    int i;
+    for (i = 0; i<CSYM_LABELS; i++) {
+        sprintf(word, "csym_%d", i);
+        csym_ids[i] = interner->intern(interner, NULL, word, strlen(word));
+    }
+
+    pthread_t threads[CSYM_THREADS];
+    unsigned long t;
+    for (t = 0; t<CSYM_THREADS; t++) {
+        if (pthread_create(&threads[t], NULL, csym_worker, (void*)table) != 0)
+            return FAILURE;
+    }
+    for (t = 0; t<CSYM_THREADS; t++)
+        pthread_join(threads[t], NULL);
+
+    if (table->publish(table, elist, PSR_ERR_DUP_LABEL) != SUCCESS)
+        return FAILURE;
+    if (table->define(table, csym_ids[0], 0, 0, 1) != ERR_DS_INSERT_FAIL)
+        return FAILURE;
+
+    /* The earliest line wins each label, every other definition is reported in line order  */
+    if ((table->size(table) != CSYM_LABELS) || (elist->size(elist) != CSYM_LABELS*(CSYM_THREADS - 1)))
+        return FAILURE;
+    for (i = 0; i<CSYM_LABELS; i++) {
+        if (table->findId(table, csym_ids[i]) != (CSYM_THREADS - 1)*100000 + i)
+            return FAILURE;
+    }
+    if (table->find(table, "csym_3") != (CSYM_THREADS - 1)*100000 + 3)
+        return FAILURE;
+
+    EWCursor ecursor;
+    ASize last = 0;
+    elist->begin(elist, &ecursor);
+    while (elist->next(elist, &ecursor) == TRUE) {
+        if ((ecursor.item->line <= last) || (ecursor.item->line % CSYM_THREADS == 1) || (ecursor.item->code != PSR_ERR_DUP_LABEL))
+            return FAILURE;
+        last = ecursor.item->line;
+    }
+
+    /* Copied, the symbols walk as if one thread had defined them by line  */
+    SymTable* copy = ds_new_SymTable(assembly);
+    SymTable* serial = ds_new_SymTable(assembly);
+    if ((copy == NULL) || (serial == NULL) || (table->copy(table, copy) != SUCCESS))
+        return FAILURE;
+    for (i = 0; i<CSYM_LABELS; i++)
+        serial->insertId(serial, csym_ids[i], (CSYM_THREADS - 1)*100000 + i);
+
+    SymCursor a, b;
+    copy->begin(copy, &a);
+    serial->begin(serial, &b);
+    while (copy->next(copy, &a) == TRUE) {
+        if ((serial->next(serial, &b) == FALSE) || (a.item.key != b.item.key) || (a.item.address != b.item.address))
+            return FAILURE;
+    }
+    if (serial->next(serial, &b) == TRUE)
+        return FAILURE;
+
+    copy->destroy(copy);
+    serial->destroy(serial);
+    elist->destroy(elist);
+    table->destroy(table);
+
+    /* A `SET` constant stays one in the copy  */
+    table = ds_new_CSymTable(assembly);
+    copy = ds_new_SymTable(assembly);
+    if ((table->defineConst(table, csym_ids[0], 32, 4, 1) != SUCCESS) || (table->define(table, csym_ids[0], 8, 9, 1) != ERR_MAP_DUP_KEY))
+        return FAILURE;
+    if ((table->publish(table, NULL, PSR_ERR_DUP_LABEL) != SUCCESS) || (table->copy(table, copy) != SUCCESS))
+        return FAILURE;
+    if ((copy->findId(copy, csym_ids[0]) != 32) || (copy->isConst(copy, csym_ids[0]) != TRUE))
+        return FAILURE;
+    copy->destroy(copy);
+    table->destroy(table);
+
+    return SUCCESS;
+}
+
+#define CURSOR_SYMBOLS 300
+
+static void* cursor_worker(void* arg) {
+    SymTable* table = (SymTable*)arg;
+    SymCursor cursor;
+    unsigned long seen = 0;
+    table->begin(table, &cursor);
+    while (table->next(table, &cursor)) {
+        if (table->find(table, cursor.item.key) == cursor.item.address)
+            seen++;
+    }
+    return (void*)seen;
+}
+
+int test_cursors() {
+    SymTable* table = ds_new_SymTable(assembly);
+    DList* dlist = ds_new_DList(NULL);
+    EWList* elist = ds_new_EWList(NULL);
+    if ((table == NULL) || (dlist == NULL) || (elist == NULL))
+        return FAILURE;
+
+    char name[32];
+    AAddr address;
+    int i;
+    for (i = 0; i<CURSOR_SYMBOLS; i++) {
+        sprintf(name, "cursor_%d", i);
+        if ((table->insert(table, name, i) != SUCCESS) || (dlist->insert(dlist, i, &address) != SUCCESS))
+            return FAILURE;
+        elist->insert(elist, ds_new_EWItem(i, 0, 0));
+    }
+
+    /* Nested walks do not disturb each other, and follow `get`  */
+    SymCursor outer, inner;
+    ASize pairs = 0;
+    table->begin(table, &outer);
+    SymItem* item = table->get(table);
+    while (table->next(table, &outer)) {
+        if ((item == table->end()) || (strcmp(item->key, outer.item.key) != 0))
+            return FAILURE;
+        table->begin(table, &inner);
+        while (table->next(table, &inner))
+            pairs++;
+        item = table->get(NULL);
+    }
+    if ((pairs != CURSOR_SYMBOLS*CURSOR_SYMBOLS) || (item != table->end()))
+        return FAILURE;
+
+    DCursor dcursor;
+    EWCursor ecursor;
+    dlist->begin(dlist, &dcursor);
+    elist->begin(elist, &ecursor);
+    for (i = 0; i<CURSOR_SYMBOLS; i++) {
+        if ((dlist->next(dlist, &dcursor) == FALSE) || (dcursor.item.data != i) || (dcursor.item.address != address - CURSOR_SYMBOLS + 1 + i))
+            return FAILURE;
+        if ((elist->next(elist, &ecursor) == FALSE) || (ecursor.item->line != i))
+            return FAILURE;
+    }
+    if ((dlist->next(dlist, &dcursor) == TRUE) || (elist->next(elist, &ecursor) == TRUE))
+        return FAILURE;
+
+    /* Threads walk the same table at once, the first to begin ranks it again  */
+    if (table->insert(table, "cursor_last", 7) != SUCCESS)
+        return FAILURE;
+    pthread_t threads[4];
+    for (i = 0; i<4; i++) {
+        if (pthread_create(&threads[i], NULL, cursor_worker, (void*)table) != 0)
+            return FAILURE;
+    }
+    for (i = 0; i<4; i++) {
+        void* seen;
+        pthread_join(threads[i], &seen);
+        if ((unsigned long)seen != CURSOR_SYMBOLS + 1)
+            return FAILURE;
+    }
+
+    table->destroy(table);
+    dlist->destroy(dlist);
+    elist->destroy(elist);
+    return SUCCESS;
+}
+
 int main() {
+    assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    if (assembly == NULL)
+        return FAILURE;
+    interner = assembly->interner;
     if (test_SymTable() != SUCCESS)
         return FAILURE;
     if (test_DList() != SUCCESS)
@@ -200,5 +737,22 @@ int main() {
         return FAILURE;
     if (test_MnMap() != SUCCESS)
         return FAILURE;
+    if (test_RegMap() != SUCCESS)
+        return FAILURE;
+    if (test_RegMap_probing() != SUCCESS)
+        return FAILURE;
+    if (test_Arena() != SUCCESS)
+        return FAILURE;
+    if (test_Arena_containers() != SUCCESS)
+        return FAILURE;
+    if (test_Ring() != SUCCESS)
+        return FAILURE;
+    if (test_Interner() != SUCCESS)
+        return FAILURE;
+    if (test_CSymTable() != SUCCESS)
+        return FAILURE;
+    if (test_cursors() != SUCCESS)
+        return FAILURE;
+    assembly->destroy(assembly);
     return SUCCESS;
 }
@@ -1,59 +1,31 @@
 #include <parser/parser.h>
 #include <common_ds.h>
+#include <isa.h>
+#include <string.h>
 
 #define SUCCESS 0
 #define FAILURE 1
 
-typedef struct {
-    AString mnemonic;
-    AAddr encoding;
-    ASize n_operand;
-} Rule;
-
 int test_parser_interface() {
-    IList* ilist = ds_new_IList();
-    DList* dlist = ds_new_DList();
-    SymTable* stable = ds_new_SymTable();
-    MnMap* map = ds_new_MnMap();
-    EWList* elist = ds_new_EWList();
-    RegMap* regmap = ds_new_RegMap();
-    
+    Assembly* assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    IList* ilist = ds_new_IList(assembly);
+    DList* dlist = ds_new_DList(assembly);
+    SymTable* stable = ds_new_SymTable(assembly);
+    MnMap* map = ds_new_MnMap(assembly);
+    EWList* elist = ds_new_EWList(assembly);
+    RegMap* regmap = ds_new_RegMap(assembly);
 
-    /* Add Instuctions  */
-    Rule rules[19] = {
-        {"ldc", 0, 1},
-        {"adc", 1, 1},
-        {"ldl", 2, 1},
-        {"stl", 3, 1},
-        {"ldnl", 4, 1},
-        {"stnl", 5, 1},
-        {"add", 6, 0},
-        {"sub", 7, 0},
-        {"shl", 8, 0},
-        {"shr", 9, 0},
-        {"adj", 10, 1},
-        {"a2sp", 11, 0},
-        {"sp2a", 12, 0},
-        {"call", 13, 1},
-        {"return", 14, 0},
-        {"brz", 15, 1},
-        {"brlz", 16, 1},
-        {"br", 17, 1},
-        {"HALT", 18, 0}
-    };
-
-    AInt j;
-    for (j = 0; j<19; j++) {
-        if (map->insert(map, rules[j].mnemonic, rules[j].encoding, rules[j].n_operand, TYPE_MNE_OPERAND_NONE))
-            return FAILURE;
-    }
+    if (isa_load_MnMap(map) != SUCCESS)
+        return FAILURE;
+    if ((map->size(map) != isa_mnemonics()) || (map->find(map, "HALT") == NULL) || (map->find(map, "return")->encoding != 14))
+        return FAILURE;
 
     FILE* file = fopen("hello.txt", "r");
 
     if ((file == NULL) || (ilist == NULL) || (dlist == NULL) || (stable == NULL) || (map == NULL) || (elist == NULL) || (regmap == NULL))
         return FAILURE;
 
-    ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file);
+    ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file, assembly);
     if (pi == NULL)
         return FAILURE;
 
@@ -69,8 +41,449 @@ int test_parser_interface() {
     return SUCCESS;
 }
 
+int test_parser_streaming() {
+    Assembly* assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    IList* ilist = ds_new_IList(assembly);
+    DList* dlist = ds_new_DList(assembly);
+    SymTable* stable = ds_new_SymTable(assembly);
+    MnMap* map = ds_new_MnMap(assembly);
+    EWList* elist = ds_new_EWList(assembly);
+    RegMap* regmap = ds_new_RegMap(assembly);
+
+    if (map->insert(map, "ldc", 0, 1, TYPE_MNE_OPERAND_VALUE) != SUCCESS)
+        return FAILURE;
+    if (map->insert(map, "br", 17, 1, TYPE_MNE_OPERAND_OFFSET) != SUCCESS)
+        return FAILURE;
+
+    /* Several Cargo windows worth of lines, with a label defined across a window boundary */
+    FILE* file = tmpfile();
+    if (file == NULL)
+        return FAILURE;
+
+    ASize n_lines = 3*SZ_TOK_CARGO_PKT_WIN + 17;
+    ASize i;
+    for (i = 1; i<=n_lines; i++) {
+        if (i == SZ_TOK_CARGO_PKT_WIN)
+            fprintf(file, "edge:\n");
+        else if (i == 2*SZ_TOK_CARGO_PKT_WIN)
+            fprintf(file, "again: br edge\n");
+        else if (i % 7 == 0)
+            fprintf(file, "; comment only\n");
+        else
+            fprintf(file, "\tldc %lu\n", i);
+    }
+    fflush(file);
+
+    ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file, assembly);
+    if (pi == NULL)
+        return FAILURE;
+    pi->workers = 8;    /* Batches of two windows, even on one processor */
+
+    if (pi->parse(pi, file) != SUCCESS)
+        return FAILURE;
+
+    ASize n_comments = n_lines/7;
+    ASize n_instr = n_lines - n_comments - 1;
+    if (ilist->size(ilist) != n_instr)
+        return FAILURE;
+    if (!elist->empty(elist))
+        return FAILURE;
+
+    /* `edge` is the address after the instructions of the first window */
+    ASize before_edge = (SZ_TOK_CARGO_PKT_WIN - 1) - (SZ_TOK_CARGO_PKT_WIN - 1)/7;
+    if (stable->find(stable, "edge") != before_edge)
+        return FAILURE;
+
+    IItem* item = ilist->get(ilist);
+    while (item != ilist->end()) {
+        if (item->lno == 2*SZ_TOK_CARGO_PKT_WIN)
+            break;
+        item = ilist->get(NULL);
+    }
+    if ((item == NULL) || (strcmp(item->opcode, "br") != 0))
+        return FAILURE;
+    if (stable->find(stable, "again") != item->address)
+        return FAILURE;
+
+    fclose(file);
+    pi->destroy(pi);
+    return SUCCESS;
+}
+
+int test_parser_chunks() {
+    Assembly* assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    IList* ilist = ds_new_IList(assembly);
+    DList* dlist = ds_new_DList(assembly);
+    SymTable* stable = ds_new_SymTable(assembly);
+    MnMap* map = ds_new_MnMap(assembly);
+    EWList* elist = ds_new_EWList(assembly);
+    RegMap* regmap = ds_new_RegMap(assembly);
+
+    if (map->insert(map, "ldc", 0, 1, TYPE_MNE_OPERAND_VALUE) != SUCCESS)
+        return FAILURE;
+
+    /* A window parsed in chunks must give the labels and errors of a single pass:
+     * `twice` is defined again far away, on a line with an instruction.  */
+    FILE* file = tmpfile();
+    if (file == NULL)
+        return FAILURE;
+
+    ASize n_lines = SZ_TOK_CARGO_PKT_WIN - 1;
+    ASize first = 3, second = n_lines - 5, bad = SZ_PSR_CHUNK_MIN_JARS + 1;
+    ASize i;
+    for (i = 1; i<=n_lines; i++) {
+        if (i == first)
+            fprintf(file, "twice: ldc 1\n");
+        else if (i == second)
+            fprintf(file, "twice: ldc 2\n");
+        else if (i == bad)
+            fprintf(file, "bogus 1\n");
+        else if (i == n_lines)
+            fprintf(file, "last:\n");
+        else
+            fprintf(file, "\tldc %lu\n", i);
+    }
+    fflush(file);
+
+    ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file, assembly);
+    if (pi == NULL)
+        return FAILURE;
+    if (pi->parse(pi, file) != SUCCESS)
+        return FAILURE;
+
+    /* The duplicate line is dropped but keeps its address slot  */
+    if (ilist->size(ilist) != n_lines - 3)
+        return FAILURE;
+    if ((stable->find(stable, "twice") != first - 1) || (stable->find(stable, "last") != n_lines - 1))
+        return FAILURE;
+    if (elist->size(elist) != 2)
+        return FAILURE;
+
+    EWItem* eitem = elist->get(elist);
+    if ((eitem == NULL) || (eitem->line != bad) || (eitem->code != PSR_ERR_INV_MNEMO))
+        return FAILURE;
+    eitem = elist->get(NULL);
+    if ((eitem == NULL) || (eitem->line != second) || (eitem->code != PSR_ERR_DUP_LABEL))
+        return FAILURE;
+
+    ICursor cursor;
+    ilist->begin(ilist, &cursor);
+    AAddr expected = 0;
+    while (ilist->next(ilist, &cursor)) {
+        if (cursor.item.lno == second)
+            return FAILURE;
+        if ((expected == bad - 1) || (expected == second - 1))
+            expected++;
+        if (cursor.item.address != expected++)
+            return FAILURE;
+    }
+
+    fclose(file);
+    pi->destroy(pi);
+    return SUCCESS;
+}
+
+int test_parser_consts() {
+    Assembly* assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    IList* ilist = ds_new_IList(assembly);
+    DList* dlist = ds_new_DList(assembly);
+    SymTable* stable = ds_new_SymTable(assembly);
+    MnMap* map = ds_new_MnMap(assembly);
+    EWList* elist = ds_new_EWList(assembly);
+    RegMap* regmap = ds_new_RegMap(assembly);
+
+    if (map->insert(map, "ldc", 0, 1, TYPE_MNE_OPERAND_VALUE) != SUCCESS)
+        return FAILURE;
+
+    /* A `SET` types the uses below it as constants, whichever chunk they
+     * fall in, and never the uses above it.  */
+    FILE* file = tmpfile();
+    if (file == NULL)
+        return FAILURE;
+
+    ASize n_lines = SZ_TOK_CARGO_PKT_WIN - 1;
+    ASize middle = n_lines/2;
+    ASize i;
+    for (i = 1; i<=n_lines; i++) {
+        if (i == 2)
+            fprintf(file, "step: SET 9\n");
+        else if (i == middle)
+            fprintf(file, "late: SET 5\n");
+        else if ((i == 1) || (i == middle - 1) || (i == n_lines))
+            fprintf(file, "\tldc late\n");
+        else
+            fprintf(file, "\tldc step\n");
+    }
+    fflush(file);
+
+    ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file, assembly);
+    if (pi == NULL)
+        return FAILURE;
+    if (pi->parse(pi, file) != SUCCESS)
+        return FAILURE;
+    if ((ilist->size(ilist) != n_lines - 2) || (elist->size(elist) != 0))
+        return FAILURE;
+
+    ICursor cursor;
+    ilist->begin(ilist, &cursor);
+    while (ilist->next(ilist, &cursor)) {
+        ASize lno = cursor.item.lno;
+        if ((lno == 1) || (lno == middle - 1)) {
+            if (cursor.item.operand_kind != TYPE_DS_OPERAND_SYMBOL)
+                return FAILURE;
+        } else if (cursor.item.operand_kind != TYPE_DS_OPERAND_CONST) {
+            return FAILURE;
+        } else if (cursor.item.operand_value != ((lno == n_lines)? 5: 9)) {
+            return FAILURE;
+        }
+    }
+
+    fclose(file);
+    pi->destroy(pi);
+    return SUCCESS;
+}
+
+typedef struct {
+    ASize n_rows;
+    AAddr address[8];
+    ASize n_defined;
+    AInt32 defined[8];
+} SinkLog;
+
+static AErr sink_emit(void* target, IItem* item) {
+    SinkLog* log = (SinkLog*)target;
+    if (log->n_rows == 8)
+        return FAILURE;
+    log->address[log->n_rows++] = item->address;
+    return SUCCESS;
+}
+
+static AErr sink_define(void* target, AInt32 id) {
+    SinkLog* log = (SinkLog*)target;
+    if (log->n_defined == 8)
+        return FAILURE;
+    log->defined[log->n_defined++] = id;
+    return SUCCESS;
+}
+
+int test_parser_sink() {
+    Assembly* assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    IList* ilist = ds_new_IList(assembly);
+    DList* dlist = ds_new_DList(assembly);
+    SymTable* stable = ds_new_SymTable(assembly);
+    MnMap* map = ds_new_MnMap(assembly);
+    EWList* elist = ds_new_EWList(assembly);
+    RegMap* regmap = ds_new_RegMap(assembly);
+
+    if (map->insert(map, "ldc", 0, 1, TYPE_MNE_OPERAND_VALUE) != SUCCESS)
+        return FAILURE;
+
+    FILE* file = tmpfile();
+    if (file == NULL)
+        return FAILURE;
+    fprintf(file, "\tldc ahead\nback: ldc 1\n\tldc back\nahead: ldc 2\nsize: SET 4\n");
+    fflush(file);
+
+    ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file, assembly);
+    if (pi == NULL)
+        return FAILURE;
+
+    /* With a sink the instructions go there, in address order, and skip `ilist`  */
+    SinkLog log = {0};
+    ISink sink = {&log, sink_emit, sink_define};
+    pi->sink = &sink;
+    if (pi->parse(pi, file) != SUCCESS)
+        return FAILURE;
+
+    if ((ilist->size(ilist) != 0) || (elist->size(elist) != 0))
+        return FAILURE;
+    if (log.n_rows != 4)
+        return FAILURE;
+    ASize i;
+    for (i = 0; i<4; i++) {
+        if (log.address[i] != i)
+            return FAILURE;
+    }
+
+    /* Every symbol is announced once it is in the table  */
+    if (log.n_defined != 3)
+        return FAILURE;
+    for (i = 0; i<3; i++) {
+        if (stable->findId(stable, log.defined[i]) == ERR_MAP_FIND_ADDRESS)
+            return FAILURE;
+    }
+
+    fclose(file);
+    pi->destroy(pi);
+    return SUCCESS;
+}
+
+static AErr sink_emit_fail(void* target, IItem* item) {
+    return ERR_MEM_REALLOC_FAIL;
+}
+
+int test_parser_sink_failure() {
+    Assembly* assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    IList* ilist = ds_new_IList(assembly);
+    DList* dlist = ds_new_DList(assembly);
+    SymTable* stable = ds_new_SymTable(assembly);
+    MnMap* map = ds_new_MnMap(assembly);
+    EWList* elist = ds_new_EWList(assembly);
+    RegMap* regmap = ds_new_RegMap(assembly);
+
+    if (map->insert(map, "ldc", 0, 1, TYPE_MNE_OPERAND_VALUE) != SUCCESS)
+        return FAILURE;
+
+    FILE* file = tmpfile();
+    if (file == NULL)
+        return FAILURE;
+    fprintf(file, "\tldc 1\nback: ldc 2\n");
+    fflush(file);
+
+    ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file, assembly);
+    if (pi == NULL)
+        return FAILURE;
+
+    /* A sink that cannot keep a row fails the parse instead of dropping it  */
+    SinkLog log = {0};
+    ISink sink = {&log, sink_emit_fail, sink_define};
+    pi->sink = &sink;
+    if ((pi->parse(pi, file) != ERR_MEM_REALLOC_FAIL) || (pi->status != ERR_MEM_REALLOC_FAIL))
+        return FAILURE;
+
+    fclose(file);
+    pi->destroy(pi);
+    return SUCCESS;
+}
+
+int test_parser_macros() {
+    Assembly* assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    IList* ilist = ds_new_IList(assembly);
+    DList* dlist = ds_new_DList(assembly);
+    SymTable* stable = ds_new_SymTable(assembly);
+    MnMap* map = ds_new_MnMap(assembly);
+    EWList* elist = ds_new_EWList(assembly);
+    RegMap* regmap = ds_new_RegMap(assembly);
+
+    if (isa_load_MnMap(map) != SUCCESS)
+        return FAILURE;
+
+    /* `pair` calls `push` in its body and takes a label as parameter; the
+     * call on line 10 has one argument too many.  */
+    FILE* file = tmpfile();
+    if (file == NULL)
+        return FAILURE;
+    fprintf(file, ".macro push v\n\tldc v\n.endm\n");
+    fprintf(file, ".macro pair a, b, at\n\tpush a\nat:\tpush b\n\tadd\n.endm\n");
+    fprintf(file, "top: pair 1, 2, mid\n\tpush 1, 2\n\tbr top\n");
+    fflush(file);
+
+    ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file, assembly);
+    if (pi == NULL)
+        return FAILURE;
+    if (pi->parse(pi, file) != SUCCESS)
+        return FAILURE;
+
+    const char* opcode[] = {"ldc", "ldc", "add", "br"};
+    const char* operand[] = {"1", "2", NULL, "top"};
+    ASize lno[] = {9, 9, 9, 11};
+    if (ilist->size(ilist) != 4)
+        return FAILURE;
+    ASize i = 0;
+    IItem* item = ilist->get(ilist);
+    while (item != NULL) {
+        if ((item->address != i) || (item->lno != lno[i]) || (strcmp(item->opcode, opcode[i]) != 0))
+            return FAILURE;
+        if ((operand[i] != NULL) && (strcmp(item->operand_1, operand[i]) != 0))
+            return FAILURE;
+        item = ilist->get(NULL);
+        i++;
+    }
+
+    if ((stable->find(stable, "top") != 0) || (stable->find(stable, "mid") != 1))
+        return FAILURE;
+
+    EWItem* eitem = elist->get(elist);
+    if ((elist->size(elist) != 1) || (eitem == NULL) || (eitem->line != 10) || (eitem->code != PSR_ERR_INV_MACRO))
+        return FAILURE;
+
+    fclose(file);
+    pi->destroy(pi);
+    return SUCCESS;
+}
+
+int test_parser_conditionals() {
+    Assembly* assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    IList* ilist = ds_new_IList(assembly);
+    DList* dlist = ds_new_DList(assembly);
+    SymTable* stable = ds_new_SymTable(assembly);
+    MnMap* map = ds_new_MnMap(assembly);
+    EWList* elist = ds_new_EWList(assembly);
+    RegMap* regmap = ds_new_RegMap(assembly);
+
+    if (isa_load_MnMap(map) != SUCCESS)
+        return FAILURE;
+
+    /* A disabled region spanning several windows, a nested block, and an
+     * `.if` on an unknown constant which is reported and assembles neither
+     * branch.  */
+    FILE* file = tmpfile();
+    if (file == NULL)
+        return FAILURE;
+    fprintf(file, "mode: SET 2\n.ifdef mode\n\tldc 1\n.else\n\tldc 2\n.endif\n");
+    fprintf(file, ".if mode > 2\n");
+    ASize i;
+    for (i = 0; i<3*SZ_TOK_CARGO_PKT_WIN; i++)
+        fprintf(file, "\tbogus %lu\n", i);
+    fprintf(file, ".else\n.if 1\n\tldc 3\n.endif\n.endif\n");
+    fprintf(file, ".if other\n\tldc 4\n.else\n\tldc 5\n.endif\n\tHALT\n");
+    fflush(file);
+
+    ParserInterface* pi = psr_new_ParserInterface(ilist, elist, stable, dlist, map, regmap, file, assembly);
+    if (pi == NULL)
+        return FAILURE;
+    if (pi->parse(pi, file) != SUCCESS)
+        return FAILURE;
+
+    ASize skipped = 3*SZ_TOK_CARGO_PKT_WIN;
+    const char* opcode[] = {"ldc", "ldc", "HALT"};
+    ASize lno[] = {3, skipped + 10, skipped + 18};
+    if (ilist->size(ilist) != 3)
+        return FAILURE;
+    i = 0;
+    IItem* item = ilist->get(ilist);
+    while (item != NULL) {
+        if ((item->address != i) || (item->lno != lno[i]) || (strcmp(item->opcode, opcode[i]) != 0))
+            return FAILURE;
+        item = ilist->get(NULL);
+        i++;
+    }
+
+    EWItem* eitem = elist->get(elist);
+    if ((elist->size(elist) != 1) || (eitem == NULL) || (eitem->line != skipped + 13) || (eitem->code != PSR_ERR_INV_COND))
+        return FAILURE;
+
+    fclose(file);
+    pi->destroy(pi);
+    return SUCCESS;
+}
+
 int main() {
     if (test_parser_interface() == FAILURE)
         return FAILURE;
+    if (test_parser_streaming() == FAILURE)
+        return FAILURE;
+    if (test_parser_chunks() == FAILURE)
+        return FAILURE;
+    if (test_parser_consts() == FAILURE)
+        return FAILURE;
+    if (test_parser_sink() == FAILURE)
+        return FAILURE;
+    if (test_parser_sink_failure() == FAILURE)
+        return FAILURE;
+    if (test_parser_macros() == FAILURE)
+        return FAILURE;
+    if (test_parser_conditionals() == FAILURE)
+        return FAILURE;
     return SUCCESS;
 }
@@ -1,9 +1,12 @@
 #include <tokenizer/tokenizer.h>
+#include <ctype.h>
 #include <time.h>
 
 #define SUCCESS 0
 #define FAILURE 1
 
+static Assembly* assembly = NULL;    /* The identifiers of every Jar of the run  */
+
 int test_cargo() {
     Cargo* cargo = tk_new_Cargo();
     if (cargo == NULL)
@@ -45,7 +48,11 @@ int test_Jar() {
         Token* token = jar->get(jar, i);
         if (token == NULL)
             return FAILURE;
+        if (token->token != strings[i])     /* Tokens come back in insertion order, past the inline ones too  */
+            return FAILURE;
     }
+    if (jar->get(jar, 5) != NULL)
+        return FAILURE;
 
     return SUCCESS;
 }
@@ -54,7 +61,7 @@ int test_tokenizer_interface() {
     FILE* file = fopen("hello.txt", "r");
     if (file == NULL)
         return FAILURE;
-    TokInterface* ti = tk_new_TokInterface(file, 20);
+    TokInterface* ti = tk_new_TokInterface(file, 20, assembly);
     if (ti == NULL)
         return FAILURE;
 
@@ -102,7 +109,250 @@ int test_tokenizer_interface() {
     return SUCCESS;
 }
 
+int test_line_scanner() {
+    /* Compare the vector scanner against a byte by byte reference, with a
+     * tiny `max` as well so that windows stop in the middle of a block.  */
+    char buffer[4096];
+    ASize size = 0;
+    unsigned long seed = 7;
+    const char alphabet[] = "ab: ;\t\r\n\n  x#,";
+    while (size < sizeof(buffer) - 1) {
+        seed = seed*1103515245 + 12345;
+        buffer[size++] = alphabet[(seed >> 16) % (sizeof(alphabet) - 1)];
+    }
+
+    LineSpan spans[64];
+    ASize max;
+    for (max = 1; max<=64; max += 63) {
+        ASize pos = 0;
+        ASize start = 0;
+        while (pos < size) {
+            ASize count = tk_scan_lines(buffer, size, pos, spans, max);
+            if (count == 0)
+                return FAILURE;
+
+            ASize k;
+            for (k = 0; k<count; k++) {
+                ASize end = start;
+                ASize text = (ASize)-1;
+                ASize comment = (ASize)-1;
+                while (end < size) {
+                    char c = buffer[end++];
+                    if (c == '\n')
+                        break;
+                    if ((text == (ASize)-1) && !isspace((unsigned char)c))
+                        text = end - 1;
+                    if ((comment == (ASize)-1) && (c == SEPARATOR_COMMENT))
+                        comment = end - 1;
+                }
+                if (text == (ASize)-1)
+                    text = end;
+                if (comment == (ASize)-1)
+                    comment = end;
+
+                if ((spans[k].start != start) || (spans[k].end != end) || (spans[k].text != text) || (spans[k].comment != comment))
+                    return FAILURE;
+                start = end;
+            }
+            pos = spans[count - 1].end;
+        }
+    }
+
+    return SUCCESS;
+}
+
+static Cargo* tokenize_all(FILE* file, ASize num_workers) {
+    rewind(file);
+    TokInterface* ti = tk_new_TokInterface(file, num_workers, assembly);
+    if (ti == NULL)
+        return NULL;
+
+    Cargo* cargo = tk_new_Cargo();
+    if (cargo == NULL)
+        return NULL;
+
+    while (ti->status == 0) {
+        if (ti->fillCargo(ti, cargo) != SUCCESS)
+            return NULL;
+    }
+    ti->destroy(ti);
+    return cargo;
+}
+
+int test_lexer() {
+    FILE* file = tmpfile();
+    if (file == NULL)
+        return FAILURE;
+    fprintf(file, "loop:  ldc 5, .x ; done\n  : br loop\nend :\n");
+
+    Cargo* cargo = tokenize_all(file, 1);
+    if ((cargo == NULL) || (cargo->size != 3))
+        return FAILURE;
+
+    /* Comment first, then the line in order with 1-based columns  */
+    AType types[] = {TYPE_TOK_COMMENT, TYPE_TOK_LABEL, TYPE_TOK_WORD, TYPE_TOK_NUMBER, TYPE_TOK_DIRECTIVE};
+    ASize cols[] = {18, 1, 8, 12, 15};
+    AString texts[] = {"; done ", "loop", "ldc", "5", ".x"};
+    Jar* jar = cargo->get(cargo, 0);
+    if (jar->size != 5)
+        return FAILURE;
+    int i;
+    for (i = 0; i<5; i++) {
+        Token* token = jar->get(jar, i);
+        if ((token->type != types[i]) || (token->cno != cols[i]) || (strcmp(token->token, texts[i]) != 0))
+            return FAILURE;
+    }
+
+    /* A lone `:` does not make the next word a label  */
+    jar = cargo->get(cargo, 1);
+    if ((jar->size != 2) || (jar->get(jar, 0)->type != TYPE_TOK_WORD) || (jar->get(jar, 0)->cno != 5))
+        return FAILURE;
+
+    /* A `:` after the first word does  */
+    jar = cargo->get(cargo, 2);
+    if ((jar->size != 1) || (jar->get(jar, 0)->type != TYPE_TOK_LABEL))
+        return FAILURE;
+
+    cargo->destroy(cargo, FALSE);
+    fclose(file);
+    return SUCCESS;
+}
+
+int test_long_lines() {
+    /* Lines far longer than any buffer used to be, streamed and mapped  */
+    ASize label_len = 3000;
+    ASize comment_len = 5000;
+    ASize size = label_len + comment_len + 64;
+    AString text = (AString)malloc(size);
+    if (text == NULL)
+        return FAILURE;
+
+    memset(text, 'L', label_len);
+    ASize n = label_len;
+    memcpy(text + n, ": add ;", 7);
+    n += 7;
+    memset(text + n, 'c', comment_len);
+    n += comment_len;
+    memcpy(text + n, "\n  ldc 5\n", 9);
+    n += 9;
+
+    FILE* mapped = tmpfile();
+    FILE* streamed = fmemopen(text, n, "r");
+    if ((mapped == NULL) || (streamed == NULL))
+        return FAILURE;
+    fwrite(text, 1, n, mapped);
+
+    FILE* files[2];
+    files[0] = mapped;
+    files[1] = streamed;
+    int k;
+    for (k = 0; k<2; k++) {
+        Cargo* cargo = tokenize_all(files[k], 1);
+        if ((cargo == NULL) || (cargo->size != 2))
+            return FAILURE;
+
+        Jar* jar = cargo->get(cargo, 0);
+        if ((jar->size != 3) || (jar->get(jar, 0)->length != comment_len + 2))     /* `;` and the newline  */
+            return FAILURE;
+        if ((jar->get(jar, 1)->type != TYPE_TOK_LABEL) || (jar->get(jar, 1)->length != label_len))
+            return FAILURE;
+
+        jar = cargo->get(cargo, 1);
+        if ((jar->lno != 2) || (jar->size != 2) || (strcmp(jar->get(jar, 0)->token, "ldc") != 0))
+            return FAILURE;
+        cargo->destroy(cargo, FALSE);
+        fclose(files[k]);
+    }
+
+    free(text);
+    return SUCCESS;
+}
+
+int test_parallel_jarify() {
+    FILE* file = tmpfile();
+    if (file == NULL)
+        return FAILURE;
+
+    ASize lines = 3*SZ_TOK_CARGO_PKT_WIN + 57;
+    ASize i;
+    for (i = 0; i<lines; i++) {
+        if (i%11 == 0)
+            fprintf(file, "l%lu: add %lu # note %lu\n", i, i, i);
+        else if (i%5 == 0)
+            fprintf(file, "    # only a comment\n");
+        else
+            fprintf(file, "\tldc %lu, r%lu\n", i, i%7);
+    }
+
+    Cargo* serial = tokenize_all(file, 1);
+    Cargo* parallel = tokenize_all(file, 8);
+    if ((serial == NULL) || (parallel == NULL))
+        return FAILURE;
+
+    if ((serial->size != lines) || (parallel->size != lines))
+        return FAILURE;
+
+    for (i = 0; i<lines; i++) {
+        Jar* a = serial->get(serial, i);
+        Jar* b = parallel->get(parallel, i);
+        if ((a == NULL) || (b == NULL))
+            return FAILURE;
+        if ((a->lno != b->lno) || (a->size != b->size) || (a->lno != i + 1))
+            return FAILURE;
+
+        ASize j;
+        for (j = 0; j<a->size; j++) {
+            Token* x = a->get(a, j);
+            Token* y = b->get(b, j);
+            if ((x == NULL) || (y == NULL))
+                return FAILURE;
+            if ((x->type != y->type) || (x->cno != y->cno) || (strcmp(x->token, y->token) != 0))
+                return FAILURE;
+        }
+    }
+
+    serial->destroy(serial, TRUE);
+    parallel->destroy(parallel, TRUE);
+    fclose(file);
+    return SUCCESS;
+}
+
+int test_cargo_crates() {
+    /* A packet is found by shift and mask, across the edges of the crates too  */
+    Cargo* cargo = tk_new_Cargo();
+    if (cargo == NULL)
+        return FAILURE;
+
+    ASize crate = (ASize)1 << SZ_TOK_CARGO_CRATE_SHIFT;
+    ASize n = 3*crate + 5;
+    char* marks = (char*)malloc(n);
+    if (marks == NULL)
+        return FAILURE;
+
+    ASize i;
+    for (i = 0; i<n; i++) {
+        if (cargo->load(cargo, i + 1, &marks[i]) != SUCCESS)
+            return FAILURE;
+    }
+
+    ASize probes[] = {0, 1, crate - 1, crate, crate + 1, 2*crate - 1, 2*crate, 3*crate, n - 1};
+    int k;
+    for (k = 0; k<9; k++) {
+        if (cargo->get(cargo, probes[k]) != &marks[probes[k]])
+            return FAILURE;
+    }
+    if ((cargo->get(cargo, n) != NULL) || (cargo->size != n))
+        return FAILURE;
+
+    cargo->destroy(cargo, FALSE);
+    free(marks);
+    return SUCCESS;
+}
+
 int main() {
+    assembly = ds_new_Assembly(SZ_DS_ASM_ARENA);
+    if (assembly == NULL)
+        return FAILURE;
     if (test_cargo() != SUCCESS)
         return FAILURE;
     printf("DEBUG: 1\n");
@@ -112,5 +362,18 @@ int main() {
     if (test_tokenizer_interface() != SUCCESS)
         return FAILURE;
     printf("DEBUG: 3\n");
+    if (test_line_scanner() != SUCCESS)
+        return FAILURE;
+    if (test_lexer() != SUCCESS)
+        return FAILURE;
+    if (test_long_lines() != SUCCESS)
+        return FAILURE;
+    if (test_parallel_jarify() != SUCCESS)
+        return FAILURE;
+    printf("DEBUG: 4\n");
+    if (test_cargo_crates() != SUCCESS)
+        return FAILURE;
+    printf("DEBUG: 5\n");
+    assembly->destroy(assembly);
     return SUCCESS;
 }